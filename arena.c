@@ -0,0 +1,212 @@
+/*
+ * arena.c
+ * -------
+ *
+ * This file contains the functions for the Arena abstract data
+ * type, a bump allocator. The Arena gets large blocks from malloc
+ * and hands out pieces of them by moving a pointer along the
+ * current block. When a block is full a new one is started and
+ * linked in front of the old one. Nothing is freed until the whole
+ * Arena is destroyed, which frees one block at a time instead of
+ * every allocation. Requests bigger than a block are given a
+ * block of their own so the rest of the current block is not lost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arena.h>
+
+#define ALIGNMENT 16 // Enough for any type including long double
+
+typedef struct Block{
+
+    struct Block* next;
+    size_t size;
+    size_t used;
+    // Memory handed out follows the Block header
+    // and starts aligned to ALIGNMENT bytes.
+
+} Block;
+
+
+typedef struct Arena{
+
+    Block* blocks; // Current block, followed by older blocks
+    size_t blockSize;
+    size_t bytesUsed;
+    size_t bytesReserved;
+
+} Arena;
+
+
+// Internal function declarations
+Block* blockConstructor(Arena* arena, size_t size);
+char* blockGetMemory(Block* block);
+
+
+/*
+ * Function: blockConstructor
+ * --------------------------
+ * Mallocs a Block with room for size bytes after its
+ * header and returns a pointer to it.
+ */
+Block* blockConstructor(Arena* arena, size_t size){
+
+    // Header size rounded up so the memory after it is aligned
+    size_t headerSize = (sizeof(Block) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+
+    Block* newBlock = malloc(headerSize + size);
+    if(newBlock == NULL){
+        printf("\n#####################################\n");
+        printf("Error, out of memory allocating %lu bytes.\n", (unsigned long)size);
+        printf("#####################################\n\n");
+        exit(-1);
+    }
+
+    newBlock->next = NULL;
+    newBlock->size = size;
+    newBlock->used = 0;
+    arena->bytesReserved += headerSize + size;
+    return newBlock;
+}
+
+
+/*
+ * Function: blockGetMemory
+ * ------------------------
+ * Returns the start of the memory that follows the header.
+ */
+char* blockGetMemory(Block* block){
+    return (char*)block + ((sizeof(Block) + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1));
+}
+
+
+/*
+ * Function: arenaConstructor
+ * --------------------------
+ * Constructs an empty Arena. No block is malloced
+ * until the first allocation.
+ */
+Arena* arenaConstructor(size_t blockSize){
+
+    Arena* newArena = malloc(sizeof(Arena));
+    newArena->blocks = NULL;
+    newArena->blockSize = blockSize;
+    newArena->bytesUsed = 0;
+    newArena->bytesReserved = 0;
+    return newArena;
+}
+
+
+/*
+ * Function: arenaDestructor
+ * -------------------------
+ * Walks the list of blocks freeing each one
+ * and then frees the Arena.
+ */
+void arenaDestructor(Arena* arena){
+
+    Block* block = arena->blocks;
+    Block* next;
+
+    while(block != NULL){
+        next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+
+/*
+ * Function: arenaAllocate
+ * -----------------------
+ * Rounds size up to the alignment and takes it from the
+ * current block. If it does not fit a new block is started,
+ * or for requests bigger than a block a dedicated block is
+ * linked in behind the current one so the current block
+ * can still be used.
+ */
+void* arenaAllocate(Arena* arena, size_t size){
+
+    size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+
+    Block* block = arena->blocks;
+
+    // Strings may have left the current block unaligned
+    if(block != NULL){
+        block->used = (block->used + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+        if(block->used > block->size){
+            block->used = block->size;
+        }
+    }
+
+    if(block == NULL || block->size - block->used < size){
+
+        if(size > arena->blockSize / 4 && block != NULL){
+            // Large request, give it a block of its own
+            Block* largeBlock = blockConstructor(arena, size);
+            largeBlock->next = block->next;
+            block->next = largeBlock;
+            largeBlock->used = size;
+            arena->bytesUsed += size;
+            return blockGetMemory(largeBlock);
+        }
+
+        block = blockConstructor(arena, size > arena->blockSize ? size : arena->blockSize);
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+
+    void* memory = blockGetMemory(block) + block->used;
+    block->used += size;
+    arena->bytesUsed += size;
+    return memory;
+}
+
+
+/*
+ * Function: arenaCopyString
+ * -------------------------
+ * Takes length + 1 bytes from the current block without
+ * any alignment and copies the string into them.
+ */
+char* arenaCopyString(Arena* arena, const char* string, int length){
+
+    Block* block = arena->blocks;
+
+    if(block == NULL || block->size - block->used < (size_t)length + 1){
+        block = blockConstructor(arena, (size_t)length + 1 > arena->blockSize ? (size_t)length + 1 : arena->blockSize);
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+
+    char* copy = blockGetMemory(block) + block->used;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+
+    block->used += length + 1;
+    arena->bytesUsed += length + 1;
+    return copy;
+}
+
+
+/*
+ * Function: arenaGetBytesUsed
+ * ---------------------------
+ * Returns the number of bytes handed out by the Arena.
+ */
+size_t arenaGetBytesUsed(Arena* arena){
+    return arena->bytesUsed;
+}
+
+
+/*
+ * Function: arenaGetBytesReserved
+ * -------------------------------
+ * Returns the number of bytes requested from malloc.
+ */
+size_t arenaGetBytesReserved(Arena* arena){
+    return arena->bytesReserved;
+}
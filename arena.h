@@ -0,0 +1,69 @@
+/*
+ * arena.h
+ * -------
+ *
+ * The header file for arena.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct Arena Arena;
+
+/*
+ * Function: arenaConstructor
+ * --------------------------
+ * Constructs an empty Arena that requests memory from
+ * malloc in blocks of blockSize bytes.
+ */
+Arena* arenaConstructor(size_t blockSize);
+
+
+/*
+ * Function: arenaDestructor
+ * -------------------------
+ * Frees every block of the Arena at once. Any pointer
+ * returned by the Arena is invalid afterwards.
+ */
+void arenaDestructor(Arena* arena);
+
+
+/*
+ * Function: arenaAllocate
+ * -----------------------
+ * Returns a pointer to size bytes aligned for any type.
+ * Memory is never freed individually.
+ */
+void* arenaAllocate(Arena* arena, size_t size);
+
+
+/*
+ * Function: arenaCopyString
+ * -------------------------
+ * Copies the first length characters of string into the
+ * Arena followed by a null-terminator and returns the copy.
+ * No alignment padding is added so successive strings are
+ * packed next to each other.
+ */
+char* arenaCopyString(Arena* arena, const char* string, int length);
+
+
+/*
+ * Function: arenaGetBytesUsed
+ * ---------------------------
+ * Returns the number of bytes handed out by the Arena.
+ */
+size_t arenaGetBytesUsed(Arena* arena);
+
+
+/*
+ * Function: arenaGetBytesReserved
+ * -------------------------------
+ * Returns the number of bytes requested from malloc.
+ */
+size_t arenaGetBytesReserved(Arena* arena);
+
+#endif
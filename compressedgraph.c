@@ -0,0 +1,462 @@
+/*
+ * compressedgraph.c
+ * -----------------
+ *
+ * This file contains the functions for the CompressedGraph abstract
+ * data type, the roads of a CsrGraph packed into as few bytes as
+ * they will go. A CsrGraph takes four bytes for the end vertex of
+ * every road and a whole Weight for its length, while most roads of
+ * a road network join vertices with nearby numbers, above all after
+ * renumbering, see vertexorder.c, and are a few hundred kilometres
+ * long at most.
+ *
+ * The roads of each vertex are sorted by end vertex number and
+ * written one after another into a single byte stream. The end of
+ * the first road is stored as its difference from the vertex's own
+ * number and each later one as its difference from the road before,
+ * so every gap after the first is never negative. Gaps and lengths
+ * are written as varints, seven bits to a byte with the top bit set
+ * on every byte but the last, so a number under 128 takes one byte
+ * and one under 16384 two. The first gap can be negative and is
+ * zigzag encoded first, 0, -1, 1, -2, ... becoming 0, 1, 2, 3, ...
+ * Lengths of a -DWEIGHT_FLOAT build are not whole numbers and are
+ * copied in as they are.
+ *
+ * The roads of vertex v start at blockStarts[v/COMPRESSED_BLOCK_SIZE]
+ * + offsets[v] in the stream, so the offsets are only four bytes
+ * however long the stream gets, and end where the roads of v + 1
+ * start. The roads are decoded again by the search every time a
+ * vertex is settled, which costs some time for every road relaxed
+ * in exchange for far fewer bytes read from memory.
+ *
+ * None of the arrays contain pointers, so a snapshot can hold them
+ * next to the CsrGraph and a CompressedGraph can be pointed at them
+ * in the mapping, see snapshot.c, without the CsrGraph's roads ever
+ * being read.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <compressedgraph.h>
+
+#define INITIAL_STREAM_CAPACITY 4096 // Bytes, doubling when full
+#define MAXIMUM_ROAD_BYTES 15 // Five for a gap and ten for a 64 bit length
+
+typedef struct CompressedGraph{
+
+    int numberOfCities;
+    int numberOfEdges;
+
+    // Roads of vertex i are from blockStarts[i/COMPRESSED_BLOCK_SIZE]
+    // + offsets[i] up to where the roads of vertex i + 1 start
+    const uint64_t* blockStarts;
+    const uint32_t* offsets;
+    const unsigned char* stream;
+    uint64_t streamSize;
+
+    // Whether the arrays were malloced by compressedGraphConstructor()
+    // rather than pointing into a snapshot
+    int ownsArrays;
+
+} CompressedGraph;
+
+
+typedef struct CompressedEdge{
+
+    int target;
+    Weight distance;
+
+} CompressedEdge;
+
+
+// Internal function declarations
+int compareCompressedEdges(const void* a, const void* b);
+unsigned char* varintWrite(unsigned char* position, uint64_t value);
+const unsigned char* varintRead(const unsigned char* position, uint64_t* value);
+
+
+/*
+ * Function: compareCompressedEdges
+ * --------------------------------
+ * Orders CompressedEdges by end vertex number, and the
+ * shorter first of two roads to the same vertex.
+ */
+int compareCompressedEdges(const void* a, const void* b){
+
+    const CompressedEdge* edgeA = a;
+    const CompressedEdge* edgeB = b;
+
+    if(edgeA->target != edgeB->target){
+        return edgeA->target < edgeB->target ? -1 : 1;
+    }
+    return edgeA->distance < edgeB->distance ? -1 : edgeA->distance > edgeB->distance;
+}
+
+
+/*
+ * Function: varintWrite
+ * ---------------------
+ * Writes value seven bits at a time, lowest first, and
+ * returns the position after the last byte.
+ */
+unsigned char* varintWrite(unsigned char* position, uint64_t value){
+
+    while(value >= 0x80){
+        *position = (unsigned char)(value | 0x80);
+        position++;
+        value >>= 7;
+    }
+    *position = (unsigned char)value;
+    return position + 1;
+}
+
+
+/*
+ * Function: varintRead
+ * --------------------
+ * Reads a value written by varintWrite() and returns the
+ * position after it. Most values are one byte, so that
+ * case returns straight away.
+ */
+const unsigned char* varintRead(const unsigned char* position, uint64_t* value){
+
+    uint64_t result = *position;
+    int shift = 7;
+
+    position++;
+    if(result < 0x80){
+        *value = result;
+        return position;
+    }
+
+    result &= 0x7f;
+    while(*position >= 0x80){
+        result |= (uint64_t)(*position & 0x7f) << shift;
+        shift += 7;
+        position++;
+    }
+    result |= (uint64_t)*position << shift;
+
+    *value = result;
+    return position + 1;
+}
+
+
+/*
+ * Function: compressedGraphConstructor
+ * ------------------------------------
+ * Copies the roads of each vertex into a scratch array,
+ * sorts them and appends them to the stream, doubling it
+ * when the next road might not fit. A new block starts
+ * every COMPRESSED_BLOCK_SIZE vertices. The stream is
+ * trimmed to its final size at the end.
+ */
+CompressedGraph* compressedGraphConstructor(CsrGraph* csrGraph){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    const int* csrOffsets = csrGraphGetOffsets(csrGraph);
+    const int* csrTargets = csrGraphGetTargets(csrGraph);
+    const Weight* csrDistances = csrGraphGetDistances(csrGraph);
+
+    uint64_t* blockStarts = malloc((numberOfCities/COMPRESSED_BLOCK_SIZE + 1)*sizeof(uint64_t));
+    uint32_t* offsets = malloc((numberOfCities + 1)*sizeof(uint32_t));
+    size_t capacity = INITIAL_STREAM_CAPACITY;
+    unsigned char* stream = malloc(capacity);
+    size_t size = 0;
+
+    int mostRoads = 0;
+    int i;
+    int j;
+    for(i = 0; i < numberOfCities; i++){
+        if(csrOffsets[i + 1] - csrOffsets[i] > mostRoads){
+            mostRoads = csrOffsets[i + 1] - csrOffsets[i];
+        }
+    }
+    CompressedEdge* edges = malloc((mostRoads > 0 ? mostRoads : 1)*sizeof(CompressedEdge));
+
+    int numberOfRoads;
+    int previousTarget;
+    int gap;
+    unsigned char* position;
+
+    for(i = 0; i <= numberOfCities; i++){
+
+        if(i % COMPRESSED_BLOCK_SIZE == 0){
+            blockStarts[i/COMPRESSED_BLOCK_SIZE] = size;
+        }
+        if(size - blockStarts[i/COMPRESSED_BLOCK_SIZE] > UINT32_MAX){
+            printf("\n#####################################\n");
+            printf("Error, the roads of cities %d to %d take\n", i/COMPRESSED_BLOCK_SIZE*COMPRESSED_BLOCK_SIZE, i);
+            printf("more than 4 GB once compressed.\n");
+            printf("#####################################\n\n");
+            exit(-1);
+        }
+        offsets[i] = size - blockStarts[i/COMPRESSED_BLOCK_SIZE];
+
+        if(i == numberOfCities){
+            break;
+        }
+
+        numberOfRoads = csrOffsets[i + 1] - csrOffsets[i];
+        for(j = 0; j < numberOfRoads; j++){
+            edges[j].target = csrTargets[csrOffsets[i] + j];
+            edges[j].distance = csrDistances[csrOffsets[i] + j];
+        }
+        qsort(edges, numberOfRoads, sizeof(CompressedEdge), compareCompressedEdges);
+
+        while(size + (size_t)numberOfRoads*MAXIMUM_ROAD_BYTES > capacity){
+            capacity *= 2;
+            stream = realloc(stream, capacity);
+        }
+
+        position = stream + size;
+        previousTarget = i;
+        for(j = 0; j < numberOfRoads; j++){
+            gap = edges[j].target - previousTarget;
+            if(j == 0){
+                position = varintWrite(position, ((uint32_t)gap << 1) ^ (uint32_t)(gap >> 31));
+            } else {
+                position = varintWrite(position, (uint32_t)gap);
+            }
+#if WEIGHT_IS_WHOLE
+            position = varintWrite(position, (uint64_t)edges[j].distance);
+#else
+            memcpy(position, &edges[j].distance, sizeof(Weight));
+            position += sizeof(Weight);
+#endif
+            previousTarget = edges[j].target;
+        }
+        size = position - stream;
+    }
+
+    free(edges);
+
+    CompressedGraph* newCompressedGraph = compressedGraphConstructorFromArrays(numberOfCities,
+                                                                               csrGraphGetNumberOfEdges(csrGraph),
+                                                                               blockStarts, offsets,
+                                                                               realloc(stream, size > 0 ? size : 1),
+                                                                               size);
+    newCompressedGraph->ownsArrays = 1;
+    return newCompressedGraph;
+}
+
+
+/*
+ * Function: compressedGraphConstructorFromArrays
+ * ----------------------------------------------
+ * Builds a CompressedGraph around existing arrays
+ * without copying them.
+ */
+CompressedGraph* compressedGraphConstructorFromArrays(int numberOfCities, int numberOfEdges,
+                                                      const uint64_t* blockStarts, const uint32_t* offsets,
+                                                      const unsigned char* stream, uint64_t streamSize){
+
+    CompressedGraph* newCompressedGraph = malloc(sizeof(CompressedGraph));
+
+    newCompressedGraph->numberOfCities = numberOfCities;
+    newCompressedGraph->numberOfEdges = numberOfEdges;
+    newCompressedGraph->blockStarts = blockStarts;
+    newCompressedGraph->offsets = offsets;
+    newCompressedGraph->stream = stream;
+    newCompressedGraph->streamSize = streamSize;
+    newCompressedGraph->ownsArrays = 0;
+
+    return newCompressedGraph;
+}
+
+
+/*
+ * Function: compressedGraphDestructor
+ * -----------------------------------
+ * Frees the arrays if they were malloced, then the
+ * CompressedGraph.
+ */
+void compressedGraphDestructor(CompressedGraph* compressedGraph){
+
+    if(compressedGraph->ownsArrays){
+        free((uint64_t*)compressedGraph->blockStarts);
+        free((uint32_t*)compressedGraph->offsets);
+        free((unsigned char*)compressedGraph->stream);
+    }
+    free(compressedGraph);
+}
+
+
+/*
+ * Function: compressedGraphGetNumberOfCities
+ * ------------------------------------------
+ * Returns the number of vertices.
+ */
+int compressedGraphGetNumberOfCities(CompressedGraph* compressedGraph){
+    return compressedGraph->numberOfCities;
+}
+
+
+/*
+ * Function: compressedGraphGetNumberOfEdges
+ * -----------------------------------------
+ * Returns the number of directed edges.
+ */
+int compressedGraphGetNumberOfEdges(CompressedGraph* compressedGraph){
+    return compressedGraph->numberOfEdges;
+}
+
+
+/*
+ * Function: compressedGraphGetBlockStarts
+ * ---------------------------------------
+ * Returns the position of the first road of every block.
+ */
+const uint64_t* compressedGraphGetBlockStarts(CompressedGraph* compressedGraph){
+    return compressedGraph->blockStarts;
+}
+
+
+/*
+ * Function: compressedGraphGetOffsets
+ * -----------------------------------
+ * Returns the offsets of each vertex's roads in its block.
+ */
+const uint32_t* compressedGraphGetOffsets(CompressedGraph* compressedGraph){
+    return compressedGraph->offsets;
+}
+
+
+/*
+ * Function: compressedGraphGetStream
+ * ----------------------------------
+ * Returns the encoded roads.
+ */
+const unsigned char* compressedGraphGetStream(CompressedGraph* compressedGraph){
+    return compressedGraph->stream;
+}
+
+
+/*
+ * Function: compressedGraphGetStreamSize
+ * --------------------------------------
+ * Returns the length of the stream in bytes.
+ */
+uint64_t compressedGraphGetStreamSize(CompressedGraph* compressedGraph){
+    return compressedGraph->streamSize;
+}
+
+
+/*
+ * Function: compressedGraphGetBytes
+ * ---------------------------------
+ * Adds up the stream, offsets and block starts.
+ */
+size_t compressedGraphGetBytes(CompressedGraph* compressedGraph){
+
+    return compressedGraph->streamSize
+           + (size_t)(compressedGraph->numberOfCities + 1)*sizeof(uint32_t)
+           + (size_t)(compressedGraph->numberOfCities/COMPRESSED_BLOCK_SIZE + 1)*sizeof(uint64_t);
+}
+
+
+/*
+ * Function: compressedGraphFindRoute
+ * ----------------------------------
+ * The search of dijkstrasCsrToTarget(), stopping at the
+ * target and only putting vertices on the minHeap when a
+ * road first reaches them, but each road is decoded from
+ * the stream and relaxed straight away. The SIMD kernels
+ * of relaxkernel.c need the ends and lengths in arrays so
+ * are not used. Roads are in a different order from the
+ * CsrGraph's, so where two routes are equally short a
+ * different one of them may be found.
+ */
+Distance compressedGraphFindRoute(CompressedGraph* compressedGraph, DijkstraWorkspace* workspace,
+                                  int source, int target){
+
+    const uint64_t* blockStarts = compressedGraph->blockStarts;
+    const uint32_t* offsets = compressedGraph->offsets;
+    const unsigned char* stream = compressedGraph->stream;
+    Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    int* previous = dijkstraWorkspaceGetPrevious(workspace);
+    char* visited = dijkstraWorkspaceGetVisited(workspace);
+    MinHeap* minHeap = dijkstraWorkspaceGetMinHeap(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
+
+    int numberOfSettled = 0;
+
+    stamps[source] = query;
+    distanceFromSource[source] = 0;
+    previous[source] = -1;
+    visited[source] = 0;
+    minHeapEnqueue(minHeap, source, 0);
+
+    while(!minHeapIsEmpty(minHeap)){
+
+        int u;
+        int v;
+        uint64_t gap;
+        Weight length;
+        Distance alternateRoute;
+
+        u = minHeapDequeue(minHeap);
+        visited[u] = 1;
+        numberOfSettled++;
+
+        if(u == target){
+            break;
+        }
+
+        const unsigned char* position = stream + blockStarts[u/COMPRESSED_BLOCK_SIZE] + offsets[u];
+        const unsigned char* end = stream + blockStarts[(u + 1)/COMPRESSED_BLOCK_SIZE] + offsets[u + 1];
+
+        v = u;
+        if(position < end){
+            // The first gap is zigzag encoded
+            position = varintRead(position, &gap);
+            v += (int)(((uint32_t)gap >> 1) ^ -((uint32_t)gap & 1));
+        }
+
+        while(position < end){
+
+#if WEIGHT_IS_WHOLE
+            uint64_t value;
+            position = varintRead(position, &value);
+            length = (Weight)value;
+#else
+            memcpy(&length, position, sizeof(Weight));
+            position += sizeof(Weight);
+#endif
+
+            if(stamps[v] != query){
+                stamps[v] = query;
+                distanceFromSource[v] = DISTANCE_INFINITY;
+                previous[v] = -1;
+                visited[v] = 0;
+            }
+
+            alternateRoute = DISTANCE_ADD(distanceFromSource[u], length);
+
+            if(!visited[v] && alternateRoute < distanceFromSource[v]){
+
+                // First time v is reached it goes on the minHeap
+                if(distanceFromSource[v] == DISTANCE_INFINITY){
+                    minHeapEnqueue(minHeap, v, alternateRoute);
+                } else {
+                    minHeapDecreaseNodeValue(minHeap, v, alternateRoute);
+                }
+                distanceFromSource[v] = alternateRoute;
+                previous[v] = u;
+            }
+
+            // End of the next road, if there is one
+            if(position < end){
+                position = varintRead(position, &gap);
+                v += (int)gap;
+            }
+        }
+    }
+
+    minHeapClear(minHeap);
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+    return stamps[target] == query ? distanceFromSource[target] : DISTANCE_INFINITY;
+}
@@ -0,0 +1,133 @@
+/*
+ * compressedgraph.h
+ * -----------------
+ *
+ * The header file for compressedgraph.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <csrgraph.h>
+#include <dijkstraworkspace.h>
+
+#define COMPRESSED_BLOCK_SIZE 256 // Vertices sharing a blockStarts entry
+
+typedef struct CompressedGraph CompressedGraph;
+
+/*
+ * Function: compressedGraphConstructor
+ * ------------------------------------
+ * Encodes the roads of the CsrGraph, each vertex's sorted
+ * by end vertex number, into a stream of variable length
+ * bytes and returns a pointer to the CompressedGraph. The
+ * vertex numbers are the CsrGraph's, so its names are still
+ * used to look up and print cities, but its roads are not
+ * read again.
+ */
+CompressedGraph* compressedGraphConstructor(CsrGraph* csrGraph);
+
+
+/*
+ * Function: compressedGraphConstructorFromArrays
+ * ----------------------------------------------
+ * Returns a CompressedGraph over arrays encoded by
+ * compressedGraphConstructor() and kept elsewhere, such
+ * as in a snapshot, which must outlive it. The arrays are
+ * not freed by compressedGraphDestructor().
+ */
+CompressedGraph* compressedGraphConstructorFromArrays(int numberOfCities, int numberOfEdges,
+                                                      const uint64_t* blockStarts, const uint32_t* offsets,
+                                                      const unsigned char* stream, uint64_t streamSize);
+
+
+/*
+ * Function: compressedGraphDestructor
+ * -----------------------------------
+ * Frees the CompressedGraph, and its arrays if they were
+ * made by compressedGraphConstructor().
+ */
+void compressedGraphDestructor(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetNumberOfCities
+ * ------------------------------------------
+ * Returns the number of vertices.
+ */
+int compressedGraphGetNumberOfCities(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetNumberOfEdges
+ * -----------------------------------------
+ * Returns the number of directed edges, as for the
+ * CsrGraph it was made from.
+ */
+int compressedGraphGetNumberOfEdges(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetBlockStarts
+ * ---------------------------------------
+ * Returns the array of where in the stream the roads of
+ * each block of COMPRESSED_BLOCK_SIZE vertices start,
+ * numberOfCities/COMPRESSED_BLOCK_SIZE + 1 entries.
+ */
+const uint64_t* compressedGraphGetBlockStarts(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetOffsets
+ * -----------------------------------
+ * Returns the array of where the roads of each vertex
+ * start from the start of its block, numberOfCities + 1
+ * entries.
+ */
+const uint32_t* compressedGraphGetOffsets(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetStream
+ * ----------------------------------
+ * Returns the stream of encoded roads.
+ */
+const unsigned char* compressedGraphGetStream(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetStreamSize
+ * --------------------------------------
+ * Returns the number of bytes in the stream.
+ */
+uint64_t compressedGraphGetStreamSize(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphGetBytes
+ * ---------------------------------
+ * Returns the size of the encoded roads and the offsets
+ * into them, the memory the CompressedGraph takes in place
+ * of the CsrGraph's offsets, targets and distances.
+ */
+size_t compressedGraphGetBytes(CompressedGraph* compressedGraph);
+
+
+/*
+ * Function: compressedGraphFindRoute
+ * ----------------------------------
+ * Finds the shortest route from source to target as
+ * dijkstrasCsrToTarget() does, decoding the roads of each
+ * vertex as it is settled. Returns the distance, or
+ * DISTANCE_INFINITY if the target can not be reached.
+ * Afterwards the workspace holds the route for
+ * dijkstrasCsrWriteToFile() and the number of vertices
+ * settled.
+ */
+Distance compressedGraphFindRoute(CompressedGraph* compressedGraph, DijkstraWorkspace* workspace,
+                                  int source, int target);
+
+#endif
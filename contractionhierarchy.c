@@ -0,0 +1,1190 @@
+/*
+ * contractionhierarchy.c
+ * ----------------------
+ *
+ * This file contains the functions for the ContractionHierarchy
+ * abstract data type. Every vertex of the graph is contracted in
+ * turn, least important first. Contracting a vertex v removes it
+ * from the graph, and for each pair of its neighbours u and w whose
+ * only shortest route is u -> v -> w a shortcut road u -> w is added
+ * in its place, recording v as the middle vertex it bypasses. Whether
+ * another route is as short, a witness, is found by a small Dijkstra
+ * search from u that leaves out v and stops once every w is settled.
+ * It gives up after WITNESS_SETTLE_LIMIT vertices, which can only add
+ * a shortcut that was not needed, never miss one.
+ *
+ * How important a vertex is, its priority, is its edge difference,
+ * the number of shortcuts contracting it would add less the number
+ * of roads it would remove, plus the number of its neighbours already
+ * contracted and its level, one more than the highest level of any
+ * contracted neighbour, so contraction spreads evenly over the graph
+ * and the hierarchy stays shallow. As it is only an estimate its
+ * witness searches stop at the smaller PRIORITY_SETTLE_LIMIT.
+ *
+ * Contraction goes in rounds. Each round every remaining vertex whose
+ * priority is lower than that of all its remaining neighbours is
+ * contracted at once. No two of them are neighbours, so they are
+ * independent and their witness searches are shared out between
+ * threads. The searches of a round leave out all of its vertices and
+ * only read the graph, the shortcuts they find are then added on the
+ * main thread in vertex order, so the result does not depend on the
+ * number of threads. Only the priorities of neighbours of contracted
+ * vertices change and these are found again, also in parallel.
+ *
+ * The position of a vertex in the contraction order is its rank. What
+ * is kept is, for each vertex, the roads and shortcuts to neighbours
+ * of higher rank that it had when it was contracted. Any shortest
+ * route can be made from a part going only up in rank followed by a
+ * part going only down, so a query searches upwards from both the
+ * source and the target, each a normal Dijkstra over the upward edges,
+ * and the route is found where they meet. Every road goes both ways
+ * so one set of upward edges serves both searches.
+ *
+ * The hierarchy can be written to a file and mapped back in later,
+ * like a snapshot. The file starts with a HierarchyHeader followed
+ * by each section, every one starting on an 8 byte boundary:
+ *
+ *     ranks        numberOfCities ints
+ *     offsets      (numberOfCities + 1) ints
+ *     targets      numberOfUpwardEdges ints
+ *     distances    numberOfUpwardEdges Distances
+ *     middles      numberOfUpwardEdges ints
+ *
+ * The header records the fingerprint of the graph, see csrgraph.c,
+ * as a hierarchy is only right for the numbering it was built with.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <contractionhierarchy.h>
+#include <mappedfile.h>
+#include <minheap.h>
+#include <threadrunner.h>
+
+#define HIERARCHY_MAGIC "DJKHIER" // 7 characters and the null-terminator
+#define BYTE_ORDER_MARK 0x01020304u
+#define SECTION_ALIGNMENT 8
+#define WITNESS_SETTLE_LIMIT 500 // Vertices a witness search settles before giving up
+#define PRIORITY_SETTLE_LIMIT 50 // The same when only counting shortcuts for a priority
+#define INITIAL_EDGE_CAPACITY 4
+#define INITIAL_SHORTCUT_CAPACITY 256
+#define INITIAL_STACK_CAPACITY 64
+
+enum HierarchySection{
+    HIERARCHY_RANKS,
+    HIERARCHY_OFFSETS,
+    HIERARCHY_TARGETS,
+    HIERARCHY_DISTANCES,
+    HIERARCHY_MIDDLES,
+    NUMBER_OF_HIERARCHY_SECTIONS
+};
+
+enum VertexState{
+    VERTEX_REMAINING,
+    VERTEX_CONTRACTING, // Being contracted in the current round
+    VERTEX_CONTRACTED
+};
+
+typedef struct ContractionHierarchy{
+
+    int numberOfCities;
+    int numberOfUpwardEdges;
+    int numberOfShortcuts;
+
+    const int* ranks;
+
+    // Upward edges of vertex i are at offsets[i] to offsets[i + 1] - 1
+    // in the targets, distances and middles arrays. A middle of -1
+    // means the edge is a road rather than a shortcut.
+    const int* offsets;
+    const int* targets;
+    const Distance* distances; // Shortcuts can be longer than any road
+    const int* middles;
+
+    // File the arrays are mapped from, or NULL if they
+    // were malloced by contractionHierarchyConstructor()
+    MappedFile* mappedFile;
+
+} ContractionHierarchy;
+
+
+typedef struct HierarchyHeader{
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark; // Reads back differently on the other byte order
+    uint32_t intSize;
+    uint32_t weightType; // WEIGHT_TYPE of the program that wrote it
+    uint32_t numberOfCities;
+    uint32_t numberOfEdges; // Of the graph the hierarchy was made for
+    uint32_t numberOfUpwardEdges;
+    uint32_t numberOfShortcuts;
+    uint64_t fileSize;
+    uint64_t graphFingerprint; // See csrGraphGetFingerprint()
+
+    // Byte position and length of each section from the start of the file
+    uint64_t sectionStart[NUMBER_OF_HIERARCHY_SECTIONS];
+    uint64_t sectionSize[NUMBER_OF_HIERARCHY_SECTIONS];
+
+} HierarchyHeader;
+
+
+typedef struct HierarchyEdge{
+
+    int target;
+    Distance distance;
+    int middle;
+
+} HierarchyEdge;
+
+
+// A vertex of the graph being contracted, with an edge
+// to each remaining neighbour. Once it is contracted
+// its edges are left as they were, its upward edges.
+typedef struct HierarchyVertex{
+
+    HierarchyEdge* edges;
+    int numberOfEdges;
+    int edgeCapacity;
+
+} HierarchyVertex;
+
+
+typedef struct Shortcut{
+
+    int from;
+    int to;
+    Distance distance;
+    int middle;
+
+} Shortcut;
+
+
+typedef struct ContractionThread{
+
+    // Witness search distances, DISTANCE_INFINITY for
+    // every vertex not in the touched list
+    Distance* distance;
+    int* touched;
+    int numberOfTouched;
+    MinHeap* minHeap;
+
+    // Set for the neighbours a witness search is looking for
+    char* isTarget;
+
+    // Shortcuts found by this thread in the current round
+    Shortcut* shortcuts;
+    int numberOfShortcuts;
+    int shortcutCapacity;
+
+} ContractionThread;
+
+
+typedef struct ContractionContext{
+
+    int numberOfCities;
+    HierarchyVertex* vertices;
+    char* states;
+    int* priorities;
+    int* contractedNeighbours;
+    int* levels;
+
+    // Vertices the current pass works on, shared out in order
+    const int* work;
+    int numberOfWork;
+
+    ContractionThread* threads;
+    int numberOfThreads;
+
+} ContractionContext;
+
+
+typedef struct ContractionTask{
+
+    ContractionContext* context;
+    int threadNumber;
+
+} ContractionTask;
+
+
+// Internal function declarations
+void hierarchyAddEdge(HierarchyVertex* vertex, int target, Distance distance, int middle);
+void hierarchyRemoveEdge(HierarchyVertex* vertex, int target);
+void witnessSearch(ContractionContext* context, ContractionThread* thread, int source, int excluded,
+                   Distance limit, int numberOfTargets, int settleLimit);
+int findShortcuts(ContractionContext* context, ContractionThread* thread, int vertexNumber, int record);
+void runContractionPass(ContractionContext* context, void* (*function)(void*));
+void* priorityPass(void* argument);
+void* contractPass(void* argument);
+int isLocalMinimum(ContractionContext* context, int vertexNumber);
+int findHierarchyEdge(ContractionHierarchy* hierarchy, int a, int b);
+uint64_t hierarchyAlign(uint64_t position);
+void hierarchyError(const char* path, const char* reason);
+
+
+/*
+ * Function: hierarchyAddEdge
+ * --------------------------
+ * Adds an edge to a vertex, or if it already has an
+ * edge to the same target keeps whichever is shorter.
+ */
+void hierarchyAddEdge(HierarchyVertex* vertex, int target, Distance distance, int middle){
+
+    int i;
+    for(i = 0; i < vertex->numberOfEdges; i++){
+        if(vertex->edges[i].target == target){
+            if(distance < vertex->edges[i].distance){
+                vertex->edges[i].distance = distance;
+                vertex->edges[i].middle = middle;
+            }
+            return;
+        }
+    }
+
+    if(vertex->numberOfEdges == vertex->edgeCapacity){
+        vertex->edgeCapacity = vertex->edgeCapacity > 0 ? vertex->edgeCapacity*2 : INITIAL_EDGE_CAPACITY;
+        vertex->edges = realloc(vertex->edges, vertex->edgeCapacity*sizeof(HierarchyEdge));
+    }
+
+    vertex->edges[vertex->numberOfEdges].target = target;
+    vertex->edges[vertex->numberOfEdges].distance = distance;
+    vertex->edges[vertex->numberOfEdges].middle = middle;
+    vertex->numberOfEdges++;
+}
+
+
+/*
+ * Function: hierarchyRemoveEdge
+ * -----------------------------
+ * Removes the edge to a target by moving the last
+ * edge into its place.
+ */
+void hierarchyRemoveEdge(HierarchyVertex* vertex, int target){
+
+    int i;
+    for(i = 0; i < vertex->numberOfEdges; i++){
+        if(vertex->edges[i].target == target){
+            vertex->numberOfEdges--;
+            vertex->edges[i] = vertex->edges[vertex->numberOfEdges];
+            return;
+        }
+    }
+}
+
+
+/*
+ * Function: witnessSearch
+ * -----------------------
+ * Runs Dijkstra's from source over the remaining graph,
+ * leaving out the excluded vertex and any vertex being
+ * contracted this round. Stops once all numberOfTargets
+ * vertices marked in isTarget are settled, the next
+ * distance is over limit or settleLimit vertices are
+ * settled. Only the vertices touched by the last search
+ * are reset, as most searches touch very few.
+ */
+void witnessSearch(ContractionContext* context, ContractionThread* thread, int source, int excluded,
+                   Distance limit, int numberOfTargets, int settleLimit){
+
+    Distance* distance = thread->distance;
+    int numberOfSettled = 0;
+
+    int i;
+    for(i = 0; i < thread->numberOfTouched; i++){
+        distance[thread->touched[i]] = DISTANCE_INFINITY;
+    }
+    thread->numberOfTouched = 0;
+
+    distance[source] = 0;
+    thread->touched[thread->numberOfTouched++] = source;
+    minHeapEnqueue(thread->minHeap, source, 0);
+
+    while(!minHeapIsEmpty(thread->minHeap)){
+
+        HierarchyVertex* u;
+        HierarchyEdge* edge;
+        int uNumber;
+        Distance alternateRoute;
+
+        if(numberOfTargets == 0 || minHeapPeekValue(thread->minHeap) > limit || numberOfSettled == settleLimit){
+            break;
+        }
+
+        uNumber = minHeapDequeue(thread->minHeap);
+        u = &context->vertices[uNumber];
+        numberOfSettled++;
+        numberOfTargets -= thread->isTarget[uNumber];
+
+        int j;
+        for(j = 0; j < u->numberOfEdges; j++){
+
+            edge = &u->edges[j];
+
+            if(edge->target == excluded || context->states[edge->target] == VERTEX_CONTRACTING){
+                continue;
+            }
+
+            alternateRoute = DISTANCE_ADD(distance[uNumber], edge->distance);
+
+            if(alternateRoute < distance[edge->target]){
+                if(distance[edge->target] == DISTANCE_INFINITY){
+                    thread->touched[thread->numberOfTouched++] = edge->target;
+                    minHeapEnqueue(thread->minHeap, edge->target, alternateRoute);
+                } else {
+                    minHeapDecreaseNodeValue(thread->minHeap, edge->target, alternateRoute);
+                }
+                distance[edge->target] = alternateRoute;
+            }
+        }
+    }
+
+    minHeapClear(thread->minHeap);
+}
+
+
+/*
+ * Function: findShortcuts
+ * -----------------------
+ * Works out which shortcuts contracting a vertex would
+ * need, running one witness search from each neighbour
+ * to the neighbours after it in the edge list, so each
+ * pair is only checked once. Returns how many there are
+ * and if record is set adds them to the thread's list.
+ */
+int findShortcuts(ContractionContext* context, ContractionThread* thread, int vertexNumber, int record){
+
+    HierarchyVertex* vertex = &context->vertices[vertexNumber];
+    int numberOfShortcuts = 0;
+    Distance longest;
+    Distance through;
+
+    int i;
+    int j;
+    for(i = 0; i < vertex->numberOfEdges - 1; i++){
+
+        longest = 0;
+        for(j = i + 1; j < vertex->numberOfEdges; j++){
+            thread->isTarget[vertex->edges[j].target] = 1;
+            if(vertex->edges[j].distance > longest){
+                longest = vertex->edges[j].distance;
+            }
+        }
+
+        witnessSearch(context, thread, vertex->edges[i].target, vertexNumber, DISTANCE_ADD(vertex->edges[i].distance, longest),
+                      vertex->numberOfEdges - i - 1, record ? WITNESS_SETTLE_LIMIT : PRIORITY_SETTLE_LIMIT);
+
+        for(j = i + 1; j < vertex->numberOfEdges; j++){
+
+            thread->isTarget[vertex->edges[j].target] = 0;
+
+            through = DISTANCE_ADD(vertex->edges[i].distance, vertex->edges[j].distance);
+            if(thread->distance[vertex->edges[j].target] <= through){
+                continue;
+            }
+
+            numberOfShortcuts++;
+
+            if(record){
+                if(thread->numberOfShortcuts == thread->shortcutCapacity){
+                    thread->shortcutCapacity *= 2;
+                    thread->shortcuts = realloc(thread->shortcuts, thread->shortcutCapacity*sizeof(Shortcut));
+                }
+                thread->shortcuts[thread->numberOfShortcuts].from = vertex->edges[i].target;
+                thread->shortcuts[thread->numberOfShortcuts].to = vertex->edges[j].target;
+                thread->shortcuts[thread->numberOfShortcuts].distance = through;
+                thread->shortcuts[thread->numberOfShortcuts].middle = vertexNumber;
+                thread->numberOfShortcuts++;
+            }
+        }
+    }
+
+    return numberOfShortcuts;
+}
+
+
+/*
+ * Function: runContractionPass
+ * ----------------------------
+ * Runs a pass over the work list on every thread and
+ * waits for them all. Exits with an error if a thread
+ * can not be started.
+ */
+void runContractionPass(ContractionContext* context, void* (*function)(void*)){
+
+    ContractionTask* tasks = malloc(context->numberOfThreads*sizeof(ContractionTask));
+
+    int i;
+    for(i = 0; i < context->numberOfThreads; i++){
+        tasks[i].context = context;
+        tasks[i].threadNumber = i;
+    }
+    threadRunnerRun(context->numberOfThreads, function, tasks, sizeof(ContractionTask));
+
+    free(tasks);
+}
+
+
+/*
+ * Function: priorityPass
+ * ----------------------
+ * Finds the priority of this thread's share of the work
+ * list by counting the shortcuts each would need.
+ */
+void* priorityPass(void* argument){
+
+    ContractionTask* task = argument;
+    ContractionContext* context = task->context;
+    ContractionThread* thread = &context->threads[task->threadNumber];
+
+    int first = (long)context->numberOfWork*task->threadNumber/context->numberOfThreads;
+    int last = (long)context->numberOfWork*(task->threadNumber + 1)/context->numberOfThreads;
+    int vertexNumber;
+
+    int i;
+    for(i = first; i < last; i++){
+        vertexNumber = context->work[i];
+        context->priorities[vertexNumber] = findShortcuts(context, thread, vertexNumber, 0)
+                                            - context->vertices[vertexNumber].numberOfEdges
+                                            + context->contractedNeighbours[vertexNumber]
+                                            + context->levels[vertexNumber];
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function: contractPass
+ * ----------------------
+ * Records the shortcuts needed by this thread's share
+ * of the vertices contracted this round.
+ */
+void* contractPass(void* argument){
+
+    ContractionTask* task = argument;
+    ContractionContext* context = task->context;
+    ContractionThread* thread = &context->threads[task->threadNumber];
+
+    int first = (long)context->numberOfWork*task->threadNumber/context->numberOfThreads;
+    int last = (long)context->numberOfWork*(task->threadNumber + 1)/context->numberOfThreads;
+
+    thread->numberOfShortcuts = 0;
+
+    int i;
+    for(i = first; i < last; i++){
+        findShortcuts(context, thread, context->work[i], 1);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function: isLocalMinimum
+ * ------------------------
+ * Returns 1 if a vertex has a lower priority than every
+ * remaining neighbour, ties going to the lower vertex
+ * number, otherwise 0.
+ */
+int isLocalMinimum(ContractionContext* context, int vertexNumber){
+
+    HierarchyVertex* vertex = &context->vertices[vertexNumber];
+    int priority = context->priorities[vertexNumber];
+    int neighbour;
+
+    int i;
+    for(i = 0; i < vertex->numberOfEdges; i++){
+        neighbour = vertex->edges[i].target;
+        if(context->priorities[neighbour] < priority
+           || (context->priorities[neighbour] == priority && neighbour < vertexNumber)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*
+ * Function: contractionHierarchyConstructor
+ * -----------------------------------------
+ * Copies the CsrGraph into growable edge lists, keeping
+ * the shortest of any repeated roads, and finds every
+ * priority. Then each round picks the independent set
+ * of local minima, finds their shortcuts in parallel,
+ * contracts them and finds the priorities of their
+ * neighbours again, until no vertex remains. Finally
+ * the upward edges are packed into flat arrays.
+ */
+ContractionHierarchy* contractionHierarchyConstructor(CsrGraph* csrGraph, int numberOfThreads){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    const int* csrOffsets = csrGraphGetOffsets(csrGraph);
+    const int* csrTargets = csrGraphGetTargets(csrGraph);
+    const Weight* csrDistances = csrGraphGetDistances(csrGraph);
+
+    if(numberOfThreads < 1){
+        numberOfThreads = 1;
+    }
+
+    ContractionContext context;
+    context.numberOfCities = numberOfCities;
+    context.vertices = calloc(numberOfCities > 0 ? numberOfCities : 1, sizeof(HierarchyVertex));
+    context.states = calloc(numberOfCities > 0 ? numberOfCities : 1, sizeof(char));
+    context.priorities = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    context.contractedNeighbours = calloc(numberOfCities > 0 ? numberOfCities : 1, sizeof(int));
+    context.levels = calloc(numberOfCities > 0 ? numberOfCities : 1, sizeof(int));
+    context.numberOfThreads = numberOfThreads;
+    context.threads = malloc(numberOfThreads*sizeof(ContractionThread));
+
+    int i;
+    int j;
+    int t;
+    for(i = 0; i < numberOfThreads; i++){
+        context.threads[i].distance = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(Distance));
+        context.threads[i].touched = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+        context.threads[i].numberOfTouched = 0;
+        context.threads[i].minHeap = minHeapConstructor(MIN_HEAP_DEFAULT_TYPE);
+        context.threads[i].isTarget = calloc(numberOfCities > 0 ? numberOfCities : 1, sizeof(char));
+        context.threads[i].shortcuts = malloc(INITIAL_SHORTCUT_CAPACITY*sizeof(Shortcut));
+        context.threads[i].numberOfShortcuts = 0;
+        context.threads[i].shortcutCapacity = INITIAL_SHORTCUT_CAPACITY;
+        for(j = 0; j < numberOfCities; j++){
+            context.threads[i].distance[j] = DISTANCE_INFINITY;
+        }
+    }
+
+    for(i = 0; i < numberOfCities; i++){
+        for(j = csrOffsets[i]; j < csrOffsets[i + 1]; j++){
+            if(csrTargets[j] != i){
+                hierarchyAddEdge(&context.vertices[i], csrTargets[j], csrDistances[j], -1);
+            }
+        }
+    }
+
+    // Vertices not yet contracted, those picked this
+    // round and those whose priority has changed
+    int* remaining = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    int* selected = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    int* changed = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    char* isChanged = calloc(numberOfCities > 0 ? numberOfCities : 1, sizeof(char));
+    int* ranks = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    int numberOfRemaining = numberOfCities;
+    int numberOfSelected;
+    int numberOfChanged;
+    int nextRank = 0;
+    int vertexNumber;
+    int neighbour;
+    Shortcut* shortcut;
+    HierarchyVertex* vertex;
+
+    for(i = 0; i < numberOfCities; i++){
+        remaining[i] = i;
+    }
+
+    context.work = remaining;
+    context.numberOfWork = numberOfRemaining;
+    runContractionPass(&context, priorityPass);
+
+    while(numberOfRemaining > 0){
+
+        numberOfSelected = 0;
+        for(i = 0; i < numberOfRemaining; i++){
+            if(isLocalMinimum(&context, remaining[i])){
+                selected[numberOfSelected] = remaining[i];
+                numberOfSelected++;
+            }
+        }
+
+        for(i = 0; i < numberOfSelected; i++){
+            context.states[selected[i]] = VERTEX_CONTRACTING;
+        }
+
+        context.work = selected;
+        context.numberOfWork = numberOfSelected;
+        runContractionPass(&context, contractPass);
+
+        // Remove the contracted vertices, freezing their upward edges
+        numberOfChanged = 0;
+        for(i = 0; i < numberOfSelected; i++){
+
+            vertexNumber = selected[i];
+            vertex = &context.vertices[vertexNumber];
+            context.states[vertexNumber] = VERTEX_CONTRACTED;
+            ranks[vertexNumber] = nextRank;
+            nextRank++;
+
+            for(j = 0; j < vertex->numberOfEdges; j++){
+                neighbour = vertex->edges[j].target;
+                hierarchyRemoveEdge(&context.vertices[neighbour], vertexNumber);
+                context.contractedNeighbours[neighbour]++;
+                if(context.levels[vertexNumber] + 1 > context.levels[neighbour]){
+                    context.levels[neighbour] = context.levels[vertexNumber] + 1;
+                }
+                if(!isChanged[neighbour]){
+                    isChanged[neighbour] = 1;
+                    changed[numberOfChanged] = neighbour;
+                    numberOfChanged++;
+                }
+            }
+        }
+
+        // Shortcuts are added in the same order for any number of threads
+        for(t = 0; t < numberOfThreads; t++){
+            for(i = 0; i < context.threads[t].numberOfShortcuts; i++){
+                shortcut = &context.threads[t].shortcuts[i];
+                hierarchyAddEdge(&context.vertices[shortcut->from], shortcut->to, shortcut->distance, shortcut->middle);
+                hierarchyAddEdge(&context.vertices[shortcut->to], shortcut->from, shortcut->distance, shortcut->middle);
+            }
+        }
+
+        for(i = 0; i < numberOfChanged; i++){
+            isChanged[changed[i]] = 0;
+        }
+
+        context.work = changed;
+        context.numberOfWork = numberOfChanged;
+        runContractionPass(&context, priorityPass);
+
+        j = 0;
+        for(i = 0; i < numberOfRemaining; i++){
+            if(context.states[remaining[i]] == VERTEX_REMAINING){
+                remaining[j] = remaining[i];
+                j++;
+            }
+        }
+        numberOfRemaining = j;
+    }
+
+    // Pack the upward edges of every vertex
+    int* offsets = malloc((numberOfCities + 1)*sizeof(int));
+    int numberOfUpwardEdges = 0;
+
+    for(i = 0; i < numberOfCities; i++){
+        offsets[i] = numberOfUpwardEdges;
+        numberOfUpwardEdges += context.vertices[i].numberOfEdges;
+    }
+    offsets[numberOfCities] = numberOfUpwardEdges;
+
+    int* targets = malloc((numberOfUpwardEdges > 0 ? numberOfUpwardEdges : 1)*sizeof(int));
+    Distance* distances = malloc((numberOfUpwardEdges > 0 ? numberOfUpwardEdges : 1)*sizeof(Distance));
+    int* middles = malloc((numberOfUpwardEdges > 0 ? numberOfUpwardEdges : 1)*sizeof(int));
+    int numberOfShortcuts = 0;
+
+    for(i = 0; i < numberOfCities; i++){
+        vertex = &context.vertices[i];
+        for(j = 0; j < vertex->numberOfEdges; j++){
+            targets[offsets[i] + j] = vertex->edges[j].target;
+            distances[offsets[i] + j] = vertex->edges[j].distance;
+            middles[offsets[i] + j] = vertex->edges[j].middle;
+            numberOfShortcuts += vertex->edges[j].middle != -1;
+        }
+        free(vertex->edges);
+    }
+
+    for(i = 0; i < numberOfThreads; i++){
+        free(context.threads[i].distance);
+        free(context.threads[i].touched);
+        minHeapDestructor(context.threads[i].minHeap);
+        free(context.threads[i].isTarget);
+        free(context.threads[i].shortcuts);
+    }
+    free(context.threads);
+    free(context.vertices);
+    free(context.states);
+    free(context.priorities);
+    free(context.contractedNeighbours);
+    free(context.levels);
+    free(remaining);
+    free(selected);
+    free(changed);
+    free(isChanged);
+
+    ContractionHierarchy* newHierarchy = malloc(sizeof(ContractionHierarchy));
+
+    newHierarchy->numberOfCities = numberOfCities;
+    newHierarchy->numberOfUpwardEdges = numberOfUpwardEdges;
+    newHierarchy->numberOfShortcuts = numberOfShortcuts;
+    newHierarchy->ranks = ranks;
+    newHierarchy->offsets = offsets;
+    newHierarchy->targets = targets;
+    newHierarchy->distances = distances;
+    newHierarchy->middles = middles;
+    newHierarchy->mappedFile = NULL;
+
+    return newHierarchy;
+}
+
+
+/*
+ * Function: contractionHierarchyDestructor
+ * ----------------------------------------
+ * Frees the arrays if they were malloced or unmaps the
+ * file they came from, then the ContractionHierarchy.
+ */
+void contractionHierarchyDestructor(ContractionHierarchy* hierarchy){
+
+    if(hierarchy->mappedFile != NULL){
+        mappedFileClose(hierarchy->mappedFile);
+    } else {
+        free((int*)hierarchy->ranks);
+        free((int*)hierarchy->offsets);
+        free((int*)hierarchy->targets);
+        free((Distance*)hierarchy->distances);
+        free((int*)hierarchy->middles);
+    }
+    free(hierarchy);
+}
+
+
+/*
+ * Function: contractionHierarchyGetNumberOfShortcuts
+ * --------------------------------------------------
+ * Returns the number of shortcuts.
+ */
+int contractionHierarchyGetNumberOfShortcuts(ContractionHierarchy* hierarchy){
+    return hierarchy->numberOfShortcuts;
+}
+
+
+/*
+ * Function: contractionHierarchyGetRank
+ * -------------------------------------
+ * Returns the rank of a vertex.
+ */
+int contractionHierarchyGetRank(ContractionHierarchy* hierarchy, int vertexNumber){
+    return hierarchy->ranks[vertexNumber];
+}
+
+
+/*
+ * Function: contractionHierarchyGetNumberOfCities
+ * -----------------------------------------------
+ * Returns the number of vertices.
+ */
+int contractionHierarchyGetNumberOfCities(ContractionHierarchy* hierarchy){
+    return hierarchy->numberOfCities;
+}
+
+
+/*
+ * Function: contractionHierarchyGetOffsets
+ * ----------------------------------------
+ * Returns the offsets array.
+ */
+const int* contractionHierarchyGetOffsets(ContractionHierarchy* hierarchy){
+    return hierarchy->offsets;
+}
+
+
+/*
+ * Function: contractionHierarchyGetTargets
+ * ----------------------------------------
+ * Returns the targets array.
+ */
+const int* contractionHierarchyGetTargets(ContractionHierarchy* hierarchy){
+    return hierarchy->targets;
+}
+
+
+/*
+ * Function: contractionHierarchyGetDistances
+ * ------------------------------------------
+ * Returns the distances array.
+ */
+const Distance* contractionHierarchyGetDistances(ContractionHierarchy* hierarchy){
+    return hierarchy->distances;
+}
+
+
+/*
+ * Function: findHierarchyEdge
+ * ---------------------------
+ * Returns the index of the edge between two vertices,
+ * which is an upward edge of the lower ranked one.
+ */
+int findHierarchyEdge(ContractionHierarchy* hierarchy, int a, int b){
+
+    int lower = hierarchy->ranks[a] < hierarchy->ranks[b] ? a : b;
+    int higher = lower == a ? b : a;
+
+    int i;
+    for(i = hierarchy->offsets[lower]; i < hierarchy->offsets[lower + 1]; i++){
+        if(hierarchy->targets[i] == higher){
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/*
+ * Function: contractionHierarchyFindRoute
+ * ---------------------------------------
+ * Runs the upward search from the source in the forward
+ * arrays of the workspace and from the target in the
+ * backward ones, taking a vertex off whichever MinHeap has
+ * the smaller top value. When a vertex is settled that the
+ * other search has reached, the route through it is kept
+ * if it is the shortest so far. A search stops once its top
+ * value is no shorter than that route, as anything it finds
+ * from then on is longer. The upward route is then the
+ * source's previous chain to the meeting vertex followed by
+ * the target's next chain. Each of its edges is unpacked with
+ * a stack: a shortcut is replaced by the two edges either side
+ * of its middle vertex, found as upward edges of the middle
+ * vertex, and a road sets the previous entry of its end, until
+ * the previous array holds the whole route from the source.
+ */
+Distance contractionHierarchyFindRoute(ContractionHierarchy* hierarchy, DijkstraWorkspace* workspace,
+                                       int source, int target){
+
+    const int* offsets = hierarchy->offsets;
+    const int* targets = hierarchy->targets;
+    const Distance* distances = hierarchy->distances;
+
+    // Index 0 is the search from the source and index 1 from the target
+    Distance* distance[2];
+    int* parent[2];
+    MinHeap* minHeap[2];
+    int done[2];
+
+    distance[0] = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    parent[0] = dijkstraWorkspaceGetPrevious(workspace);
+    minHeap[0] = dijkstraWorkspaceGetMinHeap(workspace);
+    distance[1] = dijkstraWorkspaceGetDistanceToTarget(workspace);
+    parent[1] = dijkstraWorkspaceGetNext(workspace);
+    minHeap[1] = dijkstraWorkspaceGetBackwardMinHeap(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
+
+    int i;
+    int end[2] = {source, target};
+    for(i = 0; i < 2; i++){
+        stamps[end[i]] = query;
+        distance[0][end[i]] = DISTANCE_INFINITY;
+        distance[1][end[i]] = DISTANCE_INFINITY;
+        parent[0][end[i]] = -1;
+        parent[1][end[i]] = -1;
+    }
+
+    int numberOfSettled = 0;
+    Distance bestDistance = DISTANCE_INFINITY;
+    int meetingVertex = -1;
+
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+    minHeapEnqueue(minHeap[0], source, 0);
+    minHeapEnqueue(minHeap[1], target, 0);
+
+    while(1){
+
+        int side;
+        int other;
+        int u;
+        int v;
+        Distance alternateRoute;
+
+        for(side = 0; side < 2; side++){
+            done[side] = minHeapIsEmpty(minHeap[side]) || minHeapPeekValue(minHeap[side]) >= bestDistance;
+        }
+        if(done[0] && done[1]){
+            break;
+        }
+
+        side = done[1] || (!done[0] && minHeapPeekValue(minHeap[0]) <= minHeapPeekValue(minHeap[1])) ? 0 : 1;
+        other = 1 - side;
+
+        u = minHeapDequeue(minHeap[side]);
+        numberOfSettled++;
+
+        if(distance[other][u] != DISTANCE_INFINITY && DISTANCE_ADD(distance[side][u], distance[other][u]) < bestDistance){
+            bestDistance = DISTANCE_ADD(distance[side][u], distance[other][u]);
+            meetingVertex = u;
+        }
+
+        int j;
+        for(j = offsets[u]; j < offsets[u + 1]; j++){
+
+            v = targets[j];
+            alternateRoute = DISTANCE_ADD(distance[side][u], distances[j]);
+
+            if(stamps[v] != query){
+                stamps[v] = query;
+                distance[0][v] = DISTANCE_INFINITY;
+                distance[1][v] = DISTANCE_INFINITY;
+                parent[0][v] = -1;
+                parent[1][v] = -1;
+            }
+
+            if(alternateRoute < distance[side][v]){
+                if(distance[side][v] == DISTANCE_INFINITY){
+                    minHeapEnqueue(minHeap[side], v, alternateRoute);
+                } else {
+                    minHeapDecreaseNodeValue(minHeap[side], v, alternateRoute);
+                }
+                distance[side][v] = alternateRoute;
+                parent[side][v] = u;
+            }
+        }
+    }
+
+    minHeapClear(minHeap[0]);
+    minHeapClear(minHeap[1]);
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+
+    if(meetingVertex == -1){
+        distance[0][target] = DISTANCE_INFINITY;
+        parent[0][target] = -1;
+        return DISTANCE_INFINITY;
+    }
+
+    // Upward route from the source to the target through the meeting vertex
+    int numberOfUp = 0;
+    int numberOfHops = 0;
+    for(i = meetingVertex; i != source; i = parent[0][i]){
+        numberOfUp++;
+    }
+    numberOfHops = numberOfUp;
+    for(i = meetingVertex; i != target; i = parent[1][i]){
+        numberOfHops++;
+    }
+
+    int* hops = malloc((numberOfHops + 1)*sizeof(int));
+    int position = numberOfUp;
+    for(i = meetingVertex; i != source; i = parent[0][i]){
+        hops[position] = i;
+        position--;
+    }
+    hops[0] = source;
+    position = numberOfUp;
+    for(i = meetingVertex; i != target; i = parent[1][i]){
+        position++;
+        hops[position] = parent[1][i];
+    }
+
+    // Edges still to unpack, two vertex numbers each
+    int stackCapacity = INITIAL_STACK_CAPACITY;
+    int* stack = malloc(2*stackCapacity*sizeof(int));
+    int stackSize;
+    int a;
+    int b;
+    int edge;
+
+    parent[0][source] = -1;
+
+    for(i = 0; i < numberOfHops; i++){
+
+        stack[0] = hops[i];
+        stack[1] = hops[i + 1];
+        stackSize = 1;
+
+        while(stackSize > 0){
+
+            stackSize--;
+            a = stack[2*stackSize];
+            b = stack[2*stackSize + 1];
+            edge = findHierarchyEdge(hierarchy, a, b);
+
+            if(hierarchy->middles[edge] == -1){
+                parent[0][b] = a;
+                continue;
+            }
+
+            if(stackSize + 2 > stackCapacity){
+                stackCapacity *= 2;
+                stack = realloc(stack, 2*stackCapacity*sizeof(int));
+            }
+            stack[2*stackSize] = hierarchy->middles[edge];
+            stack[2*stackSize + 1] = b;
+            stack[2*stackSize + 2] = a;
+            stack[2*stackSize + 3] = hierarchy->middles[edge];
+            stackSize += 2;
+        }
+    }
+
+    free(stack);
+    free(hops);
+
+    distance[0][target] = bestDistance;
+    return bestDistance;
+}
+
+
+/*
+ * Function: hierarchyAlign
+ * ------------------------
+ * Rounds a file position up to the next section boundary.
+ */
+uint64_t hierarchyAlign(uint64_t position){
+    return (position + SECTION_ALIGNMENT - 1) & ~(uint64_t)(SECTION_ALIGNMENT - 1);
+}
+
+
+/*
+ * Function: hierarchyError
+ * ------------------------
+ * Reports a hierarchy file that can not be used and exits.
+ */
+void hierarchyError(const char* path, const char* reason){
+
+    printf("\n#####################################\n");
+    printf("Error, can not load contraction hierarchy '%s'.\n", path);
+    printf("%s\n", reason);
+    printf("#####################################\n\n");
+    exit(-1);
+}
+
+
+/*
+ * Function: contractionHierarchyWrite
+ * -----------------------------------
+ * Fills in the header with the size and position of every
+ * section, then writes the header and sections in order
+ * with zero bytes padding each section to the next boundary.
+ */
+int contractionHierarchyWrite(ContractionHierarchy* hierarchy, CsrGraph* csrGraph, const char* path){
+
+    const void* sectionData[NUMBER_OF_HIERARCHY_SECTIONS];
+    HierarchyHeader header;
+    memset(&header, 0, sizeof(HierarchyHeader));
+
+    strcpy(header.magic, HIERARCHY_MAGIC);
+    header.version = CONTRACTION_HIERARCHY_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.intSize = sizeof(int);
+    header.weightType = WEIGHT_TYPE;
+    header.numberOfCities = hierarchy->numberOfCities;
+    header.numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+    header.graphFingerprint = csrGraphGetFingerprint(csrGraph);
+    header.numberOfUpwardEdges = hierarchy->numberOfUpwardEdges;
+    header.numberOfShortcuts = hierarchy->numberOfShortcuts;
+
+    sectionData[HIERARCHY_RANKS] = hierarchy->ranks;
+    header.sectionSize[HIERARCHY_RANKS] = (uint64_t)hierarchy->numberOfCities*sizeof(int);
+    sectionData[HIERARCHY_OFFSETS] = hierarchy->offsets;
+    header.sectionSize[HIERARCHY_OFFSETS] = (uint64_t)(hierarchy->numberOfCities + 1)*sizeof(int);
+    sectionData[HIERARCHY_TARGETS] = hierarchy->targets;
+    header.sectionSize[HIERARCHY_TARGETS] = (uint64_t)hierarchy->numberOfUpwardEdges*sizeof(int);
+    sectionData[HIERARCHY_DISTANCES] = hierarchy->distances;
+    header.sectionSize[HIERARCHY_DISTANCES] = (uint64_t)hierarchy->numberOfUpwardEdges*sizeof(Distance);
+    sectionData[HIERARCHY_MIDDLES] = hierarchy->middles;
+    header.sectionSize[HIERARCHY_MIDDLES] = (uint64_t)hierarchy->numberOfUpwardEdges*sizeof(int);
+
+    int i;
+    uint64_t position = hierarchyAlign(sizeof(HierarchyHeader));
+    for(i = 0; i < NUMBER_OF_HIERARCHY_SECTIONS; i++){
+        header.sectionStart[i] = position;
+        position = hierarchyAlign(position + header.sectionSize[i]);
+    }
+    header.fileSize = position;
+
+    FILE* file = fopen(path, "wb");
+    if(file == NULL){
+        return -1;
+    }
+
+    static const char padding[SECTION_ALIGNMENT] = {0};
+    int failed = 0;
+
+    failed |= fwrite(&header, sizeof(HierarchyHeader), 1, file) != 1;
+    position = sizeof(HierarchyHeader);
+
+    for(i = 0; i < NUMBER_OF_HIERARCHY_SECTIONS; i++){
+        failed |= fwrite(padding, 1, header.sectionStart[i] - position, file) != header.sectionStart[i] - position;
+        failed |= fwrite(sectionData[i], 1, header.sectionSize[i], file) != header.sectionSize[i];
+        position = header.sectionStart[i] + header.sectionSize[i];
+    }
+    failed |= fwrite(padding, 1, header.fileSize - position, file) != header.fileSize - position;
+
+    failed |= fclose(file) != 0;
+    return failed ? -1 : 0;
+}
+
+
+/*
+ * Function: contractionHierarchyLoad
+ * ----------------------------------
+ * Maps the file and checks the header against this
+ * program and the CsrGraph, that every section lies
+ * inside the file with the size its counts imply, and
+ * that the offsets start and end where they should.
+ */
+ContractionHierarchy* contractionHierarchyLoad(const char* path, CsrGraph* csrGraph){
+
+    MappedFile* mappedFile = mappedFileOpen(path);
+    if(mappedFile == NULL){
+        hierarchyError(path, "The file could not be opened.");
+    }
+
+    const char* data = mappedFileGetData(mappedFile);
+    size_t size = mappedFileGetSize(mappedFile);
+
+    if(size < sizeof(HierarchyHeader)){
+        hierarchyError(path, "The file is too short to hold a contraction hierarchy.");
+    }
+
+    const HierarchyHeader* header = (const HierarchyHeader*)data;
+
+    if(memcmp(header->magic, HIERARCHY_MAGIC, sizeof(HIERARCHY_MAGIC))){
+        hierarchyError(path, "The file does not hold a contraction hierarchy.");
+    }
+    if(header->version != CONTRACTION_HIERARCHY_VERSION){
+        hierarchyError(path, "The hierarchy was written by a different version, please build it again.");
+    }
+    if(header->byteOrderMark != BYTE_ORDER_MARK || header->intSize != sizeof(int)){
+        hierarchyError(path, "The hierarchy was written on a different kind of machine.");
+    }
+    if(header->weightType != WEIGHT_TYPE){
+        hierarchyError(path, "The hierarchy was written by a program compiled with different distance types.");
+    }
+    if(header->numberOfCities != (uint32_t)csrGraphGetNumberOfCities(csrGraph)
+       || header->numberOfEdges != (uint32_t)csrGraphGetNumberOfEdges(csrGraph)
+       || header->graphFingerprint != csrGraphGetFingerprint(csrGraph)){
+        hierarchyError(path, "The hierarchy was made for a different graph or numbering of its cities, please build it again.");
+    }
+    if(header->fileSize != size){
+        hierarchyError(path, "The file is not the size recorded in its header.");
+    }
+
+    uint64_t numberOfCities = header->numberOfCities;
+    uint64_t numberOfUpwardEdges = header->numberOfUpwardEdges;
+    uint64_t expectedSize[NUMBER_OF_HIERARCHY_SECTIONS];
+
+    expectedSize[HIERARCHY_RANKS] = numberOfCities*sizeof(int);
+    expectedSize[HIERARCHY_OFFSETS] = (numberOfCities + 1)*sizeof(int);
+    expectedSize[HIERARCHY_TARGETS] = numberOfUpwardEdges*sizeof(int);
+    expectedSize[HIERARCHY_DISTANCES] = numberOfUpwardEdges*sizeof(Distance);
+    expectedSize[HIERARCHY_MIDDLES] = numberOfUpwardEdges*sizeof(int);
+
+    int i;
+    for(i = 0; i < NUMBER_OF_HIERARCHY_SECTIONS; i++){
+        if(header->sectionSize[i] != expectedSize[i]
+           || header->sectionStart[i] % SECTION_ALIGNMENT != 0
+           || header->sectionStart[i] > size
+           || header->sectionSize[i] > size - header->sectionStart[i]){
+            hierarchyError(path, "A section of the hierarchy file is damaged.");
+        }
+    }
+
+    const int* offsets = (const int*)(data + header->sectionStart[HIERARCHY_OFFSETS]);
+
+    if(offsets[0] != 0 || (uint64_t)offsets[numberOfCities] != numberOfUpwardEdges){
+        hierarchyError(path, "The arrays of the hierarchy file do not fit together.");
+    }
+
+    ContractionHierarchy* newHierarchy = malloc(sizeof(ContractionHierarchy));
+
+    newHierarchy->numberOfCities = numberOfCities;
+    newHierarchy->numberOfUpwardEdges = numberOfUpwardEdges;
+    newHierarchy->numberOfShortcuts = header->numberOfShortcuts;
+    newHierarchy->ranks = (const int*)(data + header->sectionStart[HIERARCHY_RANKS]);
+    newHierarchy->offsets = offsets;
+    newHierarchy->targets = (const int*)(data + header->sectionStart[HIERARCHY_TARGETS]);
+    newHierarchy->distances = (const Distance*)(data + header->sectionStart[HIERARCHY_DISTANCES]);
+    newHierarchy->middles = (const int*)(data + header->sectionStart[HIERARCHY_MIDDLES]);
+    newHierarchy->mappedFile = mappedFile;
+
+    return newHierarchy;
+}
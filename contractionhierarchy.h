@@ -0,0 +1,131 @@
+/*
+ * contractionhierarchy.h
+ * ----------------------
+ *
+ * The header file for contractionhierarchy.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <csrgraph.h>
+#include <dijkstraworkspace.h>
+
+#define CONTRACTION_HIERARCHY_VERSION 3 // Increased whenever the file layout changes
+
+typedef struct ContractionHierarchy ContractionHierarchy;
+
+/*
+ * Function: contractionHierarchyConstructor
+ * -----------------------------------------
+ * Contracts every vertex of the CsrGraph, least important
+ * first, adding shortcuts that keep the distances between
+ * the rest the same, and returns a pointer to the finished
+ * ContractionHierarchy. The work is shared between
+ * numberOfThreads threads and the result is the same for
+ * any number of them.
+ */
+ContractionHierarchy* contractionHierarchyConstructor(CsrGraph* csrGraph, int numberOfThreads);
+
+
+/*
+ * Function: contractionHierarchyDestructor
+ * ----------------------------------------
+ * Frees the ContractionHierarchy and its arrays, or
+ * unmaps the file they were loaded from.
+ */
+void contractionHierarchyDestructor(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: contractionHierarchyGetNumberOfShortcuts
+ * --------------------------------------------------
+ * Returns the number of shortcuts added.
+ */
+int contractionHierarchyGetNumberOfShortcuts(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: contractionHierarchyGetRank
+ * -------------------------------------
+ * Returns the position of a vertex in the contraction
+ * order, 0 for the first vertex contracted.
+ */
+int contractionHierarchyGetRank(ContractionHierarchy* hierarchy, int vertexNumber);
+
+
+/*
+ * Function: contractionHierarchyGetNumberOfCities
+ * -----------------------------------------------
+ * Returns the number of vertices.
+ */
+int contractionHierarchyGetNumberOfCities(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: contractionHierarchyGetOffsets
+ * ----------------------------------------
+ * Returns the offsets array of the upward edges. The
+ * upward edges of vertex i, to vertices of higher rank,
+ * are stored from offsets[i] up to but not including
+ * offsets[i + 1].
+ */
+const int* contractionHierarchyGetOffsets(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: contractionHierarchyGetTargets
+ * ----------------------------------------
+ * Returns the array of upward edge end vertex numbers.
+ */
+const int* contractionHierarchyGetTargets(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: contractionHierarchyGetDistances
+ * ------------------------------------------
+ * Returns the array of upward edge distances.
+ */
+const Distance* contractionHierarchyGetDistances(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: contractionHierarchyFindRoute
+ * ---------------------------------------
+ * Finds the shortest route from source to target by
+ * searching upwards through the hierarchy from both ends,
+ * then replaces every shortcut on it by the roads it
+ * stands for. Returns the distance, or DISTANCE_INFINITY
+ * if the target can not be reached. Afterwards the
+ * workspace holds the city-by-city route for
+ * dijkstrasCsrWriteToFile() and the number of vertices
+ * settled.
+ */
+Distance contractionHierarchyFindRoute(ContractionHierarchy* hierarchy, DijkstraWorkspace* workspace,
+                                       int source, int target);
+
+
+/*
+ * Function: contractionHierarchyWrite
+ * -----------------------------------
+ * Writes the ContractionHierarchy to a binary file, to be
+ * kept next to the graph it was made for. Returns 0 on
+ * success and -1 if the file could not be written.
+ */
+int contractionHierarchyWrite(ContractionHierarchy* hierarchy, CsrGraph* csrGraph, const char* path);
+
+
+/*
+ * Function: contractionHierarchyLoad
+ * ----------------------------------
+ * Maps a file written by contractionHierarchyWrite()
+ * read-only and returns a ContractionHierarchy whose
+ * arrays point into the mapping. Exits with an error if
+ * the file is missing, damaged, of a different version
+ * or made for a graph with a different fingerprint, see
+ * csrGraphGetFingerprint().
+ */
+ContractionHierarchy* contractionHierarchyLoad(const char* path, CsrGraph* csrGraph);
+
+#endif
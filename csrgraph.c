@@ -0,0 +1,497 @@
+/*
+ * csrgraph.c
+ * ----------
+ *
+ * This file contains the functions for the CsrGraph
+ * abstract data type. A CsrGraph is a compressed sparse row
+ * copy of the adjacency list held in a Graph. Instead of every
+ * Vertex owning an array of pointers to separately allocated
+ * Edges, all edges are stored in two contiguous arrays, one of
+ * end vertex numbers and one of Weights, and an offsets array
+ * records where the edges of each vertex begin. Walking the edges
+ * of a vertex is then a linear scan through memory which is what
+ * the inner loop of Dijkstra's algorithm spends most of its time
+ * doing. City names are kept the same way, packed one after
+ * another in a name pool with an array of where each one starts,
+ * and an open addressing hash table of vertex numbers finds a
+ * vertex from its name. None of the arrays contain pointers so a
+ * CsrGraph can be written to disk and mapped straight back into
+ * memory. The CsrGraph is built once the Graph has been populated
+ * and is never changed afterwards. Dijkstra's algorithm keeps its
+ * state in a DijkstraWorkspace so many queries can share one CsrGraph.
+ * A CsrGraph whose vertices have been renumbered, see vertexorder.c,
+ * also keeps the number each vertex had when the cities were read
+ * and the other way round, so numbers given out before can still be
+ * looked up.
+ *
+ * Files made from a CsrGraph, such as landmarks or a contraction
+ * hierarchy, hold vertex numbers and are only right for the same
+ * roads under the same numbering. Renumbering keeps the number of
+ * cities and roads, so each file records the CsrGraph's fingerprint
+ * instead, a hash of which vertex every road joins and how long it
+ * is. Roads are hashed one at a time and the hashes added up, so
+ * the order roads are listed in for a vertex, which can differ
+ * between loaders, does not change it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <csrgraph.h>
+#include <nameindex.h>
+
+typedef struct CsrGraph{
+
+    int numberOfCities;
+    int numberOfEdges;
+
+    // Edges of vertex i are at offsets[i] to offsets[i + 1] - 1
+    // in both the targets and distances arrays.
+    const int* offsets;
+    const int* targets;
+    const Weight* distances;
+
+    // Name of vertex i starts at namePool + nameOffsets[i]
+    const int* nameOffsets;
+    const char* namePool;
+
+    // Hash table of vertex numbers, -1 for empty slots
+    const int* nameSlots;
+    int nameSlotCapacity;
+
+    // Number each vertex was read as and the number each read
+    // vertex has now, both NULL if never renumbered
+    const int* originalNumbers;
+    const int* newNumbers;
+
+    // Hash of the roads and numbering, 0 until
+    // csrGraphGetFingerprint() is first called
+    uint64_t fingerprint;
+
+    // Snapshot the arrays are mapped from, or NULL
+    // if they were malloced by csrGraphConstructor()
+    MappedFile* mappedFile;
+    int ownsArrays;
+
+} CsrGraph;
+
+
+// Internal function declarations
+uint64_t fingerprintMix(uint64_t value);
+
+
+/*
+ * Function: csrGraphConstructor
+ * -----------------------------
+ * Counts the edges of every Vertex to fill in the offsets
+ * array, then copies each Edge's end vertex number and
+ * distance into the contiguous arrays in the same order
+ * they appear in the Vertex's edges list. City names are
+ * copied into the name pool.
+ */
+CsrGraph* csrGraphConstructor(Graph* graph){
+
+    int numberOfCities = graphGetNumberOfCities(graph);
+
+    int* offsets = malloc((numberOfCities + 1)*sizeof(int));
+    int* nameOffsets = malloc((numberOfCities + 1)*sizeof(int));
+
+    int i;
+    int j;
+
+    // Running totals give the start of each Vertex's edges and name
+    offsets[0] = 0;
+    nameOffsets[0] = 0;
+    for(i = 0; i < numberOfCities; i++){
+        offsets[i + 1] = offsets[i] + vertexGetNumberOfEdges(graphGetVertex(graph, i));
+        nameOffsets[i + 1] = nameOffsets[i] + strlen(vertexGetCityName(graphGetVertex(graph, i))) + 1;
+    }
+
+    int numberOfEdges = offsets[numberOfCities];
+    int* targets = malloc(numberOfEdges*sizeof(int));
+    Weight* distances = malloc(numberOfEdges*sizeof(Weight));
+    char* namePool = malloc(nameOffsets[numberOfCities]);
+
+    Vertex* vertex;
+    Edge* edge;
+
+    for(i = 0; i < numberOfCities; i++){
+        vertex = graphGetVertex(graph, i);
+
+        for(j = 0; j < vertexGetNumberOfEdges(vertex); j++){
+            edge = vertexGetEdge(vertex, j);
+            targets[offsets[i] + j] = edgeGetEndVertexNumber(edge);
+            distances[offsets[i] + j] = edgeGetDistance(edge);
+        }
+
+        // Copies the null-terminator too
+        memcpy(namePool + nameOffsets[i], vertexGetCityName(vertex), nameOffsets[i + 1] - nameOffsets[i]);
+    }
+
+    return csrGraphConstructorFromOwnedArrays(numberOfCities, numberOfEdges, offsets, targets, distances,
+                                              nameOffsets, namePool);
+}
+
+
+/*
+ * Function: csrGraphConstructorFromOwnedArrays
+ * --------------------------------------------
+ * Hashes every city name in the pool into a table with at
+ * least twice as many slots as there are cities and builds
+ * a CsrGraph that frees the arrays when it is destroyed.
+ */
+CsrGraph* csrGraphConstructorFromOwnedArrays(int numberOfCities, int numberOfEdges,
+                                             int* offsets, int* targets, Weight* distances,
+                                             int* nameOffsets, char* namePool){
+
+    int i;
+    int nameSlotCapacity = 1;
+    while(nameSlotCapacity < 2*numberOfCities){
+        nameSlotCapacity *= 2;
+    }
+
+    int* nameSlots = malloc(nameSlotCapacity*sizeof(int));
+    unsigned int mask = nameSlotCapacity - 1;
+    unsigned int position;
+
+    for(i = 0; i < nameSlotCapacity; i++){
+        nameSlots[i] = -1;
+    }
+    for(i = 0; i < numberOfCities; i++){
+        position = nameIndexHash(namePool + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i] - 1) & mask;
+        // Linear probe to the next empty slot
+        while(nameSlots[position] != -1){
+            position = (position + 1) & mask;
+        }
+        nameSlots[position] = i;
+    }
+
+    CsrGraph* newCsrGraph = csrGraphConstructorFromArrays(numberOfCities, numberOfEdges,
+                                                          offsets, targets, distances,
+                                                          nameOffsets, namePool,
+                                                          nameSlots, nameSlotCapacity, NULL);
+    newCsrGraph->ownsArrays = 1;
+    return newCsrGraph;
+}
+
+
+/*
+ * Function: csrGraphConstructorFromArrays
+ * ---------------------------------------
+ * Builds a CsrGraph around existing arrays without
+ * copying them.
+ */
+CsrGraph* csrGraphConstructorFromArrays(int numberOfCities, int numberOfEdges,
+                                        const int* offsets, const int* targets, const Weight* distances,
+                                        const int* nameOffsets, const char* namePool,
+                                        const int* nameSlots, int nameSlotCapacity,
+                                        MappedFile* mappedFile){
+
+    CsrGraph* newCsrGraph = malloc(sizeof(CsrGraph));
+
+    newCsrGraph->numberOfCities = numberOfCities;
+    newCsrGraph->numberOfEdges = numberOfEdges;
+    newCsrGraph->offsets = offsets;
+    newCsrGraph->targets = targets;
+    newCsrGraph->distances = distances;
+    newCsrGraph->nameOffsets = nameOffsets;
+    newCsrGraph->namePool = namePool;
+    newCsrGraph->nameSlots = nameSlots;
+    newCsrGraph->nameSlotCapacity = nameSlotCapacity;
+    newCsrGraph->originalNumbers = NULL;
+    newCsrGraph->newNumbers = NULL;
+    newCsrGraph->fingerprint = 0;
+    newCsrGraph->mappedFile = mappedFile;
+    newCsrGraph->ownsArrays = 0;
+
+    return newCsrGraph;
+}
+
+
+/*
+ * Function: csrGraphDestructor
+ * ----------------------------
+ * Frees the arrays if they were malloced or unmaps
+ * the snapshot they came from, then the CsrGraph.
+ */
+void csrGraphDestructor(CsrGraph* csrGraph){
+
+    if(csrGraph->ownsArrays){
+        free((int*)csrGraph->offsets);
+        free((int*)csrGraph->targets);
+        free((Weight*)csrGraph->distances);
+        free((int*)csrGraph->nameOffsets);
+        free((char*)csrGraph->namePool);
+        free((int*)csrGraph->nameSlots);
+        free((int*)csrGraph->originalNumbers);
+        free((int*)csrGraph->newNumbers);
+    }
+    if(csrGraph->mappedFile != NULL){
+        mappedFileClose(csrGraph->mappedFile);
+    }
+
+    free(csrGraph);
+}
+
+
+/*
+ * Function: csrGraphGetNumberOfCities
+ * -----------------------------------
+ * Returns the number of Vertices.
+ */
+int csrGraphGetNumberOfCities(CsrGraph* csrGraph){
+    return csrGraph->numberOfCities;
+}
+
+
+/*
+ * Function: csrGraphGetNumberOfEdges
+ * ----------------------------------
+ * Returns the number of directed edges.
+ */
+int csrGraphGetNumberOfEdges(CsrGraph* csrGraph){
+    return csrGraph->numberOfEdges;
+}
+
+
+/*
+ * Function: csrGraphGetOffsets
+ * ----------------------------
+ * Returns the offsets array.
+ */
+const int* csrGraphGetOffsets(CsrGraph* csrGraph){
+    return csrGraph->offsets;
+}
+
+
+/*
+ * Function: csrGraphGetTargets
+ * ----------------------------
+ * Returns the array of edge end vertex numbers.
+ */
+const int* csrGraphGetTargets(CsrGraph* csrGraph){
+    return csrGraph->targets;
+}
+
+
+/*
+ * Function: csrGraphGetDistances
+ * ------------------------------
+ * Returns the array of edge distances.
+ */
+const Weight* csrGraphGetDistances(CsrGraph* csrGraph){
+    return csrGraph->distances;
+}
+
+
+/*
+ * Function: csrGraphGetNameOffsets
+ * --------------------------------
+ * Returns the array of name starts in the name pool.
+ */
+const int* csrGraphGetNameOffsets(CsrGraph* csrGraph){
+    return csrGraph->nameOffsets;
+}
+
+
+/*
+ * Function: csrGraphGetNamePool
+ * -----------------------------
+ * Returns the packed city names.
+ */
+const char* csrGraphGetNamePool(CsrGraph* csrGraph){
+    return csrGraph->namePool;
+}
+
+
+/*
+ * Function: csrGraphGetNameSlots
+ * ------------------------------
+ * Returns the name hash table.
+ */
+const int* csrGraphGetNameSlots(CsrGraph* csrGraph){
+    return csrGraph->nameSlots;
+}
+
+
+/*
+ * Function: csrGraphGetNameSlotCapacity
+ * -------------------------------------
+ * Returns the number of slots in the name hash table.
+ */
+int csrGraphGetNameSlotCapacity(CsrGraph* csrGraph){
+    return csrGraph->nameSlotCapacity;
+}
+
+
+/*
+ * Function: csrGraphSetOriginalNumbers
+ * ------------------------------------
+ * Stores the translation table, freed with the other
+ * arrays if the CsrGraph owns them.
+ */
+void csrGraphSetOriginalNumbers(CsrGraph* csrGraph, const int* originalNumbers, const int* newNumbers){
+    csrGraph->originalNumbers = originalNumbers;
+    csrGraph->newNumbers = newNumbers;
+}
+
+
+/*
+ * Function: csrGraphGetOriginalNumbers
+ * ------------------------------------
+ * Returns the original number of every vertex.
+ */
+const int* csrGraphGetOriginalNumbers(CsrGraph* csrGraph){
+    return csrGraph->originalNumbers;
+}
+
+
+/*
+ * Function: csrGraphGetNewNumbers
+ * -------------------------------
+ * Returns the new number of every original vertex.
+ */
+const int* csrGraphGetNewNumbers(CsrGraph* csrGraph){
+    return csrGraph->newNumbers;
+}
+
+
+/*
+ * Function: csrGraphGetOriginalNumber
+ * -----------------------------------
+ * Looks the vertex up in the translation table, if any.
+ */
+int csrGraphGetOriginalNumber(CsrGraph* csrGraph, int vertexNumber){
+    return csrGraph->originalNumbers != NULL ? csrGraph->originalNumbers[vertexNumber] : vertexNumber;
+}
+
+
+/*
+ * Function: csrGraphGetVertexNumberOfOriginal
+ * -------------------------------------------
+ * Looks the original number up in the translation
+ * table, if any.
+ */
+int csrGraphGetVertexNumberOfOriginal(CsrGraph* csrGraph, int originalNumber){
+    return csrGraph->newNumbers != NULL ? csrGraph->newNumbers[originalNumber] : originalNumber;
+}
+
+
+/*
+ * Function: fingerprintMix
+ * ------------------------
+ * Scrambles a 64 bit value so every bit of it changes
+ * about half the bits of the result, the finaliser of
+ * splitmix64.
+ */
+uint64_t fingerprintMix(uint64_t value){
+
+    value = (value ^ (value >> 30))*0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27))*0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+
+/*
+ * Function: csrGraphGetFingerprint
+ * --------------------------------
+ * Adds up a hash of each road's start vertex, end vertex
+ * and length, then mixes in the number of cities and
+ * roads. Reads every road the first time so the result
+ * is kept.
+ */
+uint64_t csrGraphGetFingerprint(CsrGraph* csrGraph){
+
+    if(csrGraph->fingerprint != 0){
+        return csrGraph->fingerprint;
+    }
+
+    uint64_t sum = 0;
+    uint64_t lengthBits;
+
+    int i;
+    int j;
+    for(i = 0; i < csrGraph->numberOfCities; i++){
+        for(j = csrGraph->offsets[i]; j < csrGraph->offsets[i + 1]; j++){
+            lengthBits = 0;
+            memcpy(&lengthBits, &csrGraph->distances[j], sizeof(Weight));
+            sum += fingerprintMix(((uint64_t)i << 32 | (uint32_t)csrGraph->targets[j]) ^ fingerprintMix(lengthBits));
+        }
+    }
+
+    uint64_t fingerprint = fingerprintMix(sum ^ fingerprintMix((uint64_t)csrGraph->numberOfCities << 32
+                                                               | (uint32_t)csrGraph->numberOfEdges));
+
+    // 0 marks a fingerprint not found yet
+    csrGraph->fingerprint = fingerprint != 0 ? fingerprint : 1;
+    return csrGraph->fingerprint;
+}
+
+
+/*
+ * Function: csrGraphSetFingerprint
+ * --------------------------------
+ * Stores a fingerprint found before.
+ */
+void csrGraphSetFingerprint(CsrGraph* csrGraph, uint64_t fingerprint){
+    csrGraph->fingerprint = fingerprint;
+}
+
+
+/*
+ * Function: csrGraphReleaseRoads
+ * ------------------------------
+ * Finds the fingerprint while the roads are still there,
+ * then frees the targets and distances, or hands their
+ * pages of the snapshot back to the system.
+ */
+void csrGraphReleaseRoads(CsrGraph* csrGraph){
+
+    csrGraphGetFingerprint(csrGraph);
+
+    if(csrGraph->ownsArrays){
+        free((int*)csrGraph->targets);
+        free((Weight*)csrGraph->distances);
+    } else if(csrGraph->mappedFile != NULL){
+        mappedFileRelease(csrGraph->mappedFile, csrGraph->targets, (size_t)csrGraph->numberOfEdges*sizeof(int));
+        mappedFileRelease(csrGraph->mappedFile, csrGraph->distances, (size_t)csrGraph->numberOfEdges*sizeof(Weight));
+    }
+    csrGraph->targets = NULL;
+    csrGraph->distances = NULL;
+}
+
+
+/*
+ * Function: csrGraphGetCityName
+ * -----------------------------
+ * Returns the city name of a vertex number.
+ */
+const char* csrGraphGetCityName(CsrGraph* csrGraph, int vertexNumber){
+    return csrGraph->namePool + csrGraph->nameOffsets[vertexNumber];
+}
+
+
+/*
+ * Function: csrGraphGetVertexNumber
+ * ---------------------------------
+ * Probes the name hash table from the name's home slot
+ * comparing against the names in the pool until the name
+ * or an empty slot is found.
+ */
+int csrGraphGetVertexNumber(CsrGraph* csrGraph, const char* name, int length){
+
+    unsigned int mask = csrGraph->nameSlotCapacity - 1;
+    unsigned int position = nameIndexHash(name, length) & mask;
+    int vertexNumber;
+
+    while((vertexNumber = csrGraph->nameSlots[position]) != -1){
+        // Stored length does not count the null-terminator
+        if(csrGraph->nameOffsets[vertexNumber + 1] - csrGraph->nameOffsets[vertexNumber] - 1 == length
+           && !memcmp(csrGraph->namePool + csrGraph->nameOffsets[vertexNumber], name, length)){
+            return vertexNumber;
+        }
+        position = (position + 1) & mask;
+    }
+    return -1;
+}
@@ -0,0 +1,245 @@
+/*
+ * csrgraph.h
+ * ----------
+ *
+ * The header file for csrgraph.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <stdint.h>
+#include <graph.h>
+#include <mappedfile.h>
+
+typedef struct CsrGraph CsrGraph;
+
+/*
+ * Function: csrGraphConstructor
+ * -----------------------------
+ * Builds an immutable compressed sparse row copy of the
+ * adjacency list and city names of a fully populated Graph.
+ * The Graph may be destroyed afterwards.
+ */
+CsrGraph* csrGraphConstructor(Graph* graph);
+
+
+/*
+ * Function: csrGraphConstructorFromOwnedArrays
+ * --------------------------------------------
+ * Builds a CsrGraph from malloced arrays laid out the same
+ * way as a CsrGraph's and builds the name hash table for
+ * them. The CsrGraph takes ownership of the arrays and frees
+ * them in csrGraphDestructor().
+ */
+CsrGraph* csrGraphConstructorFromOwnedArrays(int numberOfCities, int numberOfEdges,
+                                             int* offsets, int* targets, Weight* distances,
+                                             int* nameOffsets, char* namePool);
+
+
+/*
+ * Function: csrGraphConstructorFromArrays
+ * ---------------------------------------
+ * Builds a CsrGraph around arrays that already exist, such
+ * as those inside a memory mapped snapshot. The arrays are
+ * not copied. If mappedFile is not NULL it is closed by
+ * csrGraphDestructor(), otherwise the arrays are not freed.
+ */
+CsrGraph* csrGraphConstructorFromArrays(int numberOfCities, int numberOfEdges,
+                                        const int* offsets, const int* targets, const Weight* distances,
+                                        const int* nameOffsets, const char* namePool,
+                                        const int* nameSlots, int nameSlotCapacity,
+                                        MappedFile* mappedFile);
+
+
+/*
+ * Function: csrGraphDestructor
+ * ----------------------------
+ * Frees dynamically allocated memory of the CsrGraph.
+ */
+void csrGraphDestructor(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNumberOfCities
+ * -----------------------------------
+ * Returns the number of Vertices.
+ */
+int csrGraphGetNumberOfCities(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNumberOfEdges
+ * ----------------------------------
+ * Returns the number of directed edges, each road
+ * in the input file counts twice.
+ */
+int csrGraphGetNumberOfEdges(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetOffsets
+ * ----------------------------
+ * Returns the offsets array. The edges of vertex i are
+ * stored from offsets[i] up to but not including offsets[i + 1].
+ */
+const int* csrGraphGetOffsets(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetTargets
+ * ----------------------------
+ * Returns the array of edge end vertex numbers.
+ */
+const int* csrGraphGetTargets(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetDistances
+ * ------------------------------
+ * Returns the array of edge distances, each of the
+ * Weight type chosen when compiling, see weight.h.
+ */
+const Weight* csrGraphGetDistances(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNameOffsets
+ * --------------------------------
+ * Returns the array of where each city name starts in
+ * the name pool, with one extra entry for the pool's end.
+ */
+const int* csrGraphGetNameOffsets(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNamePool
+ * -----------------------------
+ * Returns all the null-terminated city names
+ * stored one after another.
+ */
+const char* csrGraphGetNamePool(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNameSlots
+ * ------------------------------
+ * Returns the open addressing hash table of vertex
+ * numbers used by csrGraphGetVertexNumber(), empty
+ * slots hold -1.
+ */
+const int* csrGraphGetNameSlots(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNameSlotCapacity
+ * -------------------------------------
+ * Returns the number of slots in the name hash table,
+ * always a power of two.
+ */
+int csrGraphGetNameSlotCapacity(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphSetOriginalNumbers
+ * ------------------------------------
+ * Gives a renumbered CsrGraph its translation table:
+ * originalNumbers holds the number each vertex had when
+ * the cities were read, newNumbers the number each of
+ * those has now. A CsrGraph that owns its arrays takes
+ * ownership of these too.
+ */
+void csrGraphSetOriginalNumbers(CsrGraph* csrGraph, const int* originalNumbers, const int* newNumbers);
+
+
+/*
+ * Function: csrGraphGetOriginalNumbers
+ * ------------------------------------
+ * Returns the array of the number each vertex had when
+ * the cities were read, or NULL if the vertices have
+ * never been renumbered.
+ */
+const int* csrGraphGetOriginalNumbers(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetNewNumbers
+ * -------------------------------
+ * Returns the array of the vertex number each city read
+ * has now, indexed by its original number, or NULL if the
+ * vertices have never been renumbered.
+ */
+const int* csrGraphGetNewNumbers(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetOriginalNumber
+ * -----------------------------------
+ * Returns the number a vertex had when the cities were
+ * read, which is its vertex number if never renumbered.
+ */
+int csrGraphGetOriginalNumber(CsrGraph* csrGraph, int vertexNumber);
+
+
+/*
+ * Function: csrGraphGetVertexNumberOfOriginal
+ * -------------------------------------------
+ * Returns the vertex number now of the city that was
+ * read as originalNumber.
+ */
+int csrGraphGetVertexNumberOfOriginal(CsrGraph* csrGraph, int originalNumber);
+
+
+/*
+ * Function: csrGraphGetFingerprint
+ * --------------------------------
+ * Returns a hash of every road and the numbers of the
+ * vertices it joins, recorded in files made from the
+ * CsrGraph so they are only used with the same roads
+ * under the same numbering. Found the first time it is
+ * asked for, which reads every road.
+ */
+uint64_t csrGraphGetFingerprint(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphSetFingerprint
+ * --------------------------------
+ * Gives the CsrGraph the fingerprint recorded with its
+ * arrays, such as in a snapshot, so it is not found
+ * again by reading every road.
+ */
+void csrGraphSetFingerprint(CsrGraph* csrGraph, uint64_t fingerprint);
+
+
+/*
+ * Function: csrGraphReleaseRoads
+ * ------------------------------
+ * Gives back the memory of the end vertices and lengths
+ * of the roads once another copy of them, such as a
+ * CompressedGraph, is used instead. Only the names,
+ * offsets, numbering and fingerprint can be used
+ * afterwards; csrGraphGetTargets() and
+ * csrGraphGetDistances() return NULL.
+ */
+void csrGraphReleaseRoads(CsrGraph* csrGraph);
+
+
+/*
+ * Function: csrGraphGetCityName
+ * -----------------------------
+ * Returns the city name of a vertex number.
+ */
+const char* csrGraphGetCityName(CsrGraph* csrGraph, int vertexNumber);
+
+
+/*
+ * Function: csrGraphGetVertexNumber
+ * ---------------------------------
+ * Returns the vertex number of the first length characters
+ * of name, or -1 if the city is not known.
+ */
+int csrGraphGetVertexNumber(CsrGraph* csrGraph, const char* name, int length);
+
+#endif
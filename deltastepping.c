@@ -0,0 +1,667 @@
+/*
+ * deltastepping.c
+ * ---------------
+ *
+ * This file contains the functions for the DeltaStepping abstract
+ * data type, a single source search that shares the work of one
+ * run between threads. Dijkstra's settles one vertex at a time, so
+ * a single run can not be split up. Delta-stepping instead gathers
+ * vertices into buckets of distances delta kilometres wide, bucket
+ * b holding distances from b*delta to (b + 1)*delta - 1, and
+ * settles a whole bucket at once, the threads sharing out its
+ * vertices.
+ *
+ * Roads shorter than delta are light and the rest heavy. A light
+ * road can lead back into the bucket being settled, so the bucket
+ * is emptied over and over, relaxing the light roads of whatever
+ * it holds, until nothing more is added to it. Only then are the
+ * heavy roads of every vertex settled in it relaxed, once each, as
+ * they can only lead to later buckets. A small delta means few
+ * vertices per bucket to share out and a large one means vertices
+ * emptied from a bucket more than once, so the best delta lies in
+ * between.
+ *
+ * Bucket numbers are found in the Distance type and kept as 64 bit
+ * ints, so long routes and a small delta can not overflow them. The
+ * buckets that can hold vertices at any one time lie between the
+ * one being settled and the one the longest road from it leads to,
+ * so each thread keeps a ring of bins with bucket b in bin
+ * b % numberOfBins, enough bins to cover that span when it fits
+ * under MAXIMUM_NUMBER_OF_BINS. When it does not, the ring wraps
+ * and a bin can hold vertices of a later bucket as well. Those are
+ * put aside while the bucket is emptied and added back afterwards.
+ *
+ * Each thread keeps its own buckets, adding to them without
+ * locking. A bucket is emptied by every thread swapping its own
+ * out for an empty one, then each taking an equal share of all of
+ * them. Distances are shared and lowered with an atomic compare
+ * and swap, so when two threads find a shorter route to the same
+ * vertex the shorter one is kept. The vertex goes into a bucket
+ * along with the distance it was added with, and is skipped when
+ * taken out if its distance has been lowered since, as it was then
+ * added again. The threads wait for each other with a barrier at
+ * each step.
+ *
+ * Which thread lowers a distance last depends on timing, so the
+ * previous vertices are not recorded during the search. Once every
+ * distance is known each vertex picks, out of the neighbours on a
+ * shortest route to it, the one nearest the source and then the
+ * one with the lowest vertex number. Dijkstra's settles the nearest
+ * neighbour first and keeps it, so the routes are the same as
+ * dijkstrasCsr() finds unless two of those neighbours are the same
+ * distance from the source. Roads run both ways, so the roads of a
+ * vertex are also the roads to it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <deltastepping.h>
+#include <threadrunner.h>
+
+#define INITIAL_BIN_CAPACITY 64 // Vertices, doubling when full
+#define MAXIMUM_NUMBER_OF_BINS (1 << 12) // Per thread, later buckets wrap around
+#define MAXIMUM_BUCKET ((int64_t)1 << 62) // Every longer distance shares this bucket
+#define NO_BUCKET INT64_MAX
+
+// A vertex number and the distance it was added with
+typedef struct DeltaEntry{
+
+    int vertexNumber;
+    Distance distance;
+
+} DeltaEntry;
+
+
+// One thread's part of a bucket
+typedef struct DeltaBin{
+
+    DeltaEntry* entries;
+    int size;
+    int capacity;
+    int64_t lowestBucket; // Of its entries, NO_BUCKET if it has none
+
+} DeltaBin;
+
+
+typedef struct DeltaThread{
+
+    // Bucket b is in bins[b % numberOfBins]
+    DeltaBin* bins;
+    long numberOfEntries; // In all bins, so a thread with none need not look
+
+    // Entries of later buckets taken out of the bin
+    // of the bucket being emptied, added back after
+    DeltaBin deferred;
+
+    // The bin of the bucket being emptied, shared
+    // with the other threads while it is
+    DeltaBin current;
+
+    // Vertices settled in the current bucket whose
+    // heavy roads are still to be relaxed
+    int* settled;
+    int numberSettled;
+    int settledCapacity;
+
+    // Set for the other threads to read between barriers
+    int64_t nextBucket;
+    int numberOfSettled;
+
+} DeltaThread;
+
+
+typedef struct DeltaStepping{
+
+    CsrGraph* csrGraph;
+    int numberOfThreads;
+    int delta;
+    int numberOfBins; // A power of two
+
+    DeltaThread* threads;
+
+    // Bucket each vertex was last settled in, so its
+    // heavy roads are only relaxed once per bucket
+    int64_t* lastBucket;
+
+    pthread_barrier_t barrier;
+
+    // Set for each run
+    int source;
+    Distance* distanceFromSource;
+    int* previous;
+    char* visited;
+    unsigned int* stamps;
+    unsigned int query;
+
+} DeltaStepping;
+
+
+typedef struct DeltaTask{
+
+    DeltaStepping* deltaStepping;
+    int threadNumber;
+
+} DeltaTask;
+
+
+// Internal function declarations
+void* deltaSteppingPass(void* argument);
+void deltaSteppingEmptyBucket(DeltaStepping* deltaStepping, DeltaThread* thread, int threadNumber, int64_t bucket);
+void deltaSteppingRelax(DeltaStepping* deltaStepping, DeltaThread* thread, int vertexNumber, Distance distance);
+int64_t deltaSteppingBucketOf(Distance distance, int delta);
+void deltaSteppingAdd(DeltaStepping* deltaStepping, DeltaThread* thread, int vertexNumber, Distance distance);
+void deltaSteppingFindPrevious(DeltaStepping* deltaStepping, DeltaThread* thread, int threadNumber);
+int64_t deltaSteppingNextBucket(DeltaStepping* deltaStepping, DeltaThread* thread, int64_t bucket);
+void deltaBinPush(DeltaBin* bin, int vertexNumber, Distance distance);
+void deltaSteppingOutOfMemory(void);
+
+
+/*
+ * Function: deltaSteppingConstructor
+ * ----------------------------------
+ * Sets up a DeltaThread per thread with an empty ring of
+ * bins. The default delta is the mean length of a road,
+ * found to be about right on road-like graphs. The ring
+ * has a bin for every bucket from the one being settled
+ * to the one the longest road leads to, rounded up to a
+ * power of two, but at most MAXIMUM_NUMBER_OF_BINS.
+ */
+DeltaStepping* deltaSteppingConstructor(CsrGraph* csrGraph, int numberOfThreads, int delta){
+
+    DeltaStepping* newDeltaStepping = malloc(sizeof(DeltaStepping));
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    int numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+    const Weight* distances = csrGraphGetDistances(csrGraph);
+
+    double totalDistance = 0;
+    double longestRoad = 0;
+    int i;
+    int j;
+    for(i = 0; i < numberOfEdges; i++){
+        totalDistance += distances[i];
+        if(distances[i] > longestRoad){
+            longestRoad = distances[i];
+        }
+    }
+
+    if(delta <= 0){
+        delta = numberOfEdges > 0 ? (int)(totalDistance/numberOfEdges) : 1;
+        if(delta < 1){
+            delta = 1;
+        }
+    }
+
+    int numberOfBins = 1;
+    while(numberOfBins < MAXIMUM_NUMBER_OF_BINS && numberOfBins < longestRoad/delta + 2){
+        numberOfBins *= 2;
+    }
+
+    newDeltaStepping->csrGraph = csrGraph;
+    newDeltaStepping->numberOfThreads = numberOfThreads;
+    newDeltaStepping->delta = delta;
+    newDeltaStepping->numberOfBins = numberOfBins;
+    newDeltaStepping->threads = calloc(numberOfThreads, sizeof(DeltaThread));
+    newDeltaStepping->lastBucket = malloc(numberOfCities*sizeof(int64_t));
+    if(newDeltaStepping->threads == NULL || newDeltaStepping->lastBucket == NULL){
+        deltaSteppingOutOfMemory();
+    }
+    for(i = 0; i < numberOfThreads; i++){
+        newDeltaStepping->threads[i].bins = calloc(numberOfBins, sizeof(DeltaBin));
+        if(newDeltaStepping->threads[i].bins == NULL){
+            deltaSteppingOutOfMemory();
+        }
+        for(j = 0; j < numberOfBins; j++){
+            newDeltaStepping->threads[i].bins[j].lowestBucket = NO_BUCKET;
+        }
+    }
+    pthread_barrier_init(&newDeltaStepping->barrier, NULL, numberOfThreads);
+
+    return newDeltaStepping;
+}
+
+
+/*
+ * Function: deltaSteppingDestructor
+ * ---------------------------------
+ * Frees every thread's bins and lists, then the
+ * DeltaStepping.
+ */
+void deltaSteppingDestructor(DeltaStepping* deltaStepping){
+
+    int i;
+    int j;
+    for(i = 0; i < deltaStepping->numberOfThreads; i++){
+        DeltaThread* thread = &deltaStepping->threads[i];
+        for(j = 0; j < deltaStepping->numberOfBins; j++){
+            free(thread->bins[j].entries);
+        }
+        free(thread->bins);
+        free(thread->current.entries);
+        free(thread->deferred.entries);
+        free(thread->settled);
+    }
+    pthread_barrier_destroy(&deltaStepping->barrier);
+    free(deltaStepping->threads);
+    free(deltaStepping->lastBucket);
+    free(deltaStepping);
+}
+
+
+/*
+ * Function: deltaSteppingGetDelta
+ * -------------------------------
+ * Returns the width of each bucket.
+ */
+int deltaSteppingGetDelta(DeltaStepping* deltaStepping){
+    return deltaStepping->delta;
+}
+
+
+/*
+ * Function: deltaSteppingRun
+ * --------------------------
+ * Runs deltaSteppingPass() on every thread and adds up
+ * the vertices they settled. Every thread is started
+ * before any is joined, and the threads only get past
+ * their first barrier once all of them have reached it,
+ * so if one can not be started the program exits while
+ * the others are still waiting there rather than hanging
+ * on a barrier that is never full.
+ */
+void deltaSteppingRun(DeltaStepping* deltaStepping, DijkstraWorkspace* workspace, int source){
+
+    pthread_t* handles = malloc(deltaStepping->numberOfThreads*sizeof(pthread_t));
+    DeltaTask* tasks = malloc(deltaStepping->numberOfThreads*sizeof(DeltaTask));
+    int numberOfSettled = 0;
+
+    deltaStepping->source = source;
+    deltaStepping->distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    deltaStepping->previous = dijkstraWorkspaceGetPrevious(workspace);
+    deltaStepping->visited = dijkstraWorkspaceGetVisited(workspace);
+    deltaStepping->stamps = dijkstraWorkspaceGetStamps(workspace);
+    deltaStepping->query = dijkstraWorkspaceStartQuery(workspace);
+
+    int i;
+    for(i = 0; i < deltaStepping->numberOfThreads; i++){
+        tasks[i].deltaStepping = deltaStepping;
+        tasks[i].threadNumber = i;
+    }
+    threadRunnerStart(handles, deltaStepping->numberOfThreads, deltaSteppingPass, tasks, sizeof(DeltaTask));
+
+    for(i = 0; i < deltaStepping->numberOfThreads; i++){
+        pthread_join(handles[i], NULL);
+        numberOfSettled += deltaStepping->threads[i].numberOfSettled;
+    }
+
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+
+    free(handles);
+    free(tasks);
+}
+
+
+/*
+ * Function: deltaSteppingPass
+ * ---------------------------
+ * One thread's part of a run. Resets its share of the
+ * distances, then settles the buckets in order with the
+ * other threads, each bucket by emptying it until it
+ * stays empty and then relaxing the heavy roads of the
+ * vertices settled in it. Every thread reads the same
+ * values between the same barriers, so they all agree
+ * when a bucket is finished and which comes next. Once
+ * there are no more the thread finds the previous vertex
+ * of its share of the vertices.
+ */
+void* deltaSteppingPass(void* argument){
+
+    DeltaTask* task = argument;
+    DeltaStepping* deltaStepping = task->deltaStepping;
+    DeltaThread* thread = &deltaStepping->threads[task->threadNumber];
+    const int* offsets = csrGraphGetOffsets(deltaStepping->csrGraph);
+    const int* targets = csrGraphGetTargets(deltaStepping->csrGraph);
+    const Weight* distances = csrGraphGetDistances(deltaStepping->csrGraph);
+    Distance* distanceFromSource = deltaStepping->distanceFromSource;
+    int numberOfCities = csrGraphGetNumberOfCities(deltaStepping->csrGraph);
+    int numberOfThreads = deltaStepping->numberOfThreads;
+    int delta = deltaStepping->delta;
+
+    int first = (long)numberOfCities*task->threadNumber/numberOfThreads;
+    int last = (long)numberOfCities*(task->threadNumber + 1)/numberOfThreads;
+    int64_t bucket = 0;
+
+    int i;
+    int j;
+    for(i = first; i < last; i++){
+        distanceFromSource[i] = DISTANCE_INFINITY;
+        deltaStepping->lastBucket[i] = -1;
+    }
+    pthread_barrier_wait(&deltaStepping->barrier);
+
+    if(task->threadNumber == 0){
+        distanceFromSource[deltaStepping->source] = 0;
+        deltaSteppingAdd(deltaStepping, thread, deltaStepping->source, 0);
+    }
+
+    while(bucket != NO_BUCKET){
+
+        deltaSteppingEmptyBucket(deltaStepping, thread, task->threadNumber, bucket);
+
+        // The light roads are done, so distances in this bucket are final
+        for(i = 0; i < thread->numberSettled; i++){
+            int u = thread->settled[i];
+            Distance distanceOfU;
+            __atomic_load(&distanceFromSource[u], &distanceOfU, __ATOMIC_RELAXED);
+            for(j = offsets[u]; j < offsets[u + 1]; j++){
+                if(distances[j] >= delta){
+                    deltaSteppingRelax(deltaStepping, thread, targets[j], DISTANCE_ADD(distanceOfU, distances[j]));
+                }
+            }
+        }
+        thread->numberSettled = 0;
+
+        thread->nextBucket = deltaSteppingNextBucket(deltaStepping, thread, bucket);
+        pthread_barrier_wait(&deltaStepping->barrier);
+
+        bucket = NO_BUCKET;
+        for(i = 0; i < numberOfThreads; i++){
+            if(deltaStepping->threads[i].nextBucket < bucket){
+                bucket = deltaStepping->threads[i].nextBucket;
+            }
+        }
+    }
+
+    deltaSteppingFindPrevious(deltaStepping, thread, task->threadNumber);
+    return NULL;
+}
+
+
+/*
+ * Function: deltaSteppingEmptyBucket
+ * ----------------------------------
+ * Empties the bucket until no thread adds to it again.
+ * Each time round every thread swaps its bin of the
+ * bucket for its empty current bin, then takes an equal
+ * share of the entries across all the current bins,
+ * counted in thread order. A vertex whose distance still
+ * matches its entry has the light roads from it relaxed
+ * and, the first time in this bucket, is kept for its
+ * heavy roads. Entries of a later bucket sharing the bin
+ * are deferred until the bucket is empty. The second
+ * barrier stops a thread swapping its current bin while
+ * others still read it. In MAXIMUM_BUCKET every road is
+ * light, as a heavy road from it leads back into it.
+ */
+void deltaSteppingEmptyBucket(DeltaStepping* deltaStepping, DeltaThread* thread, int threadNumber, int64_t bucket){
+
+    const int* offsets = csrGraphGetOffsets(deltaStepping->csrGraph);
+    const int* targets = csrGraphGetTargets(deltaStepping->csrGraph);
+    const Weight* distances = csrGraphGetDistances(deltaStepping->csrGraph);
+    Distance* distanceFromSource = deltaStepping->distanceFromSource;
+    int numberOfThreads = deltaStepping->numberOfThreads;
+    int delta = deltaStepping->delta;
+    Distance lightBelow = bucket == MAXIMUM_BUCKET ? DISTANCE_INFINITY : delta;
+    DeltaBin* bin = &thread->bins[bucket & (deltaStepping->numberOfBins - 1)];
+    DeltaBin swap;
+
+    int i;
+    int j;
+    while(1){
+
+        thread->current.size = 0;
+        if(bin->size > 0){
+            swap = thread->current;
+            thread->current = *bin;
+            *bin = swap;
+            bin->lowestBucket = NO_BUCKET;
+            thread->numberOfEntries -= thread->current.size;
+        }
+        pthread_barrier_wait(&deltaStepping->barrier);
+
+        long total = 0;
+        for(i = 0; i < numberOfThreads; i++){
+            total += deltaStepping->threads[i].current.size;
+        }
+        if(total == 0){
+            for(i = 0; i < thread->deferred.size; i++){
+                deltaSteppingAdd(deltaStepping, thread, thread->deferred.entries[i].vertexNumber,
+                                 thread->deferred.entries[i].distance);
+            }
+            thread->deferred.size = 0;
+            return;
+        }
+
+        // This thread's share, walked across the current bins in order
+        long position = total*threadNumber/numberOfThreads;
+        long end = total*(threadNumber + 1)/numberOfThreads;
+        long binStart = 0;
+        int owner = 0;
+
+        while(position < end){
+
+            DeltaBin* ownerBin = &deltaStepping->threads[owner].current;
+            if(position >= binStart + ownerBin->size){
+                binStart += ownerBin->size;
+                owner++;
+                continue;
+            }
+
+            int u = ownerBin->entries[position - binStart].vertexNumber;
+            Distance distanceOfU = ownerBin->entries[position - binStart].distance;
+            Distance distanceNow;
+            position++;
+
+            __atomic_load(&distanceFromSource[u], &distanceNow, __ATOMIC_RELAXED);
+            if(distanceNow != distanceOfU){
+                continue; // Added again with a shorter distance
+            }
+            if(deltaSteppingBucketOf(distanceOfU, delta) != bucket){
+                deltaBinPush(&thread->deferred, u, distanceOfU);
+                continue;
+            }
+            if(__atomic_exchange_n(&deltaStepping->lastBucket[u], bucket, __ATOMIC_RELAXED) != bucket){
+                if(thread->numberSettled == thread->settledCapacity){
+                    thread->settledCapacity = thread->settledCapacity == 0 ? INITIAL_BIN_CAPACITY : 2*thread->settledCapacity;
+                    thread->settled = realloc(thread->settled, thread->settledCapacity*sizeof(int));
+                    if(thread->settled == NULL){
+                        deltaSteppingOutOfMemory();
+                    }
+                }
+                thread->settled[thread->numberSettled++] = u;
+            }
+
+            for(j = offsets[u]; j < offsets[u + 1]; j++){
+                if(distances[j] < lightBelow){
+                    deltaSteppingRelax(deltaStepping, thread, targets[j], DISTANCE_ADD(distanceOfU, distances[j]));
+                }
+            }
+        }
+        pthread_barrier_wait(&deltaStepping->barrier);
+    }
+}
+
+
+/*
+ * Function: deltaSteppingRelax
+ * ----------------------------
+ * Lowers the distance of a vertex to distance if that is
+ * shorter, retrying if another thread changed it first,
+ * and if so adds the vertex to this thread's bins.
+ */
+void deltaSteppingRelax(DeltaStepping* deltaStepping, DeltaThread* thread, int vertexNumber, Distance distance){
+
+    Distance* distanceFromSource = deltaStepping->distanceFromSource;
+    Distance old;
+    __atomic_load(&distanceFromSource[vertexNumber], &old, __ATOMIC_RELAXED);
+
+    // The generic builtins work for any Distance, doubles included
+    while(distance < old){
+        // On failure old is set to the distance the other thread wrote
+        if(__atomic_compare_exchange(&distanceFromSource[vertexNumber], &old, &distance, 0,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+            deltaSteppingAdd(deltaStepping, thread, vertexNumber, distance);
+            return;
+        }
+    }
+}
+
+
+/*
+ * Function: deltaSteppingBucketOf
+ * -------------------------------
+ * Returns the bucket of a distance, worked out in the
+ * Distance type so it can not overflow. Distances past
+ * MAXIMUM_BUCKET buckets all share the last one.
+ */
+int64_t deltaSteppingBucketOf(Distance distance, int delta){
+
+    // Compared as doubles as an int Distance never gets there
+    if(distance >= (double)delta*MAXIMUM_BUCKET){
+        return MAXIMUM_BUCKET;
+    }
+    return (int64_t)(distance/delta);
+}
+
+
+/*
+ * Function: deltaSteppingAdd
+ * --------------------------
+ * Adds a vertex and its distance to this thread's bin of
+ * the bucket for that distance, which it shares with
+ * every bucket numberOfBins apart.
+ */
+void deltaSteppingAdd(DeltaStepping* deltaStepping, DeltaThread* thread, int vertexNumber, Distance distance){
+
+    int64_t bucket = deltaSteppingBucketOf(distance, deltaStepping->delta);
+    DeltaBin* bin = &thread->bins[bucket & (deltaStepping->numberOfBins - 1)];
+
+    deltaBinPush(bin, vertexNumber, distance);
+    thread->numberOfEntries++;
+    if(bucket < bin->lowestBucket){
+        bin->lowestBucket = bucket;
+    }
+}
+
+
+/*
+ * Function: deltaSteppingNextBucket
+ * ---------------------------------
+ * Returns the lowest bucket after the current one that
+ * this thread has entries in, or NO_BUCKET if it has
+ * none. Going once round the ring from the current
+ * bucket, a bin holding the bucket its place stands for
+ * is the answer. Otherwise the ring has wrapped and the
+ * lowest bucket kept by any bin is.
+ */
+int64_t deltaSteppingNextBucket(DeltaStepping* deltaStepping, DeltaThread* thread, int64_t bucket){
+
+    if(thread->numberOfEntries == 0){
+        return NO_BUCKET;
+    }
+
+    int numberOfBins = deltaStepping->numberOfBins;
+    int64_t lowest = NO_BUCKET;
+
+    int k;
+    for(k = 1; k <= numberOfBins; k++){
+        DeltaBin* bin = &thread->bins[(bucket + k) & (numberOfBins - 1)];
+        if(bin->size == 0){
+            continue;
+        }
+        if(bin->lowestBucket == bucket + k){
+            return bucket + k;
+        }
+        if(bin->lowestBucket < lowest){
+            lowest = bin->lowestBucket;
+        }
+    }
+    return lowest;
+}
+
+
+/*
+ * Function: deltaSteppingFindPrevious
+ * -----------------------------------
+ * For each vertex of this thread's share sets visited
+ * and picks the previous vertex out of its neighbours
+ * on a shortest route, preferring the one nearest the
+ * source and then the lowest vertex number. Counts the
+ * vertices reached.
+ */
+void deltaSteppingFindPrevious(DeltaStepping* deltaStepping, DeltaThread* thread, int threadNumber){
+
+    const int* offsets = csrGraphGetOffsets(deltaStepping->csrGraph);
+    const int* targets = csrGraphGetTargets(deltaStepping->csrGraph);
+    const Weight* distances = csrGraphGetDistances(deltaStepping->csrGraph);
+    const Distance* distanceFromSource = deltaStepping->distanceFromSource;
+    int numberOfCities = csrGraphGetNumberOfCities(deltaStepping->csrGraph);
+    int numberOfThreads = deltaStepping->numberOfThreads;
+
+    int first = (long)numberOfCities*threadNumber/numberOfThreads;
+    int last = (long)numberOfCities*(threadNumber + 1)/numberOfThreads;
+
+    thread->numberOfSettled = 0;
+
+    int v;
+    int j;
+    for(v = first; v < last; v++){
+
+        int best = -1;
+        deltaStepping->stamps[v] = deltaStepping->query;
+        deltaStepping->visited[v] = distanceFromSource[v] != DISTANCE_INFINITY;
+
+        if(distanceFromSource[v] != DISTANCE_INFINITY){
+            thread->numberOfSettled++;
+        }
+        if(v != deltaStepping->source && distanceFromSource[v] != DISTANCE_INFINITY){
+            for(j = offsets[v]; j < offsets[v + 1]; j++){
+                int u = targets[j];
+                if(distanceFromSource[u] != DISTANCE_INFINITY && DISTANCE_ADD(distanceFromSource[u], distances[j]) == distanceFromSource[v]
+                   && (best == -1 || distanceFromSource[u] < distanceFromSource[best]
+                       || (distanceFromSource[u] == distanceFromSource[best] && u < best))){
+                    best = u;
+                }
+            }
+        }
+        deltaStepping->previous[v] = best;
+    }
+}
+
+
+/*
+ * Function: deltaBinPush
+ * ----------------------
+ * Adds a vertex number and distance to the end of the
+ * bin, doubling it first if it is full.
+ */
+void deltaBinPush(DeltaBin* bin, int vertexNumber, Distance distance){
+
+    if(bin->size == bin->capacity){
+        bin->capacity = bin->capacity == 0 ? INITIAL_BIN_CAPACITY : 2*bin->capacity;
+        bin->entries = realloc(bin->entries, bin->capacity*sizeof(DeltaEntry));
+        if(bin->entries == NULL){
+            deltaSteppingOutOfMemory();
+        }
+    }
+    bin->entries[bin->size].vertexNumber = vertexNumber;
+    bin->entries[bin->size].distance = distance;
+    bin->size++;
+}
+
+
+/*
+ * Function: deltaSteppingOutOfMemory
+ * ----------------------------------
+ * Reports that a bin or the settled list could not grow
+ * and exits, as the other threads can not be told.
+ */
+void deltaSteppingOutOfMemory(void){
+
+    printf("\n#####################################\n");
+    printf("Error, out of memory in the\n");
+    printf("delta-stepping search.\n");
+    printf("#####################################\n\n");
+    exit(-1);
+}
@@ -0,0 +1,60 @@
+/*
+ * deltastepping.h
+ * ---------------
+ *
+ * The header file for deltastepping.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <csrgraph.h>
+#include <dijkstraworkspace.h>
+
+typedef struct DeltaStepping DeltaStepping;
+
+/*
+ * Function: deltaSteppingConstructor
+ * ----------------------------------
+ * Returns a pointer to a DeltaStepping that searches the
+ * CsrGraph on numberOfThreads threads, gathering vertices
+ * into buckets delta kilometres wide. A delta of zero or
+ * less is chosen from the graph's roads. The buckets are
+ * kept between runs, so later runs allocate nothing.
+ */
+DeltaStepping* deltaSteppingConstructor(CsrGraph* csrGraph, int numberOfThreads, int delta);
+
+
+/*
+ * Function: deltaSteppingDestructor
+ * ---------------------------------
+ * Frees the DeltaStepping and its buckets.
+ */
+void deltaSteppingDestructor(DeltaStepping* deltaStepping);
+
+
+/*
+ * Function: deltaSteppingGetDelta
+ * -------------------------------
+ * Returns the width of each bucket.
+ */
+int deltaSteppingGetDelta(DeltaStepping* deltaStepping);
+
+
+/*
+ * Function: deltaSteppingRun
+ * --------------------------
+ * Finds the shortest distance from source to every other
+ * vertex, the same as dijkstrasCsr(), and fills in the
+ * distanceFromSource, previous and visited arrays of the
+ * workspace and its number of settled vertices. Of two
+ * equally short routes to a vertex the one through the
+ * vertex nearer the source is kept, which is the one
+ * Dijkstra's settles first, and if they are as near the
+ * one through the lower vertex number. Threads do not
+ * change which routes are found.
+ */
+void deltaSteppingRun(DeltaStepping* deltaStepping, DijkstraWorkspace* workspace, int source);
+
+#endif
@@ -9,62 +9,69 @@
  * This file contains functions for calculating the shortest
  * path between a source Vertex and all other vertices of a
  * Graph using a minHeap to increase efficiency. Dijkstra's
- * shortest path algorithm is used and INT_MAX is used in place
- * of the infinite initial distance to all other Vertices. This
- * is not perfect and could be improved by changing from integer
- * distances to floats as +infinity can be represented in floats
- * or by using a flag variable. This might be implemented in a
- * future update.
+ * shortest path algorithm is used and DISTANCE_INFINITY is used
+ * in place of the infinite initial distance to all other Vertices,
+ * the largest Distance or for doubles +infinity itself, see
+ * weight.h. Routes are lengthened with DISTANCE_ADD so one too long
+ * for a Distance stops at DISTANCE_INFINITY rather than wrapping
+ * around to a short one. Distances, previous vertices and visited flags
+ * are written to a DijkstraWorkspace rather than the graph, so
+ * the graph is only read and can be shared between workspaces.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <dijkstras.h>
-#include <limits.h>
+#include <relaxkernel.h>
 
-
-#define STRING_SIZE 250 // Maximum length of string
+#define RELAX_KERNEL_MINIMUM_ROADS 8 // Measured, fewer roads are relaxed by the scalar kernel
 
 
 /*
  * Function: dijkstras
  * -------------------
- * Takes a filled Graph structure, resets all distancesFromSource
- * previous and notVisited variables in case of a previous run
- * and generates a minHeap of distances from source Vertex to all
- * other Vertices. Then runs through Dijkstra's algorithms to find
- * shortest path from source Vertex to all other Vertices and updates
- * information within the Graph Vertices.
+ * Takes a filled Graph structure, starts a new query of the
+ * workspace and adds the source Vertex to a minHeap. Then runs
+ * through Dijkstra's algorithms to find shortest path from source
+ * Vertex to all other Vertices and updates the workspace arrays,
+ * which are indexed by vertex number. Each other Vertex has its
+ * distanceFromSource, previous and notVisited entries reset and
+ * goes on the minHeap when an Edge first reaches it, rather than
+ * every Vertex being reset and added before the search starts, so
+ * entries left from a previous run cost nothing to get rid of and
+ * Vertices that can not be reached are never looked at. Their
+ * entries are not this query's, see dijkstraWorkspaceIsReached().
+ * Of two equally short routes the one through the
+ * Vertex settled first is kept, the nearer to the source, and if
+ * both are as near the one through the lower vertex number, so the
+ * routes do not depend on the order the minHeap keeps equal values.
  */
-void dijkstras(Graph* graph, MinHeap* minHeap, int source){
+void dijkstras(Graph* graph, DijkstraWorkspace* workspace, int source){
 
-    // Resetting Vertex variables for Dijkstra's in case of previous run through
-    vertexSetDistanceFromSource(graphGetVertex(graph, source), 0);
+    Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    int* previous = dijkstraWorkspaceGetPrevious(workspace);
+    char* visited = dijkstraWorkspaceGetVisited(workspace);
+    MinHeap* minHeap = dijkstraWorkspaceGetMinHeap(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
 
-    int i;
-    // For all Vertices in the graph
-    for(i = 0; i < graphGetNumberOfCities(graph); i++){
-        if(i != source){
-            // Setting distance to INT_MAX to play the role of infinite
-            // distance. If actual distances are over +2147483647 then
-            // this will break.
-            vertexSetDistanceFromSource(graphGetVertex(graph, i), INT_MAX);
-        }
-        vertexSetPrevious(graphGetVertex(graph, i), NULL);
-        vertexSetIsNotVisited(graphGetVertex(graph, i));
-        // Add newly set-up Vertex to minHeap.
-        minHeapEnqueue(minHeap, graphGetVertex(graph, i));
-    }
+    stamps[source] = query;
+    distanceFromSource[source] = 0;
+    previous[source] = -1;
+    visited[source] = 0;
+    minHeapEnqueue(minHeap, source, 0);
 
     while(!minHeapIsEmpty(minHeap)){
 
         Vertex* u;
-        Vertex* v;
-        int alternateRoute;
+        int uNumber;
+        int v;
+        Distance alternateRoute;
         Edge* edgeOfU;
 
         // Get the Vertex with shortest distance from source
-        u = minHeapDequeue(minHeap);
+        uNumber = minHeapDequeue(minHeap);
+        u = graphGetVertex(graph, uNumber);
 
         int j;
         // For all edges of the Vertex* u
@@ -73,28 +80,480 @@ void dijkstras(Graph* graph, MinHeap* minHeap, int source){
             // Retrieve the Edge pointer
             edgeOfU = vertexGetEdge(u, j);
 
-            // Retrieve the Vertex pointer the Edge connects with
-            v = edgeGetEndVertex(edgeOfU);
+            // Retrieve the number of the Vertex the Edge connects with
+            v = edgeGetEndVertexNumber(edgeOfU);
 
-            // If that Vertex's isVisted variable is set to zero
-            if(!(vertexIsVisited(v))){
+            // First time this query reaches the Vertex, setting distance
+            // to DISTANCE_INFINITY to play the role of infinite distance
+            if(stamps[v] != query){
+                stamps[v] = query;
+                distanceFromSource[v] = DISTANCE_INFINITY;
+                previous[v] = -1;
+                visited[v] = 0;
+            }
+
+            // If that Vertex has not been visited
+            if(!visited[v]){
 
-                alternateRoute = vertexGetDistanceFromSource(u) + edgeGetDistance(edgeOfU);
+                alternateRoute = DISTANCE_ADD(distanceFromSource[uNumber], edgeGetDistance(edgeOfU));
 
                 // If new shorter path found
-                if(alternateRoute < vertexGetDistanceFromSource(v)){
+                if(alternateRoute < distanceFromSource[v]){
+
+                    // Add newly reached Vertex to minHeap, or update it
+                    if(distanceFromSource[v] == DISTANCE_INFINITY){
+                        minHeapEnqueue(minHeap, v, alternateRoute);
+                    } else {
+                        minHeapDecreaseNodeValue(minHeap, v, alternateRoute);
+                    }
+                    distanceFromSource[v] = alternateRoute;
+                    previous[v] = uNumber;
+                } else if(alternateRoute == distanceFromSource[v] && alternateRoute != DISTANCE_INFINITY
+                          && distanceFromSource[uNumber] == distanceFromSource[previous[v]] && uNumber < previous[v]){
+                    // As short, through a vertex as near, keep the lower number
+                    previous[v] = uNumber;
+                }
+            }
+        }
+        visited[uNumber] = 1;
+    }
+}
+
+
+/*
+ * Function: dijkstrasCsr
+ * ----------------------
+ * The same algorithm as dijkstras but the edges of each vertex
+ * are read straight out of the contiguous offsets, targets and
+ * distances arrays of a CsrGraph rather than by following an Edge
+ * pointer and then the Edge's end Vertex pointer. Distances,
+ * previous vertices and visited flags are kept in the flat arrays
+ * of the workspace, so the only other memory touched per edge is
+ * the end vertex's entry in those arrays. Equally short routes are
+ * chosen between as in dijkstras(). Every vertex is still reset and
+ * stamped before the search, as the whole arrays are read afterwards
+ * and a search from one vertex reaches nearly all the others anyway.
+ */
+void dijkstrasCsr(CsrGraph* csrGraph, DijkstraWorkspace* workspace, int source){
+
+    // Arrays fetched once so the inner loop indexes them directly
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+    const Weight* distances = csrGraphGetDistances(csrGraph);
+    Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    int* previous = dijkstraWorkspaceGetPrevious(workspace);
+    char* visited = dijkstraWorkspaceGetVisited(workspace);
+    MinHeap* minHeap = dijkstraWorkspaceGetMinHeap(workspace);
+    RelaxKernelType relaxKernel = dijkstraWorkspaceGetRelaxKernel(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
+    int foundVertices[RELAX_KERNEL_BLOCK];
+    Distance foundRoutes[RELAX_KERNEL_BLOCK];
+    int numberFound;
+    int last;
+
+    int i;
+    // Resetting state for Dijkstra's in case of previous run through
+    for(i = 0; i < csrGraphGetNumberOfCities(csrGraph); i++){
+        stamps[i] = query;
+        distanceFromSource[i] = i == source ? 0 : DISTANCE_INFINITY;
+        previous[i] = -1;
+        visited[i] = 0;
+        minHeapEnqueue(minHeap, i, distanceFromSource[i]);
+    }
+
+    int numberOfSettled = 0;
+
+    while(!minHeapIsEmpty(minHeap)){
+
+        int u;
+        int v;
+        Distance alternateRoute;
+
+        // Get the vertex with shortest distance from source
+        u = minHeapDequeue(minHeap);
+
+        // The rest can not be reached
+        if(distanceFromSource[u] == DISTANCE_INFINITY){
+            minHeapClear(minHeap);
+            break;
+        }
+        numberOfSettled++;
+
+        int j;
+        int k;
+        // For all edges of vertex u, a block at a time, the kernel
+        // finding the vertices whose routes may have improved
+        for(j = offsets[u]; j < offsets[u + 1]; j += RELAX_KERNEL_BLOCK){
+
+            last = j + RELAX_KERNEL_BLOCK < offsets[u + 1] ? j + RELAX_KERNEL_BLOCK : offsets[u + 1];
+            numberFound = relaxKernelRun(offsets[u + 1] - offsets[u] < RELAX_KERNEL_MINIMUM_ROADS
+                                         ? RELAX_KERNEL_SCALAR : relaxKernel, targets, distances, j, last,
+                                         distanceFromSource[u], distanceFromSource, foundVertices, foundRoutes);
+
+            for(k = 0; k < numberFound; k++){
+
+                v = foundVertices[k];
+                alternateRoute = foundRoutes[k];
+
+                if(!visited[v]){
+
+                    // If new shorter path found
+                    if(alternateRoute < distanceFromSource[v]){
+
+                        distanceFromSource[v] = alternateRoute;
+                        previous[v] = u;
+                        minHeapDecreaseNodeValue(minHeap, v, alternateRoute);
+                    } else if(alternateRoute == distanceFromSource[v] && alternateRoute != DISTANCE_INFINITY
+                              && distanceFromSource[u] == distanceFromSource[previous[v]] && u < previous[v]){
+                        previous[v] = u;
+                    }
+                }
+            }
+        }
+        visited[u] = 1;
+    }
+
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+}
 
-                    // Update Vertex
-                    vertexSetDistanceFromSource(v, alternateRoute);
-                    vertexSetPrevious(v, u);
 
-                    // Update minHeap
-                    minHeapDecreaseNodeValue(minHeap, v);
+/*
+ * Function: dijkstrasCsrToTarget
+ * ------------------------------
+ * The same algorithm as dijkstrasCsr with two changes for
+ * when only one route is wanted. Vertices are only added to
+ * the minHeap when an edge first reaches them, a distance of
+ * DISTANCE_INFINITY meaning not reached yet, rather than every vertex
+ * being added at the start. And the search stops when the
+ * target is taken off the minHeap, as its distance can not
+ * get any shorter, leaving whatever is still on the minHeap
+ * to be cleared. Nor are vertices reset at the start, each
+ * being stamped with the workspace's query number and reset
+ * when an edge first reaches it, as in dijkstras(). Work is
+ * then only done for the vertices around the source out to
+ * the target's distance and the roads leaving them.
+ */
+Distance dijkstrasCsrToTarget(CsrGraph* csrGraph, DijkstraWorkspace* workspace, int source, int target){
+
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+    const Weight* distances = csrGraphGetDistances(csrGraph);
+    Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    int* previous = dijkstraWorkspaceGetPrevious(workspace);
+    char* visited = dijkstraWorkspaceGetVisited(workspace);
+    MinHeap* minHeap = dijkstraWorkspaceGetMinHeap(workspace);
+    RelaxKernelType relaxKernel = dijkstraWorkspaceGetRelaxKernel(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
+    int foundVertices[RELAX_KERNEL_BLOCK];
+    Distance foundRoutes[RELAX_KERNEL_BLOCK];
+    int numberFound;
+    int last;
+
+    int numberOfSettled = 0;
+
+    stamps[source] = query;
+    distanceFromSource[source] = 0;
+    previous[source] = -1;
+    visited[source] = 0;
+    minHeapEnqueue(minHeap, source, 0);
+
+    while(!minHeapIsEmpty(minHeap)){
+
+        int u;
+        int v;
+        Distance alternateRoute;
+
+        u = minHeapDequeue(minHeap);
+        visited[u] = 1;
+        numberOfSettled++;
+
+        if(u == target){
+            break;
+        }
+
+        int j;
+        int k;
+        // Reset the vertices first reached now, so the kernel
+        // reads DISTANCE_INFINITY rather than an earlier query's distance
+        for(j = offsets[u]; j < offsets[u + 1]; j++){
+            v = targets[j];
+            if(stamps[v] != query){
+                stamps[v] = query;
+                distanceFromSource[v] = DISTANCE_INFINITY;
+                previous[v] = -1;
+                visited[v] = 0;
+            }
+        }
+
+        for(j = offsets[u]; j < offsets[u + 1]; j += RELAX_KERNEL_BLOCK){
+
+            last = j + RELAX_KERNEL_BLOCK < offsets[u + 1] ? j + RELAX_KERNEL_BLOCK : offsets[u + 1];
+            numberFound = relaxKernelRun(offsets[u + 1] - offsets[u] < RELAX_KERNEL_MINIMUM_ROADS
+                                         ? RELAX_KERNEL_SCALAR : relaxKernel, targets, distances, j, last,
+                                         distanceFromSource[u], distanceFromSource, foundVertices, foundRoutes);
+
+            for(k = 0; k < numberFound; k++){
+
+                v = foundVertices[k];
+                alternateRoute = foundRoutes[k];
+
+                if(!visited[v] && alternateRoute < distanceFromSource[v]){
+
+                    // First time v is reached it goes on the minHeap
+                    if(distanceFromSource[v] == DISTANCE_INFINITY){
+                        minHeapEnqueue(minHeap, v, alternateRoute);
+                    } else {
+                        minHeapDecreaseNodeValue(minHeap, v, alternateRoute);
+                    }
+                    distanceFromSource[v] = alternateRoute;
+                    previous[v] = u;
                 }
             }
         }
-        vertexSetIsVisited(u);
     }
+
+    minHeapClear(minHeap);
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+    return stamps[target] == query ? distanceFromSource[target] : DISTANCE_INFINITY;
+}
+
+
+/*
+ * Function: dijkstrasCsrBidirectional
+ * -----------------------------------
+ * Runs a forward search from the source and a backward search
+ * from the target, each as in dijkstrasCsrToTarget, taking a
+ * vertex off whichever MinHeap has the smaller top value. Every
+ * road goes both ways so the backward search walks the same edges.
+ * When an edge reaches a vertex the other search has already
+ * reached, a route through that vertex is known and the shortest
+ * such route is kept. Once the two top values add up to at least that
+ * route's length no route still to be found can be shorter, so both
+ * searches stop. Each only has to reach about half way, which on a
+ * road graph settles around half the vertices a forward search from
+ * the source would. Finally the previous array is extended along
+ * the backward search's next array from the meeting vertex to the
+ * target, so the route can be written by dijkstrasCsrWriteToFile().
+ * A vertex's forward and backward entries are both reset the first
+ * time either search reaches it.
+ */
+Distance dijkstrasCsrBidirectional(CsrGraph* csrGraph, DijkstraWorkspace* workspace, int source, int target){
+
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+    const Weight* distances = csrGraphGetDistances(csrGraph);
+
+    // Index 0 is the forward search and index 1 the backward one
+    Distance* distance[2];
+    int* parent[2];
+    char* settled[2];
+    MinHeap* minHeap[2];
+
+    distance[0] = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    parent[0] = dijkstraWorkspaceGetPrevious(workspace);
+    settled[0] = dijkstraWorkspaceGetVisited(workspace);
+    minHeap[0] = dijkstraWorkspaceGetMinHeap(workspace);
+    distance[1] = dijkstraWorkspaceGetDistanceToTarget(workspace);
+    parent[1] = dijkstraWorkspaceGetNext(workspace);
+    settled[1] = dijkstraWorkspaceGetVisitedBackward(workspace);
+    minHeap[1] = dijkstraWorkspaceGetBackwardMinHeap(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
+
+    int i;
+    int end[2] = {source, target};
+    for(i = 0; i < 2; i++){
+        stamps[end[i]] = query;
+        distance[0][end[i]] = DISTANCE_INFINITY;
+        distance[1][end[i]] = DISTANCE_INFINITY;
+        parent[0][end[i]] = -1;
+        parent[1][end[i]] = -1;
+        settled[0][end[i]] = 0;
+        settled[1][end[i]] = 0;
+    }
+
+    int numberOfSettled = 0;
+    Distance bestDistance = source == target ? 0 : DISTANCE_INFINITY;
+    int meetingVertex = source == target ? source : -1;
+
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+    minHeapEnqueue(minHeap[0], source, 0);
+    minHeapEnqueue(minHeap[1], target, 0);
+
+    while(!minHeapIsEmpty(minHeap[0]) && !minHeapIsEmpty(minHeap[1])){
+
+        int side;
+        int other;
+        int u;
+        int v;
+        Distance alternateRoute;
+        Distance topForward = minHeapPeekValue(minHeap[0]);
+        Distance topBackward = minHeapPeekValue(minHeap[1]);
+
+        // Stopping criterion, the sum stopping at DISTANCE_INFINITY if too long
+        if(DISTANCE_ADD(topForward, topBackward) >= bestDistance){
+            break;
+        }
+
+        side = topForward <= topBackward ? 0 : 1;
+        other = 1 - side;
+
+        u = minHeapDequeue(minHeap[side]);
+        settled[side][u] = 1;
+        numberOfSettled++;
+
+        int j;
+        for(j = offsets[u]; j < offsets[u + 1]; j++){
+
+            v = targets[j];
+
+            if(stamps[v] != query){
+                stamps[v] = query;
+                distance[0][v] = DISTANCE_INFINITY;
+                distance[1][v] = DISTANCE_INFINITY;
+                parent[0][v] = -1;
+                parent[1][v] = -1;
+                settled[0][v] = 0;
+                settled[1][v] = 0;
+            }
+
+            if(!settled[side][v]){
+
+                alternateRoute = DISTANCE_ADD(distance[side][u], distances[j]);
+
+                if(alternateRoute < distance[side][v]){
+
+                    if(distance[side][v] == DISTANCE_INFINITY){
+                        minHeapEnqueue(minHeap[side], v, alternateRoute);
+                    } else {
+                        minHeapDecreaseNodeValue(minHeap[side], v, alternateRoute);
+                    }
+                    distance[side][v] = alternateRoute;
+                    parent[side][v] = u;
+                }
+            }
+
+            // Route through v if both searches have reached it
+            if(distance[other][v] != DISTANCE_INFINITY){
+                alternateRoute = DISTANCE_ADD(distance[side][v], distance[other][v]);
+                if(alternateRoute < bestDistance){
+                    bestDistance = alternateRoute;
+                    meetingVertex = v;
+                }
+            }
+        }
+    }
+
+    minHeapClear(minHeap[0]);
+    minHeapClear(minHeap[1]);
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+
+    // Join the two halves of the route at the meeting vertex
+    if(meetingVertex != -1){
+        for(i = meetingVertex; i != target; i = parent[1][i]){
+            parent[0][parent[1][i]] = i;
+        }
+        distance[0][target] = bestDistance;
+    }
+    return bestDistance;
+}
+
+
+/*
+ * Function: dijkstrasCsrAlt
+ * -------------------------
+ * The same search as dijkstrasCsrToTarget except that each vertex
+ * goes on the minHeap with its distance from the source plus the
+ * lower bound from the Landmarks on its distance to the target, so
+ * the vertex taken off next is the one whose best possible route to
+ * the target is shortest. This is A* search. The bound never falls by
+ * more than the length of a road along that road, as it comes from
+ * the triangle inequality, so a vertex still has its shortest
+ * distance when taken off and the search can stop at the target just
+ * the same. Vertices leading away from the target get larger values
+ * and are mostly never taken off at all. A vertex the Landmarks show
+ * can not reach the target is never added, and if that is the source
+ * the search ends at once. Vertices are reset when first reached, as
+ * in dijkstrasCsrToTarget().
+ */
+Distance dijkstrasCsrAlt(CsrGraph* csrGraph, DijkstraWorkspace* workspace, Landmarks* landmarks, int source, int target){
+
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+    const Weight* distances = csrGraphGetDistances(csrGraph);
+    Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    int* previous = dijkstraWorkspaceGetPrevious(workspace);
+    char* visited = dijkstraWorkspaceGetVisited(workspace);
+    MinHeap* minHeap = dijkstraWorkspaceGetMinHeap(workspace);
+    unsigned int* stamps = dijkstraWorkspaceGetStamps(workspace);
+    unsigned int query = dijkstraWorkspaceStartQuery(workspace);
+
+    int numberOfSettled = 0;
+    Distance lowerBound = landmarksGetLowerBound(landmarks, source, target);
+
+    stamps[source] = query;
+    distanceFromSource[source] = 0;
+    previous[source] = -1;
+    visited[source] = 0;
+    if(lowerBound != DISTANCE_INFINITY){
+        minHeapEnqueue(minHeap, source, lowerBound);
+    }
+
+    while(!minHeapIsEmpty(minHeap)){
+
+        int u;
+        int v;
+        Distance alternateRoute;
+
+        u = minHeapDequeue(minHeap);
+        visited[u] = 1;
+        numberOfSettled++;
+
+        if(u == target){
+            break;
+        }
+
+        int j;
+        for(j = offsets[u]; j < offsets[u + 1]; j++){
+
+            v = targets[j];
+
+            if(stamps[v] != query){
+                stamps[v] = query;
+                distanceFromSource[v] = DISTANCE_INFINITY;
+                previous[v] = -1;
+                visited[v] = 0;
+            }
+
+            if(!visited[v]){
+
+                alternateRoute = DISTANCE_ADD(distanceFromSource[u], distances[j]);
+
+                if(alternateRoute < distanceFromSource[v]){
+
+                    lowerBound = landmarksGetLowerBound(landmarks, v, target);
+                    if(lowerBound == DISTANCE_INFINITY){
+                        continue;
+                    }
+
+                    if(distanceFromSource[v] == DISTANCE_INFINITY){
+                        minHeapEnqueue(minHeap, v, DISTANCE_ADD(alternateRoute, lowerBound));
+                    } else {
+                        minHeapDecreaseNodeValue(minHeap, v, DISTANCE_ADD(alternateRoute, lowerBound));
+                    }
+                    distanceFromSource[v] = alternateRoute;
+                    previous[v] = u;
+                }
+            }
+        }
+    }
+
+    minHeapClear(minHeap);
+    dijkstraWorkspaceSetNumberOfSettled(workspace, numberOfSettled);
+    return stamps[target] == query ? distanceFromSource[target] : DISTANCE_INFINITY;
 }
 
 
@@ -103,89 +562,154 @@ void dijkstras(Graph* graph, MinHeap* minHeap, int source){
  * ------------------------------
  * Prints out the complete shortest path information.
  * Distance from source Vertex to all other Vertices and
- * all Vertices previous Vertex.
+ * all Vertices previous Vertex. Vertices the search did
+ * not reach are printed with DISTANCE_INFINITY and no
+ * previous.
  */
-void dijkstrasPrintResult(Graph* graph){
+void dijkstrasPrintResult(Graph* graph, DijkstraWorkspace* workspace){
+
+    Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    int* previous = dijkstraWorkspaceGetPrevious(workspace);
 
     printf("%-10s%-20s%-20s%-20s\n", "Vertex", "CityName", "Distance", "Previous");
     printf("%41s\n\n", "From Source");
 
-    Vertex* vertex;
-
     int i;
     for(i = 0; i < graphGetNumberOfCities(graph); i++){
-        vertex = graphGetVertex(graph, i);
+
+        // If not reached
+        if(!dijkstraWorkspaceIsReached(workspace, i)){
+            printf("%-10d%-20s%-10" DISTANCE_FORMAT "%20s\n", i, vertexGetCityName(graphGetVertex(graph, i)),
+                   (Distance)DISTANCE_INFINITY, "----------");
 
         // If source Vertex
-        if(vertexGetDistanceFromSource(graphGetVertex(graph, i)) == 0){
+        } else if(previous[i] == -1){
             // Prints slightly different output as has no previous Vertex
-            printf("%-10d%-20s%-10d%20s\n", i, vertexGetCityName(vertex),
-                   vertexGetDistanceFromSource(vertex), "----------");
+            printf("%-10d%-20s%-10" DISTANCE_FORMAT "%20s\n", i, vertexGetCityName(graphGetVertex(graph, i)),
+                   distanceFromSource[i], "----------");
 
         } else {
-            printf("%-10d%-20s%-20d%-20s\n", i, vertexGetCityName(vertex),
-                   vertexGetDistanceFromSource(vertex), vertexGetPreviousCityName(vertex));
+            printf("%-10d%-20s%-20" DISTANCE_FORMAT "%-20s\n", i, vertexGetCityName(graphGetVertex(graph, i)),
+                   distanceFromSource[i], vertexGetCityName(graphGetVertex(graph, previous[i])));
         }
     }
     printf("\n");
 }
 
 
+/*
+ * Function: dijkstrasTraceRoute
+ * -----------------------------
+ * Follows the previous array back from the destination,
+ * storing each vertex number in route, and returns how
+ * many there are. route[0] is the destination and the
+ * last entry the source.
+ */
+int dijkstrasTraceRoute(const int* previous, int destinationVertexNumber, int* route){
+
+    int count = 0;
+    int i;
+
+    for(i = destinationVertexNumber; i != -1; i = previous[i]){
+        route[count] = i;
+        count++;
+    }
+    return count;
+}
+
+
 /*
  * Function: dijkstrasWriteToFile
  * ------------------------------
  * Writes the distance from source to destination Vertex
  * and the route taken to get there into a file. Because
  * the route taken is worked out backwards from destination
- * to source via previously pointers, initially it stores the
- * previous cityNames in a new Char** array and then runs through
- * that array backwards to print the journey in the correct
- * direction from Source to Destination.
+ * to source via the previous array, the vertex numbers are
+ * stored in an array and printed from the end to show the
+ * journey in the correct direction from Source to Destination.
+ * If the search did not reach the destination the distance
+ * is DISTANCE_INFINITY and the route only the destination.
  */
- void dijkstrasWriteToFile(Graph* graph, FILE* output, int sourceVertexNumber, int destinationVertexNumber){
-
-    // Temp variables used to increase readability
-    char* sourceName = vertexGetCityName(graphGetVertex(graph, sourceVertexNumber));
-    char* destinationName = vertexGetCityName(graphGetVertex(graph, destinationVertexNumber));
-    int distanceFromSource = vertexGetDistanceFromSource(graphGetVertex(graph, destinationVertexNumber));
-
-    // Stores route in reverse
-    char** routeCityNames = malloc(sizeof(char*));
-    routeCityNames[0] = malloc(STRING_SIZE*sizeof(char));
-    routeCityNames[0] = destinationName;
+void dijkstrasWriteToFile(Graph* graph, DijkstraWorkspace* workspace, FILE* output,
+                          int sourceVertexNumber, int destinationVertexNumber){
 
+    int reached = dijkstraWorkspaceIsReached(workspace, destinationVertexNumber);
 
-    fprintf(output, "%s to %s is %dkm\n\n", sourceName, destinationName, distanceFromSource);
+    fprintf(output, "%s to %s is %" DISTANCE_FORMAT "km\n\n", vertexGetCityName(graphGetVertex(graph, sourceVertexNumber)),
+            vertexGetCityName(graphGetVertex(graph, destinationVertexNumber)),
+            reached ? dijkstraWorkspaceGetDistanceFromSource(workspace)[destinationVertexNumber] : DISTANCE_INFINITY);
     fprintf(output, "Route:\n");
 
-    int i = destinationVertexNumber;
+    // Route can not visit more vertices than there are
+    int* route = malloc(graphGetNumberOfCities(graph)*sizeof(int));
     int count = 1;
+    int i;
 
-    // While previous Vertex* is not NULL e.g Not the Source Vertex
-    while(vertexGetPrevious(graphGetVertex(graph, i)) != NULL){
-        // Increase size of routeCityNames array
-        routeCityNames = realloc(routeCityNames, (count + 1)*sizeof(char*));
-        routeCityNames[count] = malloc(STRING_SIZE*sizeof(char));
-
-        // Add name of previous city to the list
-        routeCityNames[count] = vertexGetCityName(vertexGetPrevious(graphGetVertex(graph, i)));
-
-        // Update i with the vertexNumber of the previous city
-        i = vertexGetVertexNumber(vertexGetPrevious(graphGetVertex(graph, i)));
-        count++;
+    route[0] = destinationVertexNumber;
+    if(reached){
+        count = dijkstrasTraceRoute(dijkstraWorkspaceGetPrevious(workspace), destinationVertexNumber, route);
     }
 
     // Loop through route from Source
-    for(i = count - 1; i > 0 ; i--){
-        fprintf(output, "%s ---> ", routeCityNames[i]);
+    for(i = count - 1; i > 0; i--){
+        fprintf(output, "%s ---> ", vertexGetCityName(graphGetVertex(graph, route[i])));
     }
 
-    fprintf(output, "%s\n\n", routeCityNames[0]);
+    fprintf(output, "%s\n\n", vertexGetCityName(graphGetVertex(graph, route[0])));
     fprintf(output, "\n\n");
 
-    for(i = 0; i > count ; i++){
-        free(routeCityNames[i]);
+    free(route);
+}
+
+
+/*
+ * Function: dijkstrasCsrWriteRoute
+ * --------------------------------
+ * Writes the distance from the source to the first city
+ * of the route, the destination, then the names of the
+ * cities on the route starting from its last city.
+ */
+void dijkstrasCsrWriteRoute(CsrGraph* csrGraph, FILE* output, int sourceVertexNumber,
+                            const int* route, int count, Distance distance){
+
+    fprintf(output, "%s to %s is %" DISTANCE_FORMAT "km\n\n", csrGraphGetCityName(csrGraph, sourceVertexNumber),
+            csrGraphGetCityName(csrGraph, route[0]), distance);
+    fprintf(output, "Route:\n");
+
+    int i;
+    // Loop through route from Source
+    for(i = count - 1; i > 0; i--){
+        fprintf(output, "%s ---> ", csrGraphGetCityName(csrGraph, route[i]));
     }
-    free(routeCityNames);
+
+    fprintf(output, "%s\n\n", csrGraphGetCityName(csrGraph, route[0]));
+    fprintf(output, "\n\n");
 }
 
+
+/*
+ * Function: dijkstrasCsrWriteToFile
+ * ---------------------------------
+ * Same as dijkstrasWriteToFile but the city names
+ * are read from a CsrGraph.
+ */
+void dijkstrasCsrWriteToFile(CsrGraph* csrGraph, DijkstraWorkspace* workspace, FILE* output,
+                             int sourceVertexNumber, int destinationVertexNumber){
+
+    int reached = dijkstraWorkspaceIsReached(workspace, destinationVertexNumber);
+
+    // Route can not visit more vertices than there are
+    int* route = malloc(csrGraphGetNumberOfCities(csrGraph)*sizeof(int));
+    int count = 1;
+
+    route[0] = destinationVertexNumber;
+    if(reached){
+        count = dijkstrasTraceRoute(dijkstraWorkspaceGetPrevious(workspace), destinationVertexNumber, route);
+    }
+
+    dijkstrasCsrWriteRoute(csrGraph, output, sourceVertexNumber, route, count,
+                           reached ? dijkstraWorkspaceGetDistanceFromSource(workspace)[destinationVertexNumber]
+                                   : DISTANCE_INFINITY);
+
+    free(route);
+}
@@ -13,16 +13,70 @@
 #ifndef DIJKSTRAS_H
 #define DIJKSTRAS_H
 
-#include <minheap.h>
 #include <graph.h>
+#include <csrgraph.h>
+#include <dijkstraworkspace.h>
+#include <landmarks.h>
 
 /*
  * Function: dijkstras
  * -------------------
  * Calculates shortest path from source to all other Vertices
- * in the Graph.
+ * in the Graph. Results are stored in the workspace, which
+ * must be sized for the Graph. The Graph is not changed.
+ * Only the entries of Vertices the source can reach are
+ * written, dijkstraWorkspaceIsReached() tells which.
  */
-void dijkstras(Graph* graph, MinHeap* minHeap, int source);
+void dijkstras(Graph* graph, DijkstraWorkspace* workspace, int source);
+
+
+/*
+ * Function: dijkstrasCsr
+ * ----------------------
+ * Same as dijkstras but walks the edges of the compressed
+ * sparse row copy of the Graph.
+ */
+void dijkstrasCsr(CsrGraph* csrGraph, DijkstraWorkspace* workspace, int source);
+
+
+/*
+ * Function: dijkstrasCsrToTarget
+ * ------------------------------
+ * Finds the shortest path from source to a single target.
+ * Stops as soon as the target's distance is known, so only
+ * the vertices closer to the source than the target are
+ * searched. Returns the distance, or DISTANCE_INFINITY if
+ * the target can not be reached. Afterwards the workspace
+ * holds the route to the target for dijkstrasCsrWriteToFile(),
+ * but not the routes to every other vertex, and the entries
+ * of vertices it did not reach are left from earlier runs.
+ */
+Distance dijkstrasCsrToTarget(CsrGraph* csrGraph, DijkstraWorkspace* workspace, int source, int target);
+
+
+/*
+ * Function: dijkstrasCsrBidirectional
+ * -----------------------------------
+ * Same as dijkstrasCsrToTarget but searches from both the
+ * source and the target at once, meeting in the middle, so
+ * needs no preparation of the graph and settles fewer
+ * vertices on long routes. Afterwards the workspace holds
+ * the route for dijkstrasCsrWriteToFile().
+ */
+Distance dijkstrasCsrBidirectional(CsrGraph* csrGraph, DijkstraWorkspace* workspace, int source, int target);
+
+
+/*
+ * Function: dijkstrasCsrAlt
+ * -------------------------
+ * Same as dijkstrasCsrToTarget but searches towards the
+ * target first, guided by lower bounds on the distance
+ * left taken from the Landmarks, which must have been made
+ * for this CsrGraph. Finds the same distance while settling
+ * far fewer vertices. Afterwards the workspace holds the
+ * route for dijkstrasCsrWriteToFile().
+ */
+Distance dijkstrasCsrAlt(CsrGraph* csrGraph, DijkstraWorkspace* workspace, Landmarks* landmarks, int source, int target);
 
 
 /*
@@ -30,7 +84,7 @@ void dijkstras(Graph* graph, MinHeap* minHeap, int source);
  * ------------------------------
  * Prints out all distances and previous city names.
  */
-void dijkstrasPrintResult(Graph* graph);
+void dijkstrasPrintResult(Graph* graph, DijkstraWorkspace* workspace);
 
 
 /*
@@ -40,6 +94,41 @@ void dijkstrasPrintResult(Graph* graph);
  * destination city and route taken to get there to
  * a file.
  */
-void dijkstrasWriteToFile(Graph* graph, FILE* output, int sourceVertexNumber, int destinationVertexNumber);
+void dijkstrasWriteToFile(Graph* graph, DijkstraWorkspace* workspace, FILE* output,
+                          int sourceVertexNumber, int destinationVertexNumber);
+
+
+/*
+ * Function: dijkstrasTraceRoute
+ * -----------------------------
+ * Stores the vertex numbers of the route to a destination
+ * in route, from the destination back to the source, and
+ * returns how many there are. previous is the array of
+ * previous vertex numbers of a run, from its workspace or
+ * a TreeCache. route must have room for every vertex of
+ * the graph.
+ */
+int dijkstrasTraceRoute(const int* previous, int destinationVertexNumber, int* route);
+
+
+/*
+ * Function: dijkstrasCsrWriteRoute
+ * --------------------------------
+ * Writes a route from a source stored by dijkstrasTraceRoute()
+ * and its distance to a file in the same format as
+ * dijkstrasCsrWriteToFile().
+ */
+void dijkstrasCsrWriteRoute(CsrGraph* csrGraph, FILE* output, int sourceVertexNumber,
+                            const int* route, int count, Distance distance);
+
+
+/*
+ * Function: dijkstrasCsrWriteToFile
+ * ---------------------------------
+ * Same as dijkstrasWriteToFile but for the
+ * results of dijkstrasCsr().
+ */
+void dijkstrasCsrWriteToFile(CsrGraph* csrGraph, DijkstraWorkspace* workspace, FILE* output,
+                             int sourceVertexNumber, int destinationVertexNumber);
 
 #endif
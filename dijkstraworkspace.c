@@ -0,0 +1,305 @@
+/*
+ * dijkstraworkspace.c
+ * -------------------
+ *
+ * This file contains the functions for the DijkstraWorkspace
+ * abstract data type. A DijkstraWorkspace holds everything a run
+ * of Dijkstra's algorithm writes to: the distance from the source,
+ * previous vertex and visited flag of every vertex, each kept in
+ * its own flat array indexed by vertex number, and the MinHeap.
+ * Keeping this out of the graph means the graph is only ever read
+ * once it is loaded, so queries running at the same time can share
+ * one graph as long as each has its own workspace. The arrays of a
+ * query are also packed together instead of spread through the
+ * graph's vertices. A bidirectional search also needs a second
+ * set of arrays and MinHeap for its backward half, these are only
+ * malloced by the first bidirectional search to use the workspace.
+ *
+ * A search between two cities only reaches the vertices around
+ * them, so rather than every entry being reset before each run,
+ * which would take longer than the search itself on a large graph,
+ * each vertex has a stamp holding the number of the last run to
+ * reach it. A run takes the next number and resets a vertex's
+ * entries the first time it reaches it, any other vertex's being
+ * treated as unreached. Only when the numbers wrap around are the
+ * stamps cleared, one pass over them every four billion runs.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <dijkstraworkspace.h>
+
+typedef struct DijkstraWorkspace{
+
+    int numberOfCities;
+
+    Distance* distanceFromSource;
+    int* previous; // Previous vertex number on route, -1 for none
+    char* visited;
+
+    MinHeap* minHeap;
+
+    unsigned int* stamps; // Query number that last reached each vertex
+    unsigned int query; // Number of the current run, 0 before the first
+
+    // Backward half of a bidirectional search, NULL until used
+    Distance* distanceToTarget;
+    int* next; // Next vertex number on route, -1 for none
+    char* visitedBackward;
+    MinHeap* backwardMinHeap;
+
+    int numberOfSettled;
+
+    RelaxKernelType relaxKernel;
+
+} DijkstraWorkspace;
+
+
+// Internal function declarations
+void dijkstraWorkspaceAllocateBackward(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceConstructor
+ * --------------------------------------
+ * Mallocs one entry per vertex in each array and
+ * constructs an empty MinHeap with room for every
+ * vertex, so searches never allocate. Every stamp
+ * starts at 0, which no run is numbered. Picks the
+ * relax kernel for the processor.
+ */
+DijkstraWorkspace* dijkstraWorkspaceConstructor(int numberOfCities, MinHeapType heapType){
+
+    DijkstraWorkspace* newWorkspace = malloc(sizeof(DijkstraWorkspace));
+
+    newWorkspace->numberOfCities = numberOfCities;
+    newWorkspace->distanceFromSource = malloc(numberOfCities*sizeof(Distance));
+    newWorkspace->previous = malloc(numberOfCities*sizeof(int));
+    newWorkspace->visited = malloc(numberOfCities*sizeof(char));
+    newWorkspace->minHeap = minHeapConstructor(heapType);
+    minHeapReserve(newWorkspace->minHeap, numberOfCities);
+    newWorkspace->stamps = calloc(numberOfCities, sizeof(unsigned int));
+    newWorkspace->query = 0;
+    newWorkspace->distanceToTarget = NULL;
+    newWorkspace->next = NULL;
+    newWorkspace->visitedBackward = NULL;
+    newWorkspace->backwardMinHeap = NULL;
+    newWorkspace->numberOfSettled = 0;
+    newWorkspace->relaxKernel = relaxKernelDetect();
+
+    return newWorkspace;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceDestructor
+ * -------------------------------------
+ * Frees the arrays, MinHeap and DijkstraWorkspace.
+ */
+void dijkstraWorkspaceDestructor(DijkstraWorkspace* workspace){
+
+    free(workspace->distanceFromSource);
+    free(workspace->previous);
+    free(workspace->visited);
+    minHeapDestructor(workspace->minHeap);
+    free(workspace->stamps);
+
+    if(workspace->backwardMinHeap != NULL){
+        free(workspace->distanceToTarget);
+        free(workspace->next);
+        free(workspace->visitedBackward);
+        minHeapDestructor(workspace->backwardMinHeap);
+    }
+    free(workspace);
+}
+
+
+/*
+ * Function: dijkstraWorkspaceAllocateBackward
+ * -------------------------------------------
+ * Mallocs the backward arrays and a MinHeap of the
+ * same type as the forward one if they have not been
+ * already.
+ */
+void dijkstraWorkspaceAllocateBackward(DijkstraWorkspace* workspace){
+
+    if(workspace->backwardMinHeap == NULL){
+        workspace->distanceToTarget = malloc(workspace->numberOfCities*sizeof(Distance));
+        workspace->next = malloc(workspace->numberOfCities*sizeof(int));
+        workspace->visitedBackward = malloc(workspace->numberOfCities*sizeof(char));
+        workspace->backwardMinHeap = minHeapConstructor(minHeapGetType(workspace->minHeap));
+        minHeapReserve(workspace->backwardMinHeap, workspace->numberOfCities);
+    }
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetNumberOfCities
+ * --------------------------------------------
+ * Returns the number of vertices.
+ */
+int dijkstraWorkspaceGetNumberOfCities(DijkstraWorkspace* workspace){
+    return workspace->numberOfCities;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetDistanceFromSource
+ * ------------------------------------------------
+ * Returns the array of distances from the source.
+ */
+Distance* dijkstraWorkspaceGetDistanceFromSource(DijkstraWorkspace* workspace){
+    return workspace->distanceFromSource;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetPrevious
+ * --------------------------------------
+ * Returns the array of previous vertex numbers.
+ */
+int* dijkstraWorkspaceGetPrevious(DijkstraWorkspace* workspace){
+    return workspace->previous;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetVisited
+ * -------------------------------------
+ * Returns the array of visited flags.
+ */
+char* dijkstraWorkspaceGetVisited(DijkstraWorkspace* workspace){
+    return workspace->visited;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetMinHeap
+ * -------------------------------------
+ * Returns the MinHeap.
+ */
+MinHeap* dijkstraWorkspaceGetMinHeap(DijkstraWorkspace* workspace){
+    return workspace->minHeap;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceStartQuery
+ * -------------------------------------
+ * Moves on to the next query number, clearing the
+ * stamps if it has wrapped around to 0 so no vertex
+ * looks reached by the new run.
+ */
+unsigned int dijkstraWorkspaceStartQuery(DijkstraWorkspace* workspace){
+
+    workspace->query++;
+    if(workspace->query == 0){
+        memset(workspace->stamps, 0, workspace->numberOfCities*sizeof(unsigned int));
+        workspace->query = 1;
+    }
+    return workspace->query;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetStamps
+ * ------------------------------------
+ * Returns the array of stamps.
+ */
+unsigned int* dijkstraWorkspaceGetStamps(DijkstraWorkspace* workspace){
+    return workspace->stamps;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceIsReached
+ * ------------------------------------
+ * Compares the vertex's stamp with the current query.
+ */
+int dijkstraWorkspaceIsReached(DijkstraWorkspace* workspace, int vertexNumber){
+    return workspace->stamps[vertexNumber] == workspace->query;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetDistanceToTarget
+ * ----------------------------------------------
+ * Returns the array of distances to the target.
+ */
+Distance* dijkstraWorkspaceGetDistanceToTarget(DijkstraWorkspace* workspace){
+    dijkstraWorkspaceAllocateBackward(workspace);
+    return workspace->distanceToTarget;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetNext
+ * ----------------------------------
+ * Returns the array of next vertex numbers.
+ */
+int* dijkstraWorkspaceGetNext(DijkstraWorkspace* workspace){
+    dijkstraWorkspaceAllocateBackward(workspace);
+    return workspace->next;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetVisitedBackward
+ * ---------------------------------------------
+ * Returns the array of backward visited flags.
+ */
+char* dijkstraWorkspaceGetVisitedBackward(DijkstraWorkspace* workspace){
+    dijkstraWorkspaceAllocateBackward(workspace);
+    return workspace->visitedBackward;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetBackwardMinHeap
+ * ---------------------------------------------
+ * Returns the backward MinHeap.
+ */
+MinHeap* dijkstraWorkspaceGetBackwardMinHeap(DijkstraWorkspace* workspace){
+    dijkstraWorkspaceAllocateBackward(workspace);
+    return workspace->backwardMinHeap;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetNumberOfSettled
+ * ---------------------------------------------
+ * Returns the number of vertices settled.
+ */
+int dijkstraWorkspaceGetNumberOfSettled(DijkstraWorkspace* workspace){
+    return workspace->numberOfSettled;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceSetNumberOfSettled
+ * ---------------------------------------------
+ * Sets the number of vertices settled.
+ */
+void dijkstraWorkspaceSetNumberOfSettled(DijkstraWorkspace* workspace, int numberOfSettled){
+    workspace->numberOfSettled = numberOfSettled;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceGetRelaxKernel
+ * -----------------------------------------
+ * Returns the relax kernel.
+ */
+RelaxKernelType dijkstraWorkspaceGetRelaxKernel(DijkstraWorkspace* workspace){
+    return workspace->relaxKernel;
+}
+
+
+/*
+ * Function: dijkstraWorkspaceSetRelaxKernel
+ * -----------------------------------------
+ * Sets the relax kernel.
+ */
+void dijkstraWorkspaceSetRelaxKernel(DijkstraWorkspace* workspace, RelaxKernelType relaxKernel){
+    workspace->relaxKernel = relaxKernel;
+}
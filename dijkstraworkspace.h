@@ -0,0 +1,188 @@
+/*
+ * dijkstraworkspace.h
+ * -------------------
+ *
+ * The header file for dijkstraworkspace.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef DIJKSTRAWORKSPACE_H
+#define DIJKSTRAWORKSPACE_H
+
+#include <minheap.h>
+#include <relaxkernel.h>
+
+typedef struct DijkstraWorkspace DijkstraWorkspace;
+
+/*
+ * Function: dijkstraWorkspaceConstructor
+ * --------------------------------------
+ * Constructs a DijkstraWorkspace big enough for a graph
+ * of numberOfCities vertices, whose MinHeaps are of type
+ * heapType, and returns a pointer to it. One is needed
+ * for each query run at the same time.
+ */
+DijkstraWorkspace* dijkstraWorkspaceConstructor(int numberOfCities, MinHeapType heapType);
+
+
+/*
+ * Function: dijkstraWorkspaceDestructor
+ * -------------------------------------
+ * Frees the DijkstraWorkspace, its arrays and its MinHeap.
+ */
+void dijkstraWorkspaceDestructor(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetNumberOfCities
+ * --------------------------------------------
+ * Returns the number of vertices the arrays are sized for.
+ */
+int dijkstraWorkspaceGetNumberOfCities(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetDistanceFromSource
+ * ------------------------------------------------
+ * Returns the array of distances from the source of the
+ * last run, indexed by vertex number. Only the entries of
+ * vertices the run reached are its own, the rest are left
+ * from earlier runs, see dijkstraWorkspaceIsReached().
+ */
+Distance* dijkstraWorkspaceGetDistanceFromSource(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetPrevious
+ * --------------------------------------
+ * Returns the array of previous vertex numbers on the
+ * route from the source of the last run, -1 for the
+ * source itself.
+ */
+int* dijkstraWorkspaceGetPrevious(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetVisited
+ * -------------------------------------
+ * Returns the array of visited flags.
+ */
+char* dijkstraWorkspaceGetVisited(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetMinHeap
+ * -------------------------------------
+ * Returns the MinHeap used by the runs.
+ */
+MinHeap* dijkstraWorkspaceGetMinHeap(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceStartQuery
+ * -------------------------------------
+ * Starts a new run and returns its query number. A vertex's
+ * entries in the arrays, forward and backward, only belong
+ * to the run if its stamp equals the query number, so a run
+ * stamps each vertex and resets its entries when it first
+ * reaches it instead of resetting every vertex before it
+ * starts. Once in about four billion runs the numbers wrap
+ * around and every stamp is cleared.
+ */
+unsigned int dijkstraWorkspaceStartQuery(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetStamps
+ * ------------------------------------
+ * Returns the array of query numbers each vertex was last
+ * reached by, indexed by vertex number.
+ */
+unsigned int* dijkstraWorkspaceGetStamps(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceIsReached
+ * ------------------------------------
+ * Returns 1 if the last run reached the vertex, so its
+ * entries hold that run's values, or 0 if they are left
+ * from an earlier run and it is as if its distance from
+ * the source were DISTANCE_INFINITY and it had no previous
+ * vertex.
+ */
+int dijkstraWorkspaceIsReached(DijkstraWorkspace* workspace, int vertexNumber);
+
+
+/*
+ * Function: dijkstraWorkspaceGetDistanceToTarget
+ * ----------------------------------------------
+ * Returns the array of distances to the target found by
+ * the backward half of a bidirectional search. This and
+ * the other backward arrays are only malloced the first
+ * time one of them is asked for.
+ */
+Distance* dijkstraWorkspaceGetDistanceToTarget(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetNext
+ * ----------------------------------
+ * Returns the array of next vertex numbers on the route
+ * to the target found by a backward search, -1 for the
+ * target itself.
+ */
+int* dijkstraWorkspaceGetNext(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetVisitedBackward
+ * ---------------------------------------------
+ * Returns the array of visited flags of a backward search.
+ */
+char* dijkstraWorkspaceGetVisitedBackward(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetBackwardMinHeap
+ * ---------------------------------------------
+ * Returns the MinHeap used by a backward search.
+ */
+MinHeap* dijkstraWorkspaceGetBackwardMinHeap(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceGetNumberOfSettled
+ * ---------------------------------------------
+ * Returns how many vertices the last search took off its
+ * MinHeaps, the usual measure of how much work it did.
+ */
+int dijkstraWorkspaceGetNumberOfSettled(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceSetNumberOfSettled
+ * ---------------------------------------------
+ * Records how many vertices a search settled.
+ */
+void dijkstraWorkspaceSetNumberOfSettled(DijkstraWorkspace* workspace, int numberOfSettled);
+
+
+/*
+ * Function: dijkstraWorkspaceGetRelaxKernel
+ * -----------------------------------------
+ * Returns the kernel searches relax the roads of busy
+ * vertices with, the fastest the processor supports
+ * unless set otherwise.
+ */
+RelaxKernelType dijkstraWorkspaceGetRelaxKernel(DijkstraWorkspace* workspace);
+
+
+/*
+ * Function: dijkstraWorkspaceSetRelaxKernel
+ * -----------------------------------------
+ * Chooses the kernel, for example to compare them. The
+ * processor must support it.
+ */
+void dijkstraWorkspaceSetRelaxKernel(DijkstraWorkspace* workspace, RelaxKernelType relaxKernel);
+
+#endif
@@ -0,0 +1,724 @@
+/*
+ * distancematrix.c
+ * ----------------
+ *
+ * This file contains the functions for the DistanceMatrix abstract
+ * data type, the shortest distance between every pair of vertices.
+ * Row s holds the distances from vertex s, so the distance from s
+ * to t is at distances[s*numberOfCities + t]. DISTANCE_INFINITY
+ * marks a pair with no route. Optionally a second matrix of the
+ * same shape holds the vertex before t on the route from s, -1 on
+ * the diagonal and for pairs with no route, which is the previous
+ * array of a run of Dijkstra's from s.
+ *
+ * Usually the matrix is found one row at a time by running
+ * Dijkstra's from every vertex. The rows do not depend on each
+ * other so the sources are shared out between threads, each with
+ * its own DijkstraWorkspace reading the same CsrGraph and writing
+ * only its own rows. When the graph is small or dense enough that
+ * V runs of Dijkstra's would take longer, a blocked Floyd-Warshall
+ * is used instead. The matrix is cut into tiles of
+ * FLOYD_WARSHALL_TILE_SIZE by FLOYD_WARSHALL_TILE_SIZE so the three
+ * tiles a step reads stay in the cache. Each round takes one
+ * diagonal pivot tile and updates it first, then the rest of its
+ * row and column of tiles, then every other tile, the tiles of the
+ * last two steps being shared out between threads.
+ *
+ * The matrix can be written to a file that any other program can
+ * map and read directly. The file starts with a MatrixHeader
+ * followed by
+ *
+ *     distances        numberOfCities*numberOfCities Distances
+ *     predecessors     numberOfCities*numberOfCities ints, if kept
+ *     originalNumbers  numberOfCities ints, if renumbered
+ *
+ * each starting on an 8 byte boundary recorded in the header. Rows
+ * and columns are in the numbering of the graph, so when the cities
+ * have been renumbered, see vertexorder.c, the last section gives the
+ * number each row's city was read as. The
+ * fingerprint of the graph is recorded so a matrix made for
+ * different roads, or for the cities numbered another way, is
+ * rejected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <distancematrix.h>
+#include <dijkstras.h>
+#include <dijkstraworkspace.h>
+#include <mappedfile.h>
+#include <threadrunner.h>
+
+#define DISTANCE_MATRIX_MAGIC "DJKAPSP" // 7 characters and the null-terminator
+#define BYTE_ORDER_MARK 0x01020304u
+#define SECTION_ALIGNMENT 8
+#define FLOYD_WARSHALL_STEPS_PER_HEAP_STEP 16 // Measured, see distanceMatrixConstructor()
+#define FLOYD_WARSHALL_TILE_SIZE 64
+
+typedef struct DistanceMatrix{
+
+    int numberOfCities;
+
+    const Distance* distances;
+    const int* predecessors; // NULL if not kept
+
+    // File the matrix is mapped from, or NULL if it
+    // was malloced by distanceMatrixConstructor()
+    MappedFile* mappedFile;
+
+} DistanceMatrix;
+
+
+typedef struct MatrixHeader{
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark; // Reads back differently on the other byte order
+    uint32_t intSize;
+    uint32_t weightType; // WEIGHT_TYPE of the program that wrote it
+    uint32_t numberOfCities;
+    uint32_t numberOfEdges;
+    uint32_t hasPredecessors;
+    uint32_t reserved;
+    uint64_t distancesStart;
+    uint64_t predecessorsStart; // 0 if not kept
+    uint64_t originalNumbersStart; // 0 if never renumbered
+    uint64_t fileSize;
+    uint64_t graphFingerprint; // See csrGraphGetFingerprint()
+
+} MatrixHeader;
+
+
+typedef struct MatrixContext{
+
+    CsrGraph* csrGraph;
+    int numberOfCities;
+    Distance* distances;
+    int* predecessors;
+    int numberOfThreads;
+    MinHeapType heapType;
+
+    // Tiles per row of the matrix and the pivot
+    // tile of the current Floyd-Warshall round
+    int numberOfTiles;
+    int pivotTile;
+
+} MatrixContext;
+
+
+typedef struct MatrixTask{
+
+    MatrixContext* context;
+    int threadNumber;
+
+} MatrixTask;
+
+
+// Internal function declarations
+void runMatrixPass(MatrixContext* context, void* (*function)(void*));
+void* dijkstraRowsPass(void* argument);
+void floydWarshall(MatrixContext* context);
+void relaxTile(MatrixContext* context, int rowTile, int columnTile, int pivotTile);
+void relaxTileRow(Distance* restrict row, const Distance* restrict pivotRow, Distance toPivot, int width);
+void relaxTileRowWithPredecessors(Distance* restrict row, const Distance* restrict pivotRow, int* restrict rowPredecessors,
+                                  const int* restrict pivotPredecessors, Distance toPivot, int width);
+void* pivotCrossPass(void* argument);
+void* remainingTilesPass(void* argument);
+uint64_t distanceMatrixAlign(uint64_t position);
+void distanceMatrixError(const char* path, const char* reason);
+
+
+/*
+ * Function: distanceMatrixAlign
+ * -----------------------------
+ * Rounds a file position up to the next section boundary.
+ */
+uint64_t distanceMatrixAlign(uint64_t position){
+    return (position + SECTION_ALIGNMENT - 1) & ~(uint64_t)(SECTION_ALIGNMENT - 1);
+}
+
+
+/*
+ * Function: distanceMatrixError
+ * -----------------------------
+ * Reports a matrix file that can not be used and exits.
+ */
+void distanceMatrixError(const char* path, const char* reason){
+
+    printf("\n#####################################\n");
+    printf("Error, can not load distance matrix '%s'.\n", path);
+    printf("%s\n", reason);
+    printf("#####################################\n\n");
+    exit(-1);
+}
+
+
+/*
+ * Function: distanceMatrixConstructor
+ * -----------------------------------
+ * Allocates the matrices then fills them by whichever way
+ * should be quicker. Floyd-Warshall takes V^3 steps and
+ * the V runs of Dijkstra's about V*(V + E)*log2(V) steps
+ * of the minHeap, each of which costs about as much as
+ * FLOYD_WARSHALL_STEPS_PER_HEAP_STEP vectorised steps of
+ * Floyd-Warshall.
+ */
+DistanceMatrix* distanceMatrixConstructor(CsrGraph* csrGraph, int numberOfThreads, int withPredecessors,
+                                          MinHeapType heapType){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    size_t numberOfPairs = (size_t)numberOfCities*numberOfCities;
+
+    MatrixContext context;
+    context.csrGraph = csrGraph;
+    context.numberOfCities = numberOfCities;
+    context.distances = malloc((numberOfPairs > 0 ? numberOfPairs : 1)*sizeof(Distance));
+    context.predecessors = withPredecessors ? malloc((numberOfPairs > 0 ? numberOfPairs : 1)*sizeof(int)) : NULL;
+    context.numberOfThreads = numberOfThreads < 1 ? 1 : numberOfThreads;
+    context.heapType = heapType;
+
+    if(context.distances == NULL || (withPredecessors && context.predecessors == NULL)){
+        printf("\n#####################################\n");
+        printf("Error, not enough memory for a distance\n");
+        printf("matrix of %d cities.\n", numberOfCities);
+        printf("#####################################\n\n");
+        exit(-1);
+    }
+
+    int log2Cities = 1;
+    while((1L << log2Cities) < numberOfCities){
+        log2Cities++;
+    }
+
+    if((double)numberOfPairs <= (double)FLOYD_WARSHALL_STEPS_PER_HEAP_STEP*log2Cities
+                                *(numberOfCities + csrGraphGetNumberOfEdges(csrGraph))){
+        floydWarshall(&context);
+    } else {
+        runMatrixPass(&context, dijkstraRowsPass);
+    }
+
+    DistanceMatrix* newMatrix = malloc(sizeof(DistanceMatrix));
+
+    newMatrix->numberOfCities = numberOfCities;
+    newMatrix->distances = context.distances;
+    newMatrix->predecessors = context.predecessors;
+    newMatrix->mappedFile = NULL;
+
+    return newMatrix;
+}
+
+
+/*
+ * Function: runMatrixPass
+ * -----------------------
+ * Runs a pass over the matrix on every thread and waits
+ * for them all. Exits with an error if a thread can not
+ * be started, as its rows would be left unfilled.
+ */
+void runMatrixPass(MatrixContext* context, void* (*function)(void*)){
+
+    MatrixTask* tasks = malloc(context->numberOfThreads*sizeof(MatrixTask));
+
+    int i;
+    for(i = 0; i < context->numberOfThreads; i++){
+        tasks[i].context = context;
+        tasks[i].threadNumber = i;
+    }
+    threadRunnerRun(context->numberOfThreads, function, tasks, sizeof(MatrixTask));
+
+    free(tasks);
+}
+
+
+/*
+ * Function: dijkstraRowsPass
+ * --------------------------
+ * Runs Dijkstra's from each source of this thread's share
+ * of the rows and copies the distances, and previous
+ * vertices if kept, into the rows.
+ */
+void* dijkstraRowsPass(void* argument){
+
+    MatrixTask* task = argument;
+    MatrixContext* context = task->context;
+    int numberOfCities = context->numberOfCities;
+
+    int first = (long)numberOfCities*task->threadNumber/context->numberOfThreads;
+    int last = (long)numberOfCities*(task->threadNumber + 1)/context->numberOfThreads;
+
+    DijkstraWorkspace* workspace = dijkstraWorkspaceConstructor(numberOfCities, context->heapType);
+    const Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+    const int* previous = dijkstraWorkspaceGetPrevious(workspace);
+
+    int source;
+    for(source = first; source < last; source++){
+        dijkstrasCsr(context->csrGraph, workspace, source);
+        memcpy(context->distances + (size_t)source*numberOfCities, distanceFromSource, numberOfCities*sizeof(Distance));
+        if(context->predecessors != NULL){
+            memcpy(context->predecessors + (size_t)source*numberOfCities, previous, numberOfCities*sizeof(int));
+        }
+    }
+
+    dijkstraWorkspaceDestructor(workspace);
+    return NULL;
+}
+
+
+/*
+ * Function: floydWarshall
+ * -----------------------
+ * Fills the matrix with the shortest road between each
+ * pair, then runs a round for every pivot tile along the
+ * diagonal. A pair only changes when a strictly shorter
+ * route is found, so of two equal routes the one found
+ * first is kept.
+ */
+void floydWarshall(MatrixContext* context){
+
+    const int* offsets = csrGraphGetOffsets(context->csrGraph);
+    const int* targets = csrGraphGetTargets(context->csrGraph);
+    const Weight* roadDistances = csrGraphGetDistances(context->csrGraph);
+    int numberOfCities = context->numberOfCities;
+    Distance* distances = context->distances;
+    int* predecessors = context->predecessors;
+
+    size_t pair;
+    for(pair = 0; pair < (size_t)numberOfCities*numberOfCities; pair++){
+        distances[pair] = DISTANCE_INFINITY;
+        if(predecessors != NULL){
+            predecessors[pair] = -1;
+        }
+    }
+
+    int i;
+    int j;
+    for(i = 0; i < numberOfCities; i++){
+        for(j = offsets[i]; j < offsets[i + 1]; j++){
+            pair = (size_t)i*numberOfCities + targets[j];
+            if(targets[j] != i && roadDistances[j] < distances[pair]){
+                distances[pair] = roadDistances[j];
+                if(predecessors != NULL){
+                    predecessors[pair] = i;
+                }
+            }
+        }
+        distances[(size_t)i*numberOfCities + i] = 0;
+    }
+
+    context->numberOfTiles = (numberOfCities + FLOYD_WARSHALL_TILE_SIZE - 1)/FLOYD_WARSHALL_TILE_SIZE;
+
+    for(context->pivotTile = 0; context->pivotTile < context->numberOfTiles; context->pivotTile++){
+        relaxTile(context, context->pivotTile, context->pivotTile, context->pivotTile);
+        runMatrixPass(context, pivotCrossPass);
+        runMatrixPass(context, remainingTilesPass);
+    }
+}
+
+
+/*
+ * Function: relaxTile
+ * -------------------
+ * Runs the Floyd-Warshall step for every pivot vertex of
+ * the pivot tile over one tile, lowering each distance in
+ * it to the route through the pivot if that is shorter.
+ * The distance from the pivot is compared with what is
+ * left after reaching it, which can not overflow as
+ * DISTANCE_INFINITY for a missing route would when added.
+ */
+void relaxTile(MatrixContext* context, int rowTile, int columnTile, int pivotTile){
+
+    int numberOfCities = context->numberOfCities;
+    Distance* distances = context->distances;
+    int* predecessors = context->predecessors;
+
+    int rowStart = rowTile*FLOYD_WARSHALL_TILE_SIZE;
+    int columnStart = columnTile*FLOYD_WARSHALL_TILE_SIZE;
+    int pivotStart = pivotTile*FLOYD_WARSHALL_TILE_SIZE;
+    int rowEnd = rowStart + FLOYD_WARSHALL_TILE_SIZE < numberOfCities ? rowStart + FLOYD_WARSHALL_TILE_SIZE : numberOfCities;
+    int columnEnd = columnStart + FLOYD_WARSHALL_TILE_SIZE < numberOfCities ? columnStart + FLOYD_WARSHALL_TILE_SIZE : numberOfCities;
+    int pivotEnd = pivotStart + FLOYD_WARSHALL_TILE_SIZE < numberOfCities ? pivotStart + FLOYD_WARSHALL_TILE_SIZE : numberOfCities;
+    int width = columnEnd - columnStart;
+
+    int k;
+    int i;
+    for(k = pivotStart; k < pivotEnd; k++){
+
+        // The parts of the pivot's row and of row i inside the tile
+        const Distance* pivotRow = distances + (size_t)k*numberOfCities + columnStart;
+
+        for(i = rowStart; i < rowEnd; i++){
+
+            // Routes from the pivot itself can not get shorter, and
+            // skipping them means row and pivotRow never overlap
+            if(i == k || distances[(size_t)i*numberOfCities + k] == DISTANCE_INFINITY){
+                continue;
+            }
+
+            Distance* row = distances + (size_t)i*numberOfCities + columnStart;
+            Distance toPivot = distances[(size_t)i*numberOfCities + k];
+
+            if(predecessors == NULL){
+                relaxTileRow(row, pivotRow, toPivot, width);
+            } else {
+                relaxTileRowWithPredecessors(row, pivotRow, predecessors + (size_t)i*numberOfCities + columnStart,
+                                             predecessors + (size_t)k*numberOfCities + columnStart, toPivot, width);
+            }
+        }
+    }
+}
+
+
+/*
+ * Function: relaxTileRow
+ * ----------------------
+ * Lowers each distance of one row of a tile to the route
+ * through the pivot, when predecessors are not kept. The
+ * loop is free of branches, and of a fixed length for a
+ * whole tile, so the compiler vectorises it at -O2.
+ */
+void relaxTileRow(Distance* restrict row, const Distance* restrict pivotRow, Distance toPivot, int width){
+
+    int j;
+    if(width == FLOYD_WARSHALL_TILE_SIZE){
+        for(j = 0; j < FLOYD_WARSHALL_TILE_SIZE; j++){
+            row[j] = pivotRow[j] < row[j] - toPivot ? toPivot + pivotRow[j] : row[j];
+        }
+    } else {
+        for(j = 0; j < width; j++){
+            row[j] = pivotRow[j] < row[j] - toPivot ? toPivot + pivotRow[j] : row[j];
+        }
+    }
+}
+
+
+/*
+ * Function: relaxTileRowWithPredecessors
+ * --------------------------------------
+ * Same as relaxTileRow but also copies the predecessor
+ * from the pivot's row wherever a distance is lowered.
+ * Both are chosen with a mask of all ones where the route
+ * through the pivot is shorter, as the compiler will not
+ * vectorise two stores that depend on one comparison. The
+ * sum is taken unsigned, where it can not overflow, and
+ * is only kept where it is below INT_MAX. Masks only work
+ * for int Distances, other builds choose with a branch.
+ */
+void relaxTileRowWithPredecessors(Distance* restrict row, const Distance* restrict pivotRow, int* restrict rowPredecessors,
+                                  const int* restrict pivotPredecessors, Distance toPivot, int width){
+
+    int j;
+#if WEIGHT_TYPE <= 2
+    unsigned int shorter;
+    if(width == FLOYD_WARSHALL_TILE_SIZE){
+        for(j = 0; j < FLOYD_WARSHALL_TILE_SIZE; j++){
+            shorter = -(unsigned int)(pivotRow[j] < row[j] - toPivot);
+            row[j] = (shorter & ((unsigned int)toPivot + pivotRow[j])) | (~shorter & row[j]);
+            rowPredecessors[j] = (shorter & pivotPredecessors[j]) | (~shorter & rowPredecessors[j]);
+        }
+    } else {
+        for(j = 0; j < width; j++){
+            shorter = -(unsigned int)(pivotRow[j] < row[j] - toPivot);
+            row[j] = (shorter & ((unsigned int)toPivot + pivotRow[j])) | (~shorter & row[j]);
+            rowPredecessors[j] = (shorter & pivotPredecessors[j]) | (~shorter & rowPredecessors[j]);
+        }
+    }
+#else
+    for(j = 0; j < width; j++){
+        if(pivotRow[j] < row[j] - toPivot){
+            row[j] = toPivot + pivotRow[j];
+            rowPredecessors[j] = pivotPredecessors[j];
+        }
+    }
+#endif
+}
+
+
+/*
+ * Function: pivotCrossPass
+ * ------------------------
+ * Relaxes this thread's share of the tiles in the pivot
+ * tile's row and column, which only need the pivot tile.
+ * Work item w below numberOfTiles is the tile in row w of
+ * the pivot column, the rest are the tiles of the pivot
+ * row.
+ */
+void* pivotCrossPass(void* argument){
+
+    MatrixTask* task = argument;
+    MatrixContext* context = task->context;
+    int numberOfWork = 2*context->numberOfTiles;
+
+    int first = (long)numberOfWork*task->threadNumber/context->numberOfThreads;
+    int last = (long)numberOfWork*(task->threadNumber + 1)/context->numberOfThreads;
+
+    int w;
+    for(w = first; w < last; w++){
+        if(w < context->numberOfTiles){
+            if(w != context->pivotTile){
+                relaxTile(context, w, context->pivotTile, context->pivotTile);
+            }
+        } else if(w - context->numberOfTiles != context->pivotTile){
+            relaxTile(context, context->pivotTile, w - context->numberOfTiles, context->pivotTile);
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function: remainingTilesPass
+ * ----------------------------
+ * Relaxes every tile outside the pivot row and column in
+ * this thread's share of the rows of tiles, using the
+ * finished tiles of the pivot row and column.
+ */
+void* remainingTilesPass(void* argument){
+
+    MatrixTask* task = argument;
+    MatrixContext* context = task->context;
+
+    int first = (long)context->numberOfTiles*task->threadNumber/context->numberOfThreads;
+    int last = (long)context->numberOfTiles*(task->threadNumber + 1)/context->numberOfThreads;
+
+    int rowTile;
+    int columnTile;
+    for(rowTile = first; rowTile < last; rowTile++){
+        if(rowTile == context->pivotTile){
+            continue;
+        }
+        for(columnTile = 0; columnTile < context->numberOfTiles; columnTile++){
+            if(columnTile != context->pivotTile){
+                relaxTile(context, rowTile, columnTile, context->pivotTile);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function: distanceMatrixDestructor
+ * ----------------------------------
+ * Frees the matrices if they were malloced or unmaps
+ * the file they came from, then the DistanceMatrix.
+ */
+void distanceMatrixDestructor(DistanceMatrix* matrix){
+
+    if(matrix->mappedFile != NULL){
+        mappedFileClose(matrix->mappedFile);
+    } else {
+        free((Distance*)matrix->distances);
+        free((int*)matrix->predecessors);
+    }
+    free(matrix);
+}
+
+
+/*
+ * Function: distanceMatrixGetNumberOfCities
+ * -----------------------------------------
+ * Returns the number of cities.
+ */
+int distanceMatrixGetNumberOfCities(DistanceMatrix* matrix){
+    return matrix->numberOfCities;
+}
+
+
+/*
+ * Function: distanceMatrixHasPredecessors
+ * ---------------------------------------
+ * Returns whether the predecessor matrix is kept.
+ */
+int distanceMatrixHasPredecessors(DistanceMatrix* matrix){
+    return matrix->predecessors != NULL;
+}
+
+
+/*
+ * Function: distanceMatrixGetDistance
+ * -----------------------------------
+ * Returns the entry of the distance matrix.
+ */
+Distance distanceMatrixGetDistance(DistanceMatrix* matrix, int sourceVertexNumber, int targetVertexNumber){
+    return matrix->distances[(size_t)sourceVertexNumber*matrix->numberOfCities + targetVertexNumber];
+}
+
+
+/*
+ * Function: distanceMatrixGetPrevious
+ * -----------------------------------
+ * Returns the entry of the predecessor matrix, or -1
+ * if it is not kept.
+ */
+int distanceMatrixGetPrevious(DistanceMatrix* matrix, int sourceVertexNumber, int targetVertexNumber){
+
+    if(matrix->predecessors == NULL){
+        return -1;
+    }
+    return matrix->predecessors[(size_t)sourceVertexNumber*matrix->numberOfCities + targetVertexNumber];
+}
+
+
+/*
+ * Function: distanceMatrixWrite
+ * -----------------------------
+ * Fills in the header and writes it followed by the
+ * matrices and the translation table of the CsrGraph,
+ * padded to the section boundaries.
+ */
+int distanceMatrixWrite(DistanceMatrix* matrix, CsrGraph* csrGraph, const char* path){
+
+    MatrixHeader header;
+    memset(&header, 0, sizeof(MatrixHeader));
+
+    uint64_t distancesSize = (uint64_t)matrix->numberOfCities*matrix->numberOfCities*sizeof(Distance);
+    uint64_t predecessorsSize = (uint64_t)matrix->numberOfCities*matrix->numberOfCities*sizeof(int);
+    uint64_t originalNumbersSize = (uint64_t)matrix->numberOfCities*sizeof(int);
+    const int* originalNumbers = csrGraphGetOriginalNumbers(csrGraph);
+    uint64_t position;
+
+    strcpy(header.magic, DISTANCE_MATRIX_MAGIC);
+    header.version = DISTANCE_MATRIX_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.intSize = sizeof(int);
+    header.weightType = WEIGHT_TYPE;
+    header.numberOfCities = matrix->numberOfCities;
+    header.numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+    header.graphFingerprint = csrGraphGetFingerprint(csrGraph);
+    header.hasPredecessors = matrix->predecessors != NULL;
+    header.distancesStart = distanceMatrixAlign(sizeof(MatrixHeader));
+    position = distanceMatrixAlign(header.distancesStart + distancesSize);
+    if(header.hasPredecessors){
+        header.predecessorsStart = position;
+        position = distanceMatrixAlign(position + predecessorsSize);
+    }
+    if(originalNumbers != NULL){
+        header.originalNumbersStart = position;
+        position = distanceMatrixAlign(position + originalNumbersSize);
+    }
+    header.fileSize = position;
+
+    FILE* file = fopen(path, "wb");
+    if(file == NULL){
+        return -1;
+    }
+
+    static const char padding[SECTION_ALIGNMENT] = {0};
+    uint64_t paddingSize;
+    int failed = 0;
+
+    failed |= fwrite(&header, sizeof(MatrixHeader), 1, file) != 1;
+
+    paddingSize = header.distancesStart - sizeof(MatrixHeader);
+    failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+    failed |= fwrite(matrix->distances, 1, distancesSize, file) != distancesSize;
+    position = header.distancesStart + distancesSize;
+
+    if(header.hasPredecessors){
+        paddingSize = header.predecessorsStart - position;
+        failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+        failed |= fwrite(matrix->predecessors, 1, predecessorsSize, file) != predecessorsSize;
+        position = header.predecessorsStart + predecessorsSize;
+    }
+
+    if(originalNumbers != NULL){
+        paddingSize = header.originalNumbersStart - position;
+        failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+        failed |= fwrite(originalNumbers, 1, originalNumbersSize, file) != originalNumbersSize;
+        position = header.originalNumbersStart + originalNumbersSize;
+    }
+
+    paddingSize = header.fileSize - position;
+    failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+
+    failed |= fclose(file) != 0;
+    return failed ? -1 : 0;
+}
+
+
+/*
+ * Function: distanceMatrixLoad
+ * ----------------------------
+ * Maps the file and checks the header against this
+ * program and the CsrGraph, and that the matrices lie
+ * inside the file, then checks every city is at distance
+ * 0 from itself.
+ */
+DistanceMatrix* distanceMatrixLoad(const char* path, CsrGraph* csrGraph){
+
+    MappedFile* mappedFile = mappedFileOpen(path);
+    if(mappedFile == NULL){
+        distanceMatrixError(path, "The file could not be opened.");
+    }
+
+    const char* data = mappedFileGetData(mappedFile);
+    size_t size = mappedFileGetSize(mappedFile);
+
+    if(size < sizeof(MatrixHeader)){
+        distanceMatrixError(path, "The file is too short to hold a distance matrix.");
+    }
+
+    const MatrixHeader* header = (const MatrixHeader*)data;
+
+    if(memcmp(header->magic, DISTANCE_MATRIX_MAGIC, sizeof(DISTANCE_MATRIX_MAGIC))){
+        distanceMatrixError(path, "The file does not hold a distance matrix.");
+    }
+    if(header->version != DISTANCE_MATRIX_VERSION){
+        distanceMatrixError(path, "The matrix was written by a different version, please make it again.");
+    }
+    if(header->byteOrderMark != BYTE_ORDER_MARK || header->intSize != sizeof(int)){
+        distanceMatrixError(path, "The matrix was written on a different kind of machine.");
+    }
+    if(header->weightType != WEIGHT_TYPE){
+        distanceMatrixError(path, "The matrix was written by a program compiled with different distance types.");
+    }
+    if(header->numberOfCities != (uint32_t)csrGraphGetNumberOfCities(csrGraph)
+       || header->numberOfEdges != (uint32_t)csrGraphGetNumberOfEdges(csrGraph)
+       || header->graphFingerprint != csrGraphGetFingerprint(csrGraph)){
+        distanceMatrixError(path, "The matrix was made for a different graph or numbering of its cities, please make it again.");
+    }
+    if(header->fileSize != size){
+        distanceMatrixError(path, "The file is not the size recorded in its header.");
+    }
+
+    uint64_t numberOfCities = header->numberOfCities;
+    uint64_t distancesSize = numberOfCities*numberOfCities*sizeof(Distance);
+    uint64_t predecessorsSize = numberOfCities*numberOfCities*sizeof(int);
+    uint64_t originalNumbersSize = numberOfCities*sizeof(int);
+
+    if(header->hasPredecessors > 1
+       || header->distancesStart % SECTION_ALIGNMENT != 0 || header->predecessorsStart % SECTION_ALIGNMENT != 0
+       || header->originalNumbersStart % SECTION_ALIGNMENT != 0
+       || header->distancesStart < sizeof(MatrixHeader) || header->distancesStart > size
+       || distancesSize > size - header->distancesStart
+       || (header->hasPredecessors && (header->predecessorsStart < sizeof(MatrixHeader)
+                                       || header->predecessorsStart > size
+                                       || predecessorsSize > size - header->predecessorsStart))
+       || (header->originalNumbersStart != 0 && (header->originalNumbersStart < sizeof(MatrixHeader)
+                                                 || header->originalNumbersStart > size
+                                                 || originalNumbersSize > size - header->originalNumbersStart))){
+        distanceMatrixError(path, "A section of the distance matrix file is damaged.");
+    }
+
+    const Distance* distances = (const Distance*)(data + header->distancesStart);
+
+    uint64_t i;
+    for(i = 0; i < numberOfCities; i++){
+        if(distances[i*numberOfCities + i] != 0){
+            distanceMatrixError(path, "The distance matrix file is damaged.");
+        }
+    }
+
+    DistanceMatrix* newMatrix = malloc(sizeof(DistanceMatrix));
+
+    newMatrix->numberOfCities = numberOfCities;
+    newMatrix->distances = distances;
+    newMatrix->predecessors = header->hasPredecessors ? (const int*)(data + header->predecessorsStart) : NULL;
+    newMatrix->mappedFile = mappedFile;
+
+    return newMatrix;
+}
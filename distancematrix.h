@@ -0,0 +1,109 @@
+/*
+ * distancematrix.h
+ * ----------------
+ *
+ * The header file for distancematrix.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include <csrgraph.h>
+#include <minheap.h>
+
+#define DISTANCE_MATRIX_VERSION 4 // Increased whenever the file layout changes
+
+typedef struct DistanceMatrix DistanceMatrix;
+
+/*
+ * Function: distanceMatrixConstructor
+ * -----------------------------------
+ * Finds the shortest distance between every pair of
+ * vertices of the CsrGraph on numberOfThreads threads and
+ * returns a pointer to the DistanceMatrix. If
+ * withPredecessors is set the vertex before the target on
+ * each route is kept as well, so every route can be
+ * traced. Runs of Dijkstra's use MinHeaps of type
+ * heapType. Needs a Distance per pair of vertices, and
+ * four bytes more with predecessors, and exits with an
+ * error if they can not be allocated.
+ */
+DistanceMatrix* distanceMatrixConstructor(CsrGraph* csrGraph, int numberOfThreads, int withPredecessors,
+                                          MinHeapType heapType);
+
+
+/*
+ * Function: distanceMatrixDestructor
+ * ----------------------------------
+ * Frees the DistanceMatrix and its arrays, or unmaps the
+ * file it was loaded from.
+ */
+void distanceMatrixDestructor(DistanceMatrix* matrix);
+
+
+/*
+ * Function: distanceMatrixGetNumberOfCities
+ * -----------------------------------------
+ * Returns the number of rows, and of columns.
+ */
+int distanceMatrixGetNumberOfCities(DistanceMatrix* matrix);
+
+
+/*
+ * Function: distanceMatrixHasPredecessors
+ * ---------------------------------------
+ * Returns 1 if the matrix keeps predecessors and 0 if it
+ * only keeps distances.
+ */
+int distanceMatrixHasPredecessors(DistanceMatrix* matrix);
+
+
+/*
+ * Function: distanceMatrixGetDistance
+ * -----------------------------------
+ * Returns the shortest distance from source to target,
+ * or DISTANCE_INFINITY if there is no route.
+ */
+Distance distanceMatrixGetDistance(DistanceMatrix* matrix, int sourceVertexNumber, int targetVertexNumber);
+
+
+/*
+ * Function: distanceMatrixGetPrevious
+ * -----------------------------------
+ * Returns the vertex before the target on the shortest
+ * route from source to target, or -1 if the target is the
+ * source, can not be reached or the matrix keeps no
+ * predecessors. Following it back from the target ends at
+ * the source.
+ */
+int distanceMatrixGetPrevious(DistanceMatrix* matrix, int sourceVertexNumber, int targetVertexNumber);
+
+
+/*
+ * Function: distanceMatrixWrite
+ * -----------------------------
+ * Writes the DistanceMatrix to a binary file, to be kept
+ * next to the graph it was made for. The distances are a
+ * row per source, row-major, so other programs can map
+ * the file and index it directly. Rows and columns are
+ * in the CsrGraph's numbering, and if it was renumbered
+ * its translation table is written after the matrices.
+ * Returns 0 on success and -1 if the file could not be
+ * written.
+ */
+int distanceMatrixWrite(DistanceMatrix* matrix, CsrGraph* csrGraph, const char* path);
+
+
+/*
+ * Function: distanceMatrixLoad
+ * ----------------------------
+ * Maps a file written by distanceMatrixWrite() read-only
+ * and returns a DistanceMatrix whose arrays point into the
+ * mapping. Exits with an error if the file is missing,
+ * damaged, of a different version or made for a graph with
+ * a different fingerprint, see csrGraphGetFingerprint().
+ */
+DistanceMatrix* distanceMatrixLoad(const char* path, CsrGraph* csrGraph);
+
+#endif
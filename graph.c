@@ -6,15 +6,20 @@
  * University of York
  * Date 26/01/2019
  *
- * This file contains the functions for the Graph
- * abstract data type. Here the Graph structure contains
- * a list of pointers to it's Vertices and each Vertex structure
- * contains a list of pointers to its Edges and each Edge has
- * pointers to it's start and Vertices. This forms an Adjacency
- * List that stores the information of the Graph. The Vertex
- * structure also contains some information needed to speed up
- * Dijkstra's algorithms such as it's location within the minHeap
- * ADT. A lot of the functions within this file are getters
+ * This file contains the functions for the Graph abstract data
+ * type. Here the Graph structure contains a list of pointers to
+ * it's Vertices and each Vertex structure contains an array of its
+ * Edges and each Edge has the vertex number of its end Vertex, four
+ * bytes rather than a pointer's eight, and its Weight. This forms
+ * an Adjacency List that stores the information of the Graph. The
+ * Graph also owns a NameIndex hash table for finding a Vertex from
+ * its cityName. Vertices and Edges are bump allocated from an Arena
+ * owned by the Graph and the city names are packed into a second
+ * Arena, so loading does not call malloc per city or per road and
+ * the whole Graph is freed at once. Once loaded the Graph is never
+ * written to, the state of each run of Dijkstra's algorithm is kept
+ * in a DijkstraWorkspace instead, so any number of runs can share
+ * one Graph. A lot of the functions within this file are getters
  * and setters necessary to access the information contained within
  * the Structs in different files.
  */
@@ -22,10 +27,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <limits.h>
 #include <graph.h>
+#include <nameindex.h>
+#include <arena.h>
+#include <linereader.h>
 
-#define STRING_SIZE 250 // Maximum length of a string
+#define ARENA_BLOCK_SIZE 65536 // Bytes malloced at a time by the Graph's arenas
+#define INITIAL_EDGE_CAPACITY 4 // Edges room is made for on a Vertex's first Edge
+#define INITIAL_CITY_CAPACITY 64 // Vertices room is made for in adjLists at first
 
 typedef struct Vertex{
 
@@ -36,27 +45,18 @@ typedef struct Vertex{
     int numberOfEdges;
     char* cityName;
 
-    // Pointer to Edge pointers
+    // Array of Edges stored in the Graph's arena
     // Forms an adjacency list of this Vertex
-    Edge** edges;
-
-
-    // Following variables needed for
-    // improving efficiency of Dijkstra's
-    // algorithm
-    Vertex* previous; // Previous city on route to destination
-    int distanceFromSource;
-    int positionInHeap;
-    int visited; // Has vertex been visited by Dijkstra's algorithm
+    Edge* edges;
+    int edgeCapacity;
 
 } Vertex;
 
 
 typedef struct Edge{
 
-    Vertex* start;
-    Vertex* end;
-    int distance;
+    int end; // Vertex number of the end Vertex
+    Weight distance;
 
 } Edge;
 
@@ -64,54 +64,55 @@ typedef struct Edge{
 typedef struct Graph{
 
     int numberOfCities;
+    int numberOfEdges;
+    int cityCapacity; // Length of adjLists, doubled when full
     Vertex** adjLists; // Pointer to Vertex pointers
 
+    // Vertices and Edges are allocated from arena and city names
+    // are packed together in stringPool. Both are freed at once
+    // by graphDestructor().
+    Arena* arena;
+    Arena* stringPool;
+
+    // Hash table from cityName to vertexNumber
+    NameIndex* cityIndex;
+
 } Graph;
 
 
 // Internal function declarations
-void addEdge(Graph* graph, int start, int end, int distance);
-void checkStringsKnown(Graph* graph, char* stringA, char* stringB, int* vertexNumberA, int* vertexNumberB);
-void vertexEdgesResize(Vertex* vertex);
-void vertexDestructor(Vertex* vertex);
-void graphVertexResize(Graph* graph, int i, char* string);
-Edge* edgeConstructor(Graph* graph, int distance, int start, int end);
-void edgeDestructor();
+void addEdge(Graph* graph, int start, int end, Weight distance);
+void checkStringsKnown(Graph* graph, const char* stringA, int lengthA, const char* stringB, int lengthB,
+                       int* vertexNumberA, int* vertexNumberB);
+void vertexEdgesResize(Graph* graph, Vertex* vertex);
+void graphVertexResize(Graph* graph, int i, const char* string, int length);
+void graphPopulateFromLineReader(Graph* graph, LineReader* lineReader);
+Edge* edgeConstructor(Graph* graph, Weight distance, int start, int end);
 
 
 /*
  * Function: vertexConstructor
  * ---------------------------
- * Constructs a Vertex using a provided number
- * and city name. Initially assumes Vertex has no
- * edges and these are added later. Distance from
- * source is initially set to INT_MAX as this is
- * needed in Dijkstra's algorithm. Malloced memory
- * is freed in vertexDestructor().
+ * Constructs a Vertex in the Graph's arena using a
+ * provided number and the first length characters of a
+ * city name, which need not be null-terminated. The city
+ * name is copied into the Graph's string pool. Initially
+ * assumes Vertex has no edges and these are added later.
+ * Memory is freed along with the rest of the arena in
+ * graphDestructor().
  */
-Vertex* vertexConstructor(int vertexNumber, char* cityName){
+Vertex* vertexConstructor(Graph* graph, int vertexNumber, const char* cityName, int length){
 
-    Vertex* newVertex = malloc(sizeof(Vertex));
+    Vertex* newVertex = arenaAllocate(graph->arena, sizeof(Vertex));
 
     newVertex->vertexNumber = vertexNumber;
-
-    // Needs the +1 for the null-terminator
-    newVertex->cityName = malloc(strlen(cityName)+1);
-    strcpy(newVertex->cityName, cityName);
+    newVertex->cityName = arenaCopyString(graph->stringPool, cityName, length);
 
     newVertex->numberOfEdges = 0;
     // Edges not sized initially so just set to NULL.
     // Will be resized in vertexEdgesResize().
     newVertex->edges = NULL;
-
-    // Position in heap defaults to -1 as not yet
-    // being used in a heap.
-    newVertex->positionInHeap = -1;
-    newVertex->previous = NULL;
-    // INT_MAX Requires limits.h, sets an
-    // integer to its maximum possible value.
-    newVertex->distanceFromSource = INT_MAX;
-    newVertex->visited = 0; // Not visited
+    newVertex->edgeCapacity = 0;
 
     return newVertex;
 }
@@ -120,46 +121,23 @@ Vertex* vertexConstructor(int vertexNumber, char* cityName){
 /*
  * Function: vertexEdgesResize
  * ---------------------------
- * Used to resize the edges variable in a Vertex
- * as new edges are added.
+ * Used to make room in the edges array of a full Vertex.
+ * The capacity is doubled and the Edges copied into a new
+ * array from the arena. The old array is left in the arena,
+ * which at most doubles the memory used for Edges but means
+ * a Vertex with n Edges is only resized log(n) times.
  */
-void vertexEdgesResize(Vertex* vertex){
-    // Increase the size of edges by one.
-    vertex->edges = realloc(vertex->edges, (vertex->numberOfEdges + 1)*sizeof(Edge*));
-
-    // Each edge needs memory allocated. Pointer returned and stores in
-    // Furthest right index, (numberOfEdges), of edges array.
-    vertex->edges[vertex->numberOfEdges] = malloc(sizeof(Edge));
-    vertex->edges[vertex->numberOfEdges] = NULL;
-}
+void vertexEdgesResize(Graph* graph, Vertex* vertex){
 
+    int newCapacity = vertex->edgeCapacity == 0 ? INITIAL_EDGE_CAPACITY : 2*vertex->edgeCapacity;
+    Edge* newEdges = arenaAllocate(graph->arena, newCapacity*sizeof(Edge));
 
-/*
- * Function: vertexDestructor
- * --------------------------
- * Frees the memory used for a Vertex.
- */
-void vertexDestructor(Vertex* vertex){
-
-    int i;
-
-    // Each edge in edges needs freeing first
-    for (i = 0; i < vertex->numberOfEdges; i++){
-        edgeDestructor(vertex->edges[i]);
+    if(vertex->numberOfEdges > 0){
+        memcpy(newEdges, vertex->edges, vertex->numberOfEdges*sizeof(Edge));
     }
 
-    free(vertex->cityName);
-    free(vertex);
-}
-
-
-/*
- * Function: vertexGetDistanceFromSource
- * -------------------------------------
- * Returns the value of distanceFromSource.
- */
-int vertexGetDistanceFromSource(Vertex* vertex){
-    return vertex->distanceFromSource;
+    vertex->edges = newEdges;
+    vertex->edgeCapacity = newCapacity;
 }
 
 
@@ -183,103 +161,6 @@ char* vertexGetCityName(Vertex* vertex){
 }
 
 
-/*
- * Function: vertexGetPreviousCityName
- * -----------------------------------
- * Points through to previous Vertex and
- * returns it's cityName variable.
- */
-char* vertexGetPreviousCityName(Vertex* vertex){
-    return vertex->previous->cityName;
-}
-
-
-/*
- * Function: vertexGetPrevious
- * ---------------------------
- * Returns a pointer to the previous Vertex
- */
-Vertex* vertexGetPrevious(Vertex* vertex){
-    return vertex->previous;
-}
-
-
-/*
- * Function: vertexIsVisited
- * -------------------------
- * Returns the value of visited, used
- * like a boolean true or false.
- */
-int vertexIsVisited(Vertex* vertex){
-    return vertex->visited;
-}
-
-
-/*
- * Function: vertexSetIsVisited
- * ----------------------------
- * Used to set a vertex as visited.
- */
-void vertexSetIsVisited(Vertex* vertex){
-    vertex->visited = 1;
-}
-
-
-/*
- * Function: vertexSetIsNotVisited
- * -------------------------------
- * For resetting the Vertex to not visited. This
- * is used at the start of each Dijkstra's run through.
- */
-void vertexSetIsNotVisited(Vertex* vertex){
-    vertex->visited = 0;
-}
-
-
-
-/*
- * Function: vertexSetPositionInHeap
- * ---------------------------------
- * Setting the associated node in heap index. This is needed
- * to speed up Dijkstra's algorithm as no need to search the heap.
- */
-void vertexSetPositionInHeap(Vertex* vertex, int position){
-    vertex->positionInHeap = position;
-}
-
-
-/*
- * Function: vertexGetPositionInHeap
- * ---------------------------------
- * Returns index of associated node in heap.
- */
-int vertexGetPositionInHeap(Vertex* vertex){
-    return vertex->positionInHeap;
-}
-
-
-/*
- * Function: vertexSetDistanceFromSource
- * -------------------------------------
- * Distance from the chosen source Vertex.
- */
-void vertexSetDistanceFromSource(Vertex* vertex, int distance){
-    vertex->distanceFromSource = distance;
-}
-
-
-/*
- * Function: vertexSetPrevious
- * ---------------------------
- * Setting the pointer to the previous Vertex. This
- * is used to plot a route from destination to source
- * vertex to find the shortest path.
- */
-void vertexSetPrevious(Vertex* currentVertex, Vertex* previousVertex){
-    currentVertex->previous = previousVertex;
-}
-
-
 /*
  * Function: vertexGetNumberOfEdges
  * --------------------------------
@@ -297,46 +178,42 @@ int vertexGetNumberOfEdges(Vertex* vertex){
  * a Vertex's edges list.
  */
 Edge* vertexGetEdge(Vertex* vertex, int edgeNumber){
-    return vertex->edges[edgeNumber];
+    return &vertex->edges[edgeNumber];
 }
 
 
 /*
  * Function: edgeConstructor
  * -------------------------
- * Constructs and mallocs an Edge and returns a pointer to it.
- * The start and end integers are the Vertex's the edge will point too.
+ * Constructs an Edge in the next free place of the start
+ * Vertex's edges array, resizing it first if it is full,
+ * and returns a pointer to it. The start and end integers
+ * are the Vertex's the edge will point too.
  */
-Edge* edgeConstructor(Graph* graph, int distance, int start, int end){
-
-    Edge* newEdge = malloc(sizeof(Edge));
+Edge* edgeConstructor(Graph* graph, Weight distance, int start, int end){
 
-    newEdge->distance = distance;
-    // Pointers to Vertices in the overall graph structure.
-    newEdge->start = graph->adjLists[start];
-    newEdge->end = graph->adjLists[end];
+    Vertex* startVertex = graph->adjLists[start];
 
-    return newEdge;
-}
+    if(startVertex->numberOfEdges == startVertex->edgeCapacity){
+        vertexEdgesResize(graph, startVertex);
+    }
 
+    Edge* newEdge = &startVertex->edges[startVertex->numberOfEdges];
+    startVertex->numberOfEdges++;
 
-/*
- * Function: edgeDestructor
- * ------------------------
- * Frees the dynamically allocated memory.
- */
-void edgeDestructor(Edge* edge){
+    newEdge->distance = distance;
+    newEdge->end = end;
 
-    free(edge);
+    return newEdge;
 }
 
 
 /*
- * Function: edgeGetEndVertex
- * --------------------------
- * Returns a pointer to the end Vertex of an Edge.
+ * Function: edgeGetEndVertexNumber
+ * --------------------------------
+ * Returns the vertex number of the end Vertex of an Edge.
  */
-Vertex* edgeGetEndVertex(Edge* edge){
+int edgeGetEndVertexNumber(Edge* edge){
     return edge->end;
 }
 
@@ -346,7 +223,7 @@ Vertex* edgeGetEndVertex(Edge* edge){
  * -------------------------
  * Returns the distance value associated with an Edge.
  */
-int edgeGetDistance(Edge* edge){
+Weight edgeGetDistance(Edge* edge){
     return edge->distance;
 }
 
@@ -365,7 +242,12 @@ Graph* graphConstructor(){
 
     Graph* newGraph = malloc(sizeof(Graph));
     newGraph->numberOfCities = 0;
+    newGraph->numberOfEdges = 0;
+    newGraph->cityCapacity = 0;
     newGraph->adjLists = NULL;
+    newGraph->arena = arenaConstructor(ARENA_BLOCK_SIZE);
+    newGraph->stringPool = arenaConstructor(ARENA_BLOCK_SIZE);
+    newGraph->cityIndex = nameIndexConstructor();
     return newGraph;
 }
 
@@ -373,19 +255,24 @@ Graph* graphConstructor(){
 /*
  * Function: graphVertexResize
  * ---------------------------
- * Reallocs the size of the adjLists to
- * enable the adding of a single new Vertex. Then
- * constructs a vertex using an index and a
- * cityName string.
+ * Makes sure adjLists has room for a single new Vertex,
+ * doubling its size if it is full. Then constructs a
+ * vertex using an index and a cityName string of the
+ * given length.
  */
-void graphVertexResize(Graph* graph, int i, char* string){
+void graphVertexResize(Graph* graph, int i, const char* string, int length){
 
     // Increase size of adjLists
-    graph->adjLists = realloc(graph->adjLists, (graph->numberOfCities + 1)*sizeof(Vertex*));
-    graph->adjLists[graph->numberOfCities] = malloc(sizeof(Vertex*));
+    if(graph->numberOfCities == graph->cityCapacity){
+        graph->cityCapacity = graph->cityCapacity == 0 ? INITIAL_CITY_CAPACITY : 2*graph->cityCapacity;
+        graph->adjLists = realloc(graph->adjLists, graph->cityCapacity*sizeof(Vertex*));
+    }
 
     // Construct new Vertex and increase the number of cities
-    graph->adjLists[graph->numberOfCities] = vertexConstructor(i, string);
+    graph->adjLists[graph->numberOfCities] = vertexConstructor(graph, i, string, length);
+
+    // Index the Vertex's own copy of the name as string may be reused
+    nameIndexInsert(graph->cityIndex, graph->adjLists[graph->numberOfCities]->cityName, length, i);
     graph->numberOfCities++;
 }
 
@@ -394,15 +281,15 @@ void graphVertexResize(Graph* graph, int i, char* string){
  * Function: graphDestructor
  * -------------------------
  * Frees dynamically allocated memory of Graph.
- * Frees all Vertices first and then the Graph.
+ * All Vertices, Edges and city names are freed
+ * with the two arenas and then the Graph.
  */
 void graphDestructor(Graph* graph){
 
-    int i;
-    for (i = 0; i < graph->numberOfCities; i++){
-        vertexDestructor(graph->adjLists[i]);
-    }
-
+    arenaDestructor(graph->arena);
+    arenaDestructor(graph->stringPool);
+    nameIndexDestructor(graph->cityIndex);
+    free(graph->adjLists);
     free(graph);
 }
 
@@ -415,70 +302,41 @@ void graphDestructor(Graph* graph){
  * Edge from end index to start index and adds it to the
  * Vertex with vertexNumber end.
  */
-void addEdge(Graph* graph, int start, int end, int distance){
-
-    // Edge from start to end
-    Edge* edge = edgeConstructor(graph, distance, start, end);
-
-    // Resize the size of the Edges array in the start Vertex
-    vertexEdgesResize(graph->adjLists[start]);
-
-    // The Vertex at graph->adjList[start], gets the new Edge added to the end-of (number-of-edges) it's list of Edges
-    graph->adjLists[start]->edges[graph->adjLists[start]->numberOfEdges] = edge;
-    // That Vertex now has one more Edge
-    graph->adjLists[start]->numberOfEdges++;
+void addEdge(Graph* graph, int start, int end, Weight distance){
 
+    // Edge from start to end, added to the end of the start Vertex's edges
+    edgeConstructor(graph, distance, start, end);
 
     // Create the reverse Edge
-    edge = edgeConstructor(graph, distance, end, start);
-
-    // Resize Edges array in end Vertex
-    vertexEdgesResize(graph->adjLists[end]);
-    // Add Edge to edges array
-    graph->adjLists[end]->edges[graph->adjLists[end]->numberOfEdges] = edge;
-    // Increase numberOfEdges
-    graph->adjLists[end]->numberOfEdges++;
+    edgeConstructor(graph, distance, end, start);
+
+    graph->numberOfEdges += 2;
 }
 
 
 /*
  * Function: checkStringsKnown
  * ---------------------------
- * Loops through the graph vertices to check for
- * a new, unknown string. If the string is
- * unknown the adjLists is realloced and
- * the new string added. The vertex number of
- * the city is returned via int pointers
- */
-void checkStringsKnown(Graph* graph, char* stringA, char* stringB, int* vertexNumberA, int* vertexNumberB){
-
-    // Used as bools check if city has been found
-    int stringAKnown = 0;
-    int stringBKnown = 0;
-
-    int k = 0;
-    for (k = 0; k < graph->numberOfCities; k++){
-        // loop through array and compare known with stringA
-        if(!strcmp(graph->adjLists[k]->cityName, stringA)) {
-            *vertexNumberA = k;
-            stringAKnown = 1;
-        }
-        // loop through array and compare known with stringB
-        if(!strcmp(graph->adjLists[k]->cityName, stringB)) {
-            *vertexNumberB = k;
-            stringBKnown = 1;
-        }
+ * Looks up both strings in the Graph's cityIndex hash
+ * table. If a string is unknown the adjLists is realloced
+ * and the new string added. The vertex number of the city
+ * is returned via int pointers
+ */
+void checkStringsKnown(Graph* graph, const char* stringA, int lengthA, const char* stringB, int lengthB,
+                       int* vertexNumberA, int* vertexNumberB){
+
+    *vertexNumberA = nameIndexFind(graph->cityIndex, stringA, lengthA);
+    // If string not known add it to array
+    if(*vertexNumberA == -1){
+        *vertexNumberA = graph->numberOfCities;
+        graphVertexResize(graph, graph->numberOfCities, stringA, lengthA);
     }
-    if (!(stringAKnown && stringBKnown)){
-         // If string not known add it to array
-         if (!stringAKnown){
-                *vertexNumberA = graph->numberOfCities;
-                graphVertexResize(graph, graph->numberOfCities, stringA);
-         }
-         if(!stringBKnown){
-                *vertexNumberB = graph->numberOfCities;
-                graphVertexResize(graph, graph->numberOfCities, stringB);
-         }
+
+    // Looked up after stringA is added in case both are the same city
+    *vertexNumberB = nameIndexFind(graph->cityIndex, stringB, lengthB);
+    if(*vertexNumberB == -1){
+        *vertexNumberB = graph->numberOfCities;
+        graphVertexResize(graph, graph->numberOfCities, stringB, lengthB);
     }
 }
 
@@ -486,80 +344,125 @@ void checkStringsKnown(Graph* graph, char* stringA, char* stringB, int* vertexNu
 /*
  * Function: graphPopulateGraph
  * ----------------------------
- * Runs through the ukcities file assigning information
- * to the temporary variables. Checking if the city is known
- * and if not creating a new vertex to store the city.
- * Makes calls to addEdge to connect all the Vertices. This
- * completes the Graph structure.
+ * Reads the ukcities file in a single pass through a
+ * LineReader and adds every line to the Graph.
  */
 void graphPopulateGraph(Graph* graph, FILE* ukcities){
 
-    // Temporary variables for cities and distances imported
-    char* start = malloc(STRING_SIZE*sizeof(char));
-    char* end = malloc(STRING_SIZE*sizeof(char));
-    int distance;
+    LineReader* lineReader = lineReaderConstructor(ukcities);
+    graphPopulateFromLineReader(graph, lineReader);
+    lineReaderDestructor(lineReader);
+}
+
+
+/*
+ * Function: graphPopulateGraphFromMemory
+ * --------------------------------------
+ * Same as graphPopulateGraph but for the text of the
+ * file already in memory, for example a mapped file.
+ */
+void graphPopulateGraphFromMemory(Graph* graph, const char* data, size_t size){
+
+    LineReader* lineReader = lineReaderConstructorFromMemory(data, size);
+    graphPopulateFromLineReader(graph, lineReader);
+    lineReaderDestructor(lineReader);
+}
+
+
+/*
+ * Function: graphAddRoads
+ * -----------------------
+ * Checks each road, looks up or creates both of its
+ * cities and adds the Edges in each direction.
+ */
+int graphAddRoads(Graph* graph, const RoadRecord* roads, int numberOfRoads){
+
     int vertexNumberStart = 0;
     int vertexNumberEnd = 0;
 
-    // Counting the number of lines
-    // Used for error checking
-    char character;
-    int lineNumber = 0;
-    while(!feof(ukcities)){
-        character = fgetc(ukcities);
-        if(character == '\n'){
-            lineNumber++;
+    int i;
+    for(i = 0; i < numberOfRoads; i++){
+        if(roads[i].startLength <= 0 || roads[i].endLength <= 0 || roads[i].distance <= 0){
+            return i;
         }
-    }
 
-    // Sets the file position to the beginning of the file
-    rewind(ukcities);
+        checkStringsKnown(graph, roads[i].start, roads[i].startLength, roads[i].end, roads[i].endLength,
+                          &vertexNumberStart, &vertexNumberEnd);
 
+        addEdge(graph, vertexNumberStart, vertexNumberEnd, roads[i].distance);
+    }
+    return numberOfRoads;
+}
 
-    //  %[^\t] - Read any character that is not a TAB
-    //  \t - The TAB character
-    //  %d - The integer
-    //  \r - The return carriage character
-    //  \n - The new line character
-    // Each line of the file is terminated with both a \r and a \n character
-    // While fscanf has read three things, two strings and an integer on a line
-    int i = 0;
-    while(3 == fscanf(ukcities, "%[^\t]\t%[^\t]\t%d\r\n", start, end, &distance)){
 
-        checkStringsKnown(graph, start, end, &vertexNumberStart, &vertexNumberEnd);
+/*
+ * Function: graphPopulateFromLineReader
+ * -------------------------------------
+ * Runs through the lines of the ukcities file. The two city
+ * names are looked up where they lie in the LineReader's
+ * memory, checking if the city is known and if not creating
+ * a new vertex to store the city, so a name is only copied
+ * the first time it is seen. Hands each road to graphAddRoads
+ * to connect all the Vertices. This completes the Graph
+ * structure. Any line that is not two strings and a positive
+ * length is reported with its line number and the program
+ * exits.
+ */
+void graphPopulateFromLineReader(Graph* graph, LineReader* lineReader){
+
+    const char* start;
+    const char* end;
+    const char* distanceField;
+    int startLength;
+    int endLength;
+    int distanceLength;
+    Weight distance;
+    RoadRecord road;
+
+    while(lineReaderNextLine(lineReader)){
+
+        if(lineReaderGetNumberOfFields(lineReader) != 3){
+            printf("\n######################################\n");
+            printf("There was an error reading 'ukcities.txt' on line: %ld\n\n", lineReaderGetLineNumber(lineReader));
+            printf("Please check each line of the file contains two,\n");
+            printf("tab-delimited, strings followed by an integer\n");
+            printf("and try again.\n");
+            printf("######################################\n\n");
+            exit(-1);
+        }
+
+        start = lineReaderGetField(lineReader, 0, &startLength);
+        end = lineReaderGetField(lineReader, 1, &endLength);
+        distanceField = lineReaderGetField(lineReader, 2, &distanceLength);
+
+        if(startLength == 0 || endLength == 0 || lineReaderParseWeight(distanceField, distanceLength, &distance)){
+            printf("\n######################################\n");
+            printf("There was an error reading 'ukcities.txt' on line: %ld\n\n", lineReaderGetLineNumber(lineReader));
+            printf("Please check the city names are not empty and\n");
+            printf("the distance is %s\n", WEIGHT_DESCRIPTION);
+            printf("and try again.\n");
+            printf("######################################\n\n");
+            exit(-1);
+        }
 
         if(distance <= 0){
             printf("#################################################\n");
             printf("Distance is equal too or less than zero\n");
-            printf("Please check distance between %s and %s\n", start, end);
+            printf("Please check distance between %.*s and %.*s on line: %ld\n",
+                   startLength, start, endLength, end, lineReaderGetLineNumber(lineReader));
             printf("#################################################\n\n");
             exit(-1);
         }
 
-        addEdge(graph, vertexNumberStart, vertexNumberEnd, distance);
-
-        // i is counting the number of lines read
-        // used for error checking
-        i++;
+        // The fields are only valid until the next line so
+        // each road is added on its own
+        road.start = start;
+        road.startLength = startLength;
+        road.end = end;
+        road.endLength = endLength;
+        road.distance = distance;
+        graphAddRoads(graph, &road, 1);
     }
-
-
-    // If the number of lines read by the
-    // file when importing data isn't equal
-    // to the number of lines in the file
-    // report an error.
-    if(i != lineNumber){
-        printf("\n######################################\n");
-        printf("There was an error reading 'ukcities.txt' on line: %d\n\n", i);
-        printf("Please check each line of the file contains two,\n");
-        printf("tab-delimited, strings followed by an integer\n");
-        printf("and try again.\n");
-        printf("######################################\n\n");
-        exit(-1);
-    }
-
-    free(start);
-    free(end);
 }
 
 
@@ -580,7 +483,8 @@ void printAdjList(Graph* graph){
         printf("\n%s ->", graph->adjLists[i]->cityName);
         for (j = 0; j < graph->adjLists[i]->numberOfEdges; j++){
             // Print vertices connected to Vertex i
-            printf(" %d %s ->", graph->adjLists[i]->edges[j]->distance, graph->adjLists[i]->edges[j]->end->cityName);
+            printf(" %" DISTANCE_FORMAT " %s ->", (Distance)graph->adjLists[i]->edges[j].distance,
+                   graph->adjLists[graph->adjLists[i]->edges[j].end]->cityName);
         }
     }
     printf("\n");
@@ -597,6 +501,45 @@ int graphGetNumberOfCities(Graph* graph){
 }
 
 
+/*
+ * Function: graphGetNumberOfEdges
+ * -------------------------------
+ * Returns the number of Edges.
+ */
+int graphGetNumberOfEdges(Graph* graph){
+    return graph->numberOfEdges;
+}
+
+
+/*
+ * Function: graphGetBytesNeeded
+ * -----------------------------
+ * Adds up the size of every Vertex, Edge, city name
+ * and adjLists entry.
+ */
+size_t graphGetBytesNeeded(Graph* graph){
+
+    return graph->numberOfCities*(sizeof(Vertex) + sizeof(Vertex*))
+           + graph->numberOfEdges*sizeof(Edge)
+           + arenaGetBytesUsed(graph->stringPool);
+}
+
+
+/*
+ * Function: graphGetBytesReserved
+ * -------------------------------
+ * Adds up the blocks of both arenas, the capacity of
+ * adjLists and the name hash table.
+ */
+size_t graphGetBytesReserved(Graph* graph){
+
+    return arenaGetBytesReserved(graph->arena)
+           + arenaGetBytesReserved(graph->stringPool)
+           + graph->cityCapacity*sizeof(Vertex*)
+           + nameIndexGetBytesReserved(graph->cityIndex);
+}
+
+
 /*
  * Function: graphGetVertex
  * ------------------------
@@ -611,18 +554,15 @@ Vertex* graphGetVertex(Graph* graph, int vertexNumber){
 /*
  * Function: graphGetVertexNumber
  * ------------------------------
- * Linear searches through the vertices
- * comparing the char* string variable with
- * ones in the array. Returns it's index if known
- * and a -1 if not found.
+ * Looks up the char* string variable in the
+ * cityIndex hash table. Returns it's index if
+ * known and exits with an error if not found.
  */
 int graphGetVertexNumber(Graph* graph, char* string){
 
-    int i;
-    for(i = 0; i < graph->numberOfCities; i++){
-        if(!strcmp(graph->adjLists[i]->cityName, string)){
-            return i;
-        }
+    int vertexNumber = nameIndexFind(graph->cityIndex, string, strlen(string));
+    if(vertexNumber != -1){
+        return vertexNumber;
     }
     printf("\n#####################################\n");
     printf("Error, city name %s is not known.\n", string);
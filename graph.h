@@ -13,27 +13,34 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <stdio.h>
+#include <stddef.h>
+#include <weight.h>
+
 typedef struct Vertex Vertex;
 
 typedef struct Edge Edge;
 
 typedef struct Graph Graph;
 
+// One line of the ukcities file. The names need not be
+// null-terminated and are copied by graphAddRoads().
+typedef struct RoadRecord{
+    const char* start;
+    int startLength;
+    const char* end;
+    int endLength;
+    Weight distance;
+} RoadRecord;
+
 /*
  * Function: vertexConstructor
  * ---------------------------
- * Constructs a Vertex using a provided number
- * and city name and vertexNumber. Returns a pointer.
+ * Constructs a Vertex in the Graph's arena using a
+ * provided number and the first length characters of
+ * a city name. Returns a pointer.
  */
-Vertex* vertexConstructor(int vertexNumber, char* cityName);
-
-
-/*
- * Function: vertexGetDistanceFromSource
- * -------------------------------------
- * Returns the value of distanceFromSource.
- */
-int vertexGetDistanceFromSource(Vertex* vertex);
+Vertex* vertexConstructor(Graph* graph, int vertexNumber, const char* cityName, int length);
 
 
 /*
@@ -52,80 +59,6 @@ int vertexGetVertexNumber(Vertex* vertex);
 char* vertexGetCityName(Vertex* vertex);
 
 
-/*
- * Function: vertexGetPreviousCityName
- * -----------------------------------
- * Returns a Vertex's previous cityName
- */
-char* vertexGetPreviousCityName(Vertex* vertex);
-
-
-/*
- * Function: vertexGetPrevious
- * ---------------------------
- * Returns a pointer to the previous Vertex
- */
-Vertex* vertexGetPrevious(Vertex* vertex);
-
-
-/*
- * Function: vertexIsVisited
- * -------------------------
- * Returns the value of visited, used
- * like a boolean true or false.
- */
-int vertexIsVisited(Vertex* vertex);
-
-
-/*
- * Function: vertexSetIsVisited
- * ----------------------------
- * Used to set a vertex as visited.
- */
-void vertexSetIsVisited(Vertex* vertex);
-
-
-/*
- * Function: vertexSetIsNotVisited
- * -------------------------------
- * Used to set a vertex as not visited.
- */
-void vertexSetIsNotVisited(Vertex* vertex);
-
-
-/*
- * Function: vertexSetPositionInHeap
- * ---------------------------------
- * Send a integer value to assign position in heap.
- */
-void vertexSetPositionInHeap(Vertex* vertex, int position);
-
-
-/*
- * Function: vertexGetPositionInHeap
- * ---------------------------------
- * Returns index of associated node in heap.
- */
-int vertexGetPositionInHeap(Vertex* vertex);
-
-
-/*
- * Function: vertexSetDistanceFromSource
- * -------------------------------------
- * Distance from the chosen source Vertex.
- */
-void vertexSetDistanceFromSource(Vertex* vertex, int distance);
-
-
-/*
- * Function: vertexSetPrevious
- * ---------------------------
- * Setting the pointer to the previous Vertex.
- * Must send to Vertex Pointers into function.
- */
-void vertexSetPrevious(Vertex* currentVertex, Vertex* previousVertex);
-
-
 /*
  * Function: vertexGetNumberOfEdges
  * --------------------------------
@@ -144,11 +77,11 @@ Edge* vertexGetEdge(Vertex* vertex, int edgeNumber);
 
 
 /*
- * Function: edgeGetEndVertex
- * --------------------------
- * Returns a pointer to the end Vertex of an Edge.
+ * Function: edgeGetEndVertexNumber
+ * --------------------------------
+ * Returns the vertex number of the end Vertex of an Edge.
  */
-Vertex* edgeGetEndVertex(Edge* edge);
+int edgeGetEndVertexNumber(Edge* edge);
 
 
 /*
@@ -156,7 +89,7 @@ Vertex* edgeGetEndVertex(Edge* edge);
  * -------------------------
  * Returns the distance value associated with an Edge.
  */
-int edgeGetDistance(Edge* edge);
+Weight edgeGetDistance(Edge* edge);
 
 
 /*
@@ -170,7 +103,8 @@ Graph* graphConstructor();
 /*
  * Function: graphDestructor
  * -------------------------
- * Frees dynamically allocated memory of Graph.
+ * Frees dynamically allocated memory of Graph,
+ * including every Vertex, Edge and city name.
  */
 void graphDestructor(Graph* graph);
 
@@ -180,12 +114,36 @@ void graphDestructor(Graph* graph);
  * ----------------------------
  * Must send in a tab-delimited file that contains
  * two tab-delimited strings followed by a tab-delimited
- * integer and each line terminating in \r then \n.
- * Will fill graph with vertices and edges.
+ * integer and each line terminating in \n or \r then \n.
+ * Will fill graph with vertices and edges. The file is
+ * read once from its current position so it may be a pipe.
  */
 void graphPopulateGraph(Graph* graph, FILE* ukcities);
 
 
+/*
+ * Function: graphPopulateGraphFromMemory
+ * --------------------------------------
+ * Same as graphPopulateGraph but reads the text of
+ * the file from memory, such as a mapped file.
+ */
+void graphPopulateGraphFromMemory(Graph* graph, const char* data, size_t size);
+
+
+/*
+ * Function: graphAddRoads
+ * -----------------------
+ * Adds a batch of roads to the Graph, creating a Vertex
+ * for each city not seen before. The records and the names
+ * they point to may be reused once it returns, so a caller
+ * can stream any number of roads through a fixed buffer.
+ * Stops at the first road with an empty city name or a
+ * distance that is not positive and returns its index,
+ * otherwise returns numberOfRoads.
+ */
+int graphAddRoads(Graph* graph, const RoadRecord* roads, int numberOfRoads);
+
+
 /*
  * Function: printAdjList
  * ----------------------
@@ -202,6 +160,37 @@ void printAdjList(Graph* graph);
 int graphGetNumberOfCities(Graph* graph);
 
 
+/*
+ * Function: graphGetNumberOfEdges
+ * -------------------------------
+ * Returns the number of Edges, two for every road.
+ */
+int graphGetNumberOfEdges(Graph* graph);
+
+
+/*
+ * Function: graphGetBytesNeeded
+ * -----------------------------
+ * Returns the bytes the Vertices, Edges, city names and
+ * adjLists would take if every array were exactly full.
+ */
+size_t graphGetBytesNeeded(Graph* graph);
+
+
+/*
+ * Function: graphGetBytesReserved
+ * -------------------------------
+ * Returns the bytes the Graph has actually allocated,
+ * including the name hash table and room left for growth.
+ * Arrays grow by doubling and the Edges left behind when
+ * a Vertex's edges array grows are not reused, so this is
+ * never more than about four times graphGetBytesNeeded()
+ * plus the name hash table and one arena block each for
+ * the Vertices and the names.
+ */
+size_t graphGetBytesReserved(Graph* graph);
+
+
 /*
  * Function: graphGetVertex
  * ------------------------
@@ -214,8 +203,9 @@ Vertex* graphGetVertex(Graph* graph, int vertexNumber);
 /*
  * Function: graphGetVertexNumber
  * ------------------------------
- * Returns it's index if known
- * and a -1 if not found.
+ * Uses the Graph's hash table of city names.
+ * Returns it's index if known and exits with
+ * an error if not found.
  */
 int graphGetVertexNumber(Graph* graph, char* string);
 
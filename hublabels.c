@@ -0,0 +1,518 @@
+/*
+ * hublabels.c
+ * -----------
+ *
+ * This file contains the functions for the HubLabels abstract data
+ * type, a distance oracle answering how far apart two cities are
+ * without searching the graph at all. Each vertex v has a label, a
+ * list of (hub, distance) entries giving its distance to a few other
+ * vertices, its hubs. The labels are built so that every two vertices
+ * share a hub on a shortest route between them, so their distance is
+ * the smallest total of the two distances to a hub in both labels.
+ * The entries of a label are sorted by hub, so a query is a single
+ * merge of the two lists looking for equal hubs.
+ *
+ * The labels come from a ContractionHierarchy. The vertices an
+ * upward search from v reaches, with their distances, form a label
+ * with the property above, as the highest ranked vertex of a shortest
+ * route is reached by the upward searches from both its ends. These
+ * are worked out from the highest rank down without searching: v's
+ * label is v itself at distance 0 plus the label of every upward
+ * neighbour u with the length of the edge to u added, keeping the
+ * shortest entry for each hub. An upward search also reaches hubs
+ * along routes that are not shortest, and those entries can never be
+ * the answer to a query, so an entry for hub h is dropped when the
+ * entries already found for v and the label of h give a shorter
+ * route from v to h. Labels of higher ranked vertices are always
+ * finished first, so the label of h is there to check against.
+ *
+ * The finished labels are packed one after another into two flat
+ * arrays, hubs and distances, with an offsets array giving where each
+ * starts, and written to a file in that form so it can be mapped back
+ * in and queried straight away. The file starts with a HubLabelsHeader
+ * followed by each section, every one starting on an 8 byte boundary:
+ *
+ *     offsets      (numberOfCities + 1) ints
+ *     hubs         numberOfEntries ints
+ *     distances    numberOfEntries Distances
+ *
+ * Hubs are vertex numbers, so the header also records the
+ * fingerprint of the graph and labels are only loaded for the same
+ * roads numbered the same way.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <hublabels.h>
+#include <mappedfile.h>
+
+#define HUB_LABELS_MAGIC "DJKHUBL" // 7 characters and the null-terminator
+#define BYTE_ORDER_MARK 0x01020304u
+#define SECTION_ALIGNMENT 8
+
+enum HubLabelsSection{
+    HUB_LABELS_OFFSETS,
+    HUB_LABELS_HUBS,
+    HUB_LABELS_DISTANCES,
+    NUMBER_OF_HUB_LABELS_SECTIONS
+};
+
+typedef struct HubLabels{
+
+    int numberOfCities;
+    long numberOfEntries;
+
+    // Label of vertex i is at offsets[i] to offsets[i + 1] - 1
+    // in the hubs and distances arrays, sorted by hub
+    const int* offsets;
+    const int* hubs;
+    const Distance* distances;
+
+    // File the arrays are mapped from, or NULL if they
+    // were malloced by hubLabelsConstructor()
+    MappedFile* mappedFile;
+
+} HubLabels;
+
+
+typedef struct HubLabelsHeader{
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark; // Reads back differently on the other byte order
+    uint32_t intSize;
+    uint32_t numberOfCities;
+    uint32_t numberOfEdges; // Of the graph the labels were made for
+    uint32_t weightType; // WEIGHT_TYPE of the program that wrote it
+    uint64_t numberOfEntries;
+    uint64_t fileSize;
+    uint64_t graphFingerprint; // See csrGraphGetFingerprint()
+
+    // Byte position and length of each section from the start of the file
+    uint64_t sectionStart[NUMBER_OF_HUB_LABELS_SECTIONS];
+    uint64_t sectionSize[NUMBER_OF_HUB_LABELS_SECTIONS];
+
+} HubLabelsHeader;
+
+
+typedef struct LabelEntry{
+
+    int hub;
+    Distance distance;
+
+} LabelEntry;
+
+
+// Internal function declarations
+int compareLabelEntries(const void* a, const void* b);
+uint64_t hubLabelsAlign(uint64_t position);
+void hubLabelsError(const char* path, const char* reason);
+
+
+/*
+ * Function: compareLabelEntries
+ * -----------------------------
+ * Orders LabelEntries by hub.
+ */
+int compareLabelEntries(const void* a, const void* b){
+
+    const LabelEntry* entryA = a;
+    const LabelEntry* entryB = b;
+
+    return entryA->hub < entryB->hub ? -1 : entryA->hub > entryB->hub;
+}
+
+
+/*
+ * Function: hubLabelsConstructor
+ * ------------------------------
+ * Takes the vertices from the highest rank down. The
+ * entries of each label are gathered in a distance array
+ * indexed by hub, with a list of the hubs touched so only
+ * those are reset, then checked against the labels of
+ * their hubs, sorted and kept until every label is done
+ * and they are packed into the flat arrays.
+ */
+HubLabels* hubLabelsConstructor(ContractionHierarchy* hierarchy){
+
+    int numberOfCities = contractionHierarchyGetNumberOfCities(hierarchy);
+    const int* upOffsets = contractionHierarchyGetOffsets(hierarchy);
+    const int* upTargets = contractionHierarchyGetTargets(hierarchy);
+    const Distance* upDistances = contractionHierarchyGetDistances(hierarchy);
+
+    LabelEntry** labels = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(LabelEntry*));
+    int* labelSizes = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    int* byRank = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    Distance* distance = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(Distance));
+    int* touched = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(int));
+    LabelEntry* kept = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(LabelEntry));
+
+    int i;
+    int j;
+    int k;
+    for(i = 0; i < numberOfCities; i++){
+        byRank[contractionHierarchyGetRank(hierarchy, i)] = i;
+        distance[i] = DISTANCE_INFINITY;
+    }
+
+    int v;
+    int u;
+    int hub;
+    int numberOfTouched;
+    int numberOfKept;
+    int isShortest;
+    long numberOfEntries = 0;
+    LabelEntry* label;
+
+    for(i = numberOfCities - 1; i >= 0; i--){
+
+        v = byRank[i];
+        distance[v] = 0;
+        touched[0] = v;
+        numberOfTouched = 1;
+
+        // Every upward neighbour's label, one edge further away
+        for(j = upOffsets[v]; j < upOffsets[v + 1]; j++){
+            u = upTargets[j];
+            for(k = 0; k < labelSizes[u]; k++){
+                hub = labels[u][k].hub;
+                if(DISTANCE_ADD(upDistances[j], labels[u][k].distance) < distance[hub]){
+                    if(distance[hub] == DISTANCE_INFINITY){
+                        touched[numberOfTouched] = hub;
+                        numberOfTouched++;
+                    }
+                    distance[hub] = DISTANCE_ADD(upDistances[j], labels[u][k].distance);
+                }
+            }
+        }
+
+        // Keep an entry only if no shorter route to its hub is known
+        numberOfKept = 0;
+        for(j = 0; j < numberOfTouched; j++){
+
+            hub = touched[j];
+            label = labels[hub];
+            isShortest = 1;
+
+            if(hub != v){
+                for(k = 0; k < labelSizes[hub]; k++){
+                    if(distance[label[k].hub] != DISTANCE_INFINITY
+                       && DISTANCE_ADD(distance[label[k].hub], label[k].distance) < distance[hub]){
+                        isShortest = 0;
+                        break;
+                    }
+                }
+            }
+
+            if(isShortest){
+                kept[numberOfKept].hub = hub;
+                kept[numberOfKept].distance = distance[hub];
+                numberOfKept++;
+            }
+        }
+
+        for(j = 0; j < numberOfTouched; j++){
+            distance[touched[j]] = DISTANCE_INFINITY;
+        }
+
+        qsort(kept, numberOfKept, sizeof(LabelEntry), compareLabelEntries);
+        labels[v] = malloc(numberOfKept*sizeof(LabelEntry));
+        memcpy(labels[v], kept, numberOfKept*sizeof(LabelEntry));
+        labelSizes[v] = numberOfKept;
+        numberOfEntries += numberOfKept;
+    }
+
+    if(numberOfEntries > INT_MAX){
+        printf("\n#####################################\n");
+        printf("Error, the hub labels have %ld entries,\n", numberOfEntries);
+        printf("more than can be counted with an int.\n");
+        printf("#####################################\n\n");
+        exit(-1);
+    }
+
+    int* offsets = malloc((numberOfCities + 1)*sizeof(int));
+    int* hubs = malloc((numberOfEntries > 0 ? numberOfEntries : 1)*sizeof(int));
+    Distance* distances = malloc((numberOfEntries > 0 ? numberOfEntries : 1)*sizeof(Distance));
+
+    offsets[0] = 0;
+    for(i = 0; i < numberOfCities; i++){
+        for(k = 0; k < labelSizes[i]; k++){
+            hubs[offsets[i] + k] = labels[i][k].hub;
+            distances[offsets[i] + k] = labels[i][k].distance;
+        }
+        offsets[i + 1] = offsets[i] + labelSizes[i];
+        free(labels[i]);
+    }
+
+    free(labels);
+    free(labelSizes);
+    free(byRank);
+    free(distance);
+    free(touched);
+    free(kept);
+
+    HubLabels* newLabels = malloc(sizeof(HubLabels));
+
+    newLabels->numberOfCities = numberOfCities;
+    newLabels->numberOfEntries = numberOfEntries;
+    newLabels->offsets = offsets;
+    newLabels->hubs = hubs;
+    newLabels->distances = distances;
+    newLabels->mappedFile = NULL;
+
+    return newLabels;
+}
+
+
+/*
+ * Function: hubLabelsDestructor
+ * -----------------------------
+ * Frees the arrays if they were malloced or unmaps
+ * the file they came from, then the HubLabels.
+ */
+void hubLabelsDestructor(HubLabels* labels){
+
+    if(labels->mappedFile != NULL){
+        mappedFileClose(labels->mappedFile);
+    } else {
+        free((int*)labels->offsets);
+        free((int*)labels->hubs);
+        free((Distance*)labels->distances);
+    }
+    free(labels);
+}
+
+
+/*
+ * Function: hubLabelsGetNumberOfEntries
+ * -------------------------------------
+ * Returns the number of entries.
+ */
+long hubLabelsGetNumberOfEntries(HubLabels* labels){
+    return labels->numberOfEntries;
+}
+
+
+/*
+ * Function: hubLabelsGetDistance
+ * ------------------------------
+ * Walks both labels in order of hub, moving on in
+ * whichever has the smaller hub, and adds up the two
+ * distances whenever the hubs are equal.
+ */
+Distance hubLabelsGetDistance(HubLabels* labels, int sourceVertexNumber, int targetVertexNumber){
+
+    const int* hubs = labels->hubs;
+    const Distance* distances = labels->distances;
+
+    int i = labels->offsets[sourceVertexNumber];
+    int iEnd = labels->offsets[sourceVertexNumber + 1];
+    int j = labels->offsets[targetVertexNumber];
+    int jEnd = labels->offsets[targetVertexNumber + 1];
+    Distance bestDistance = DISTANCE_INFINITY;
+
+    while(i < iEnd && j < jEnd){
+        if(hubs[i] < hubs[j]){
+            i++;
+        } else if(hubs[i] > hubs[j]){
+            j++;
+        } else {
+            if(DISTANCE_ADD(distances[i], distances[j]) < bestDistance){
+                bestDistance = DISTANCE_ADD(distances[i], distances[j]);
+            }
+            i++;
+            j++;
+        }
+    }
+
+    return bestDistance;
+}
+
+
+/*
+ * Function: hubLabelsGetDistanceBetweenCities
+ * -------------------------------------------
+ * Looks up both vertex numbers, then the distance.
+ */
+Distance hubLabelsGetDistanceBetweenCities(HubLabels* labels, CsrGraph* csrGraph,
+                                           const char* sourceName, const char* targetName){
+
+    int sourceVertexNumber = csrGraphGetVertexNumber(csrGraph, sourceName, strlen(sourceName));
+    int targetVertexNumber = csrGraphGetVertexNumber(csrGraph, targetName, strlen(targetName));
+
+    if(sourceVertexNumber == -1 || targetVertexNumber == -1){
+        return -1;
+    }
+    return hubLabelsGetDistance(labels, sourceVertexNumber, targetVertexNumber);
+}
+
+
+/*
+ * Function: hubLabelsAlign
+ * ------------------------
+ * Rounds a file position up to the next section boundary.
+ */
+uint64_t hubLabelsAlign(uint64_t position){
+    return (position + SECTION_ALIGNMENT - 1) & ~(uint64_t)(SECTION_ALIGNMENT - 1);
+}
+
+
+/*
+ * Function: hubLabelsError
+ * ------------------------
+ * Reports a hub labels file that can not be used and exits.
+ */
+void hubLabelsError(const char* path, const char* reason){
+
+    printf("\n#####################################\n");
+    printf("Error, can not load hub labels '%s'.\n", path);
+    printf("%s\n", reason);
+    printf("#####################################\n\n");
+    exit(-1);
+}
+
+
+/*
+ * Function: hubLabelsWrite
+ * ------------------------
+ * Fills in the header with the size and position of every
+ * section, then writes the header and sections in order
+ * with zero bytes padding each section to the next boundary.
+ */
+int hubLabelsWrite(HubLabels* labels, CsrGraph* csrGraph, const char* path){
+
+    const void* sectionData[NUMBER_OF_HUB_LABELS_SECTIONS];
+    HubLabelsHeader header;
+    memset(&header, 0, sizeof(HubLabelsHeader));
+
+    strcpy(header.magic, HUB_LABELS_MAGIC);
+    header.version = HUB_LABELS_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.intSize = sizeof(int);
+    header.weightType = WEIGHT_TYPE;
+    header.numberOfCities = labels->numberOfCities;
+    header.numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+    header.graphFingerprint = csrGraphGetFingerprint(csrGraph);
+    header.numberOfEntries = labels->numberOfEntries;
+
+    sectionData[HUB_LABELS_OFFSETS] = labels->offsets;
+    header.sectionSize[HUB_LABELS_OFFSETS] = (uint64_t)(labels->numberOfCities + 1)*sizeof(int);
+    sectionData[HUB_LABELS_HUBS] = labels->hubs;
+    header.sectionSize[HUB_LABELS_HUBS] = (uint64_t)labels->numberOfEntries*sizeof(int);
+    sectionData[HUB_LABELS_DISTANCES] = labels->distances;
+    header.sectionSize[HUB_LABELS_DISTANCES] = (uint64_t)labels->numberOfEntries*sizeof(Distance);
+
+    int i;
+    uint64_t position = hubLabelsAlign(sizeof(HubLabelsHeader));
+    for(i = 0; i < NUMBER_OF_HUB_LABELS_SECTIONS; i++){
+        header.sectionStart[i] = position;
+        position = hubLabelsAlign(position + header.sectionSize[i]);
+    }
+    header.fileSize = position;
+
+    FILE* file = fopen(path, "wb");
+    if(file == NULL){
+        return -1;
+    }
+
+    static const char padding[SECTION_ALIGNMENT] = {0};
+    int failed = 0;
+
+    failed |= fwrite(&header, sizeof(HubLabelsHeader), 1, file) != 1;
+    position = sizeof(HubLabelsHeader);
+
+    for(i = 0; i < NUMBER_OF_HUB_LABELS_SECTIONS; i++){
+        failed |= fwrite(padding, 1, header.sectionStart[i] - position, file) != header.sectionStart[i] - position;
+        failed |= fwrite(sectionData[i], 1, header.sectionSize[i], file) != header.sectionSize[i];
+        position = header.sectionStart[i] + header.sectionSize[i];
+    }
+    failed |= fwrite(padding, 1, header.fileSize - position, file) != header.fileSize - position;
+
+    failed |= fclose(file) != 0;
+    return failed ? -1 : 0;
+}
+
+
+/*
+ * Function: hubLabelsLoad
+ * -----------------------
+ * Maps the file and checks the header against this
+ * program and the CsrGraph, that every section lies
+ * inside the file with the size its counts imply, and
+ * that the offsets start and end where they should.
+ */
+HubLabels* hubLabelsLoad(const char* path, CsrGraph* csrGraph){
+
+    MappedFile* mappedFile = mappedFileOpen(path);
+    if(mappedFile == NULL){
+        hubLabelsError(path, "The file could not be opened.");
+    }
+
+    const char* data = mappedFileGetData(mappedFile);
+    size_t size = mappedFileGetSize(mappedFile);
+
+    if(size < sizeof(HubLabelsHeader)){
+        hubLabelsError(path, "The file is too short to hold hub labels.");
+    }
+
+    const HubLabelsHeader* header = (const HubLabelsHeader*)data;
+
+    if(memcmp(header->magic, HUB_LABELS_MAGIC, sizeof(HUB_LABELS_MAGIC))){
+        hubLabelsError(path, "The file does not hold hub labels.");
+    }
+    if(header->version != HUB_LABELS_VERSION){
+        hubLabelsError(path, "The hub labels were written by a different version, please build them again.");
+    }
+    if(header->byteOrderMark != BYTE_ORDER_MARK || header->intSize != sizeof(int)){
+        hubLabelsError(path, "The hub labels were written on a different kind of machine.");
+    }
+    if(header->weightType != WEIGHT_TYPE){
+        hubLabelsError(path, "The hub labels were written by a program compiled with different distance types.");
+    }
+    if(header->numberOfCities != (uint32_t)csrGraphGetNumberOfCities(csrGraph)
+       || header->numberOfEdges != (uint32_t)csrGraphGetNumberOfEdges(csrGraph)
+       || header->graphFingerprint != csrGraphGetFingerprint(csrGraph)){
+        hubLabelsError(path, "The hub labels were made for a different graph or numbering of its cities, please build them again.");
+    }
+    if(header->fileSize != size){
+        hubLabelsError(path, "The file is not the size recorded in its header.");
+    }
+
+    uint64_t numberOfCities = header->numberOfCities;
+    uint64_t numberOfEntries = header->numberOfEntries;
+    uint64_t expectedSize[NUMBER_OF_HUB_LABELS_SECTIONS];
+
+    expectedSize[HUB_LABELS_OFFSETS] = (numberOfCities + 1)*sizeof(int);
+    expectedSize[HUB_LABELS_HUBS] = numberOfEntries*sizeof(int);
+    expectedSize[HUB_LABELS_DISTANCES] = numberOfEntries*sizeof(Distance);
+
+    int i;
+    for(i = 0; i < NUMBER_OF_HUB_LABELS_SECTIONS; i++){
+        if(header->sectionSize[i] != expectedSize[i]
+           || header->sectionStart[i] % SECTION_ALIGNMENT != 0
+           || header->sectionStart[i] > size
+           || header->sectionSize[i] > size - header->sectionStart[i]){
+            hubLabelsError(path, "A section of the hub labels file is damaged.");
+        }
+    }
+
+    const int* offsets = (const int*)(data + header->sectionStart[HUB_LABELS_OFFSETS]);
+
+    if(numberOfEntries > INT_MAX || offsets[0] != 0 || (uint64_t)offsets[numberOfCities] != numberOfEntries){
+        hubLabelsError(path, "The arrays of the hub labels file do not fit together.");
+    }
+
+    HubLabels* newLabels = malloc(sizeof(HubLabels));
+
+    newLabels->numberOfCities = numberOfCities;
+    newLabels->numberOfEntries = numberOfEntries;
+    newLabels->offsets = offsets;
+    newLabels->hubs = (const int*)(data + header->sectionStart[HUB_LABELS_HUBS]);
+    newLabels->distances = (const Distance*)(data + header->sectionStart[HUB_LABELS_DISTANCES]);
+    newLabels->mappedFile = mappedFile;
+
+    return newLabels;
+}
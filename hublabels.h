@@ -0,0 +1,92 @@
+/*
+ * hublabels.h
+ * -----------
+ *
+ * The header file for hublabels.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <csrgraph.h>
+#include <contractionhierarchy.h>
+
+#define HUB_LABELS_VERSION 3 // Increased whenever the file layout changes
+
+typedef struct HubLabels HubLabels;
+
+/*
+ * Function: hubLabelsConstructor
+ * ------------------------------
+ * Builds a label for every vertex from the contraction
+ * order and upward edges of a ContractionHierarchy and
+ * returns a pointer to the HubLabels.
+ */
+HubLabels* hubLabelsConstructor(ContractionHierarchy* hierarchy);
+
+
+/*
+ * Function: hubLabelsDestructor
+ * -----------------------------
+ * Frees the HubLabels and their arrays, or unmaps the
+ * file they were loaded from.
+ */
+void hubLabelsDestructor(HubLabels* labels);
+
+
+/*
+ * Function: hubLabelsGetNumberOfEntries
+ * -------------------------------------
+ * Returns the total number of (hub, distance) entries
+ * in all labels.
+ */
+long hubLabelsGetNumberOfEntries(HubLabels* labels);
+
+
+/*
+ * Function: hubLabelsGetDistance
+ * ------------------------------
+ * Returns the shortest distance between two vertices, or
+ * DISTANCE_INFINITY if there is no route, by finding the
+ * hub their labels share with the smallest total
+ * distance. Only reads the two labels so any number of
+ * threads can query the same HubLabels at once.
+ */
+Distance hubLabelsGetDistance(HubLabels* labels, int sourceVertexNumber, int targetVertexNumber);
+
+
+/*
+ * Function: hubLabelsGetDistanceBetweenCities
+ * -------------------------------------------
+ * Same as hubLabelsGetDistance but the two cities are
+ * given by their null-terminated names, looked up in the
+ * CsrGraph the labels were built for. Returns -1 if
+ * either city is not known.
+ */
+Distance hubLabelsGetDistanceBetweenCities(HubLabels* labels, CsrGraph* csrGraph,
+                                           const char* sourceName, const char* targetName);
+
+
+/*
+ * Function: hubLabelsWrite
+ * ------------------------
+ * Writes the HubLabels to a flat binary file, to be kept
+ * next to the graph they were made for. Returns 0 on
+ * success and -1 if the file could not be written.
+ */
+int hubLabelsWrite(HubLabels* labels, CsrGraph* csrGraph, const char* path);
+
+
+/*
+ * Function: hubLabelsLoad
+ * -----------------------
+ * Maps a file written by hubLabelsWrite() read-only and
+ * returns HubLabels whose arrays point into the mapping.
+ * Exits with an error if the file is missing, damaged,
+ * of a different version or made for a graph with a
+ * different fingerprint, see csrGraphGetFingerprint().
+ */
+HubLabels* hubLabelsLoad(const char* path, CsrGraph* csrGraph);
+
+#endif
@@ -0,0 +1,405 @@
+/*
+ * landmarks.c
+ * -----------
+ *
+ * This file contains the functions for the Landmarks abstract data
+ * type, the preprocessing used by the A* search of
+ * dijkstrasCsrAlt(). A landmark is a vertex whose shortest distance
+ * to every other vertex has been found in advance. Every road goes
+ * both ways, so for a landmark L and any vertices v and t the
+ * triangle inequality gives
+ *
+ *     distance(v, t) >= |distance(L, t) - distance(L, v)|
+ *
+ * and the largest of these over all landmarks is a lower bound on
+ * the length of the route from v to t, found without any coordinates.
+ * Landmarks far out at the edges of the graph give the best bounds
+ * so each one is picked as the vertex furthest from those already
+ * picked, the first being the vertex furthest from vertex 0. A vertex
+ * no landmark can reach counts as furthest of all, so every separate
+ * part of the graph gets a landmark before any part gets a second.
+ *
+ * The distances are stored by vertex, the distances of vertex v to
+ * each landmark being next to each other, as a query reads all of
+ * them for one vertex at a time. DISTANCE_INFINITY marks a vertex
+ * a landmark can not reach.
+ *
+ * Finding the tables takes a full run of Dijkstra's per landmark so
+ * they can be written to a file and mapped back in later, like a
+ * snapshot. The file starts with a LandmarksHeader followed by
+ *
+ *     vertices     numberOfLandmarks ints
+ *     distances    numberOfCities*numberOfLandmarks Distances
+ *
+ * each starting on an 8 byte boundary. The fingerprint of the graph
+ * is recorded so tables made for different roads, or for the same
+ * roads with the cities numbered another way, are rejected, as is
+ * the Weight type, see weight.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <landmarks.h>
+#include <dijkstras.h>
+#include <dijkstraworkspace.h>
+#include <mappedfile.h>
+
+#define LANDMARKS_MAGIC "DJKLMRK" // 7 characters and the null-terminator
+#define BYTE_ORDER_MARK 0x01020304u
+#define SECTION_ALIGNMENT 8
+
+typedef struct Landmarks{
+
+    int numberOfLandmarks;
+    int numberOfCities;
+
+    const int* vertices; // Vertex number of each landmark
+
+    // Distance from landmark i to vertex v is at
+    // distances[v*numberOfLandmarks + i]
+    const Distance* distances;
+
+    // File the tables are mapped from, or NULL
+    // if they were malloced by landmarksConstructor()
+    MappedFile* mappedFile;
+
+} Landmarks;
+
+
+typedef struct LandmarksHeader{
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark; // Reads back differently on the other byte order
+    uint32_t intSize;
+    uint32_t weightType; // WEIGHT_TYPE of the program that wrote it
+    uint32_t numberOfLandmarks;
+    uint32_t numberOfCities;
+    uint32_t numberOfEdges;
+    uint32_t reserved;
+    uint64_t verticesStart;
+    uint64_t distancesStart;
+    uint64_t fileSize;
+    uint64_t graphFingerprint; // See csrGraphGetFingerprint()
+
+} LandmarksHeader;
+
+
+// Internal function declarations
+uint64_t landmarksAlign(uint64_t position);
+void landmarksError(const char* path, const char* reason);
+
+
+/*
+ * Function: landmarksAlign
+ * ------------------------
+ * Rounds a file position up to the next section boundary.
+ */
+uint64_t landmarksAlign(uint64_t position){
+    return (position + SECTION_ALIGNMENT - 1) & ~(uint64_t)(SECTION_ALIGNMENT - 1);
+}
+
+
+/*
+ * Function: landmarksError
+ * ------------------------
+ * Reports a landmarks file that can not be used and exits.
+ */
+void landmarksError(const char* path, const char* reason){
+
+    printf("\n#####################################\n");
+    printf("Error, can not load landmarks '%s'.\n", path);
+    printf("%s\n", reason);
+    printf("#####################################\n\n");
+    exit(-1);
+}
+
+
+/*
+ * Function: landmarksConstructor
+ * ------------------------------
+ * Keeps the distance from each vertex to its nearest
+ * landmark so far, starting with the distances from
+ * vertex 0. Each round the vertex with the largest such
+ * distance becomes the next landmark, Dijkstra's is run
+ * from it and its distances are copied into the table
+ * and used to lower the nearest distances. A landmark's
+ * own distance is set to -1 so it is never picked twice.
+ */
+Landmarks* landmarksConstructor(CsrGraph* csrGraph, int numberOfLandmarks){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+
+    if(numberOfLandmarks > numberOfCities){
+        numberOfLandmarks = numberOfCities;
+    }
+    if(numberOfLandmarks < 0){
+        numberOfLandmarks = 0;
+    }
+
+    Landmarks* newLandmarks = malloc(sizeof(Landmarks));
+    int* vertices = malloc((numberOfLandmarks > 0 ? numberOfLandmarks : 1)*sizeof(int));
+    Distance* distances = malloc(((size_t)numberOfCities*numberOfLandmarks > 0 ? (size_t)numberOfCities*numberOfLandmarks : 1)*sizeof(Distance));
+    Distance* nearestDistance = malloc((numberOfCities > 0 ? numberOfCities : 1)*sizeof(Distance));
+
+    DijkstraWorkspace* workspace = dijkstraWorkspaceConstructor(numberOfCities, MIN_HEAP_DEFAULT_TYPE);
+    const Distance* distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+
+    int i;
+    int v;
+    int furthest;
+
+    if(numberOfLandmarks > 0){
+        dijkstrasCsr(csrGraph, workspace, 0);
+        for(v = 0; v < numberOfCities; v++){
+            nearestDistance[v] = distanceFromSource[v];
+        }
+    }
+
+    for(i = 0; i < numberOfLandmarks; i++){
+
+        // Unreached vertices have DISTANCE_INFINITY so are picked first
+        furthest = 0;
+        for(v = 1; v < numberOfCities; v++){
+            if(nearestDistance[v] > nearestDistance[furthest]){
+                furthest = v;
+            }
+        }
+
+        vertices[i] = furthest;
+        dijkstrasCsr(csrGraph, workspace, furthest);
+
+        for(v = 0; v < numberOfCities; v++){
+            distances[(size_t)v*numberOfLandmarks + i] = distanceFromSource[v];
+
+            // The first landmark replaces the distances from vertex 0
+            if(i == 0 || distanceFromSource[v] < nearestDistance[v]){
+                nearestDistance[v] = distanceFromSource[v];
+            }
+        }
+        nearestDistance[furthest] = -1;
+    }
+
+    dijkstraWorkspaceDestructor(workspace);
+    free(nearestDistance);
+
+    newLandmarks->numberOfLandmarks = numberOfLandmarks;
+    newLandmarks->numberOfCities = numberOfCities;
+    newLandmarks->vertices = vertices;
+    newLandmarks->distances = distances;
+    newLandmarks->mappedFile = NULL;
+
+    return newLandmarks;
+}
+
+
+/*
+ * Function: landmarksDestructor
+ * -----------------------------
+ * Frees the tables if they were malloced or unmaps
+ * the file they came from, then the Landmarks.
+ */
+void landmarksDestructor(Landmarks* landmarks){
+
+    if(landmarks->mappedFile != NULL){
+        mappedFileClose(landmarks->mappedFile);
+    } else {
+        free((int*)landmarks->vertices);
+        free((Distance*)landmarks->distances);
+    }
+    free(landmarks);
+}
+
+
+/*
+ * Function: landmarksGetNumberOfLandmarks
+ * ---------------------------------------
+ * Returns the number of landmarks.
+ */
+int landmarksGetNumberOfLandmarks(Landmarks* landmarks){
+    return landmarks->numberOfLandmarks;
+}
+
+
+/*
+ * Function: landmarksGetVertexNumber
+ * ----------------------------------
+ * Returns the vertex number of a landmark.
+ */
+int landmarksGetVertexNumber(Landmarks* landmarks, int landmark){
+    return landmarks->vertices[landmark];
+}
+
+
+/*
+ * Function: landmarksGetLowerBound
+ * --------------------------------
+ * Takes the largest difference between the two vertices'
+ * distances to each landmark. If a landmark reaches one
+ * vertex but not the other they are in separate parts
+ * of the graph.
+ */
+Distance landmarksGetLowerBound(Landmarks* landmarks, int vertexNumber, int targetVertexNumber){
+
+    const Distance* fromVertex = landmarks->distances + (size_t)vertexNumber*landmarks->numberOfLandmarks;
+    const Distance* fromTarget = landmarks->distances + (size_t)targetVertexNumber*landmarks->numberOfLandmarks;
+    Distance lowerBound = 0;
+    Distance difference;
+
+    int i;
+    for(i = 0; i < landmarks->numberOfLandmarks; i++){
+
+        if(fromVertex[i] == DISTANCE_INFINITY || fromTarget[i] == DISTANCE_INFINITY){
+            if(fromVertex[i] != fromTarget[i]){
+                return DISTANCE_INFINITY;
+            }
+            continue;
+        }
+
+        difference = fromTarget[i] - fromVertex[i];
+        if(difference < 0){
+            difference = -difference;
+        }
+        if(difference > lowerBound){
+            lowerBound = difference;
+        }
+    }
+
+    return lowerBound;
+}
+
+
+/*
+ * Function: landmarksWrite
+ * ------------------------
+ * Fills in the header and writes it followed by the
+ * two tables, padded to the section boundaries.
+ */
+int landmarksWrite(Landmarks* landmarks, CsrGraph* csrGraph, const char* path){
+
+    LandmarksHeader header;
+    memset(&header, 0, sizeof(LandmarksHeader));
+
+    uint64_t verticesSize = (uint64_t)landmarks->numberOfLandmarks*sizeof(int);
+    uint64_t distancesSize = (uint64_t)landmarks->numberOfCities*landmarks->numberOfLandmarks*sizeof(Distance);
+
+    strcpy(header.magic, LANDMARKS_MAGIC);
+    header.version = LANDMARKS_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.intSize = sizeof(int);
+    header.weightType = WEIGHT_TYPE;
+    header.numberOfLandmarks = landmarks->numberOfLandmarks;
+    header.numberOfCities = landmarks->numberOfCities;
+    header.numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+    header.graphFingerprint = csrGraphGetFingerprint(csrGraph);
+    header.verticesStart = landmarksAlign(sizeof(LandmarksHeader));
+    header.distancesStart = landmarksAlign(header.verticesStart + verticesSize);
+    header.fileSize = landmarksAlign(header.distancesStart + distancesSize);
+
+    FILE* file = fopen(path, "wb");
+    if(file == NULL){
+        return -1;
+    }
+
+    static const char padding[SECTION_ALIGNMENT] = {0};
+    uint64_t paddingSize;
+    int failed = 0;
+
+    failed |= fwrite(&header, sizeof(LandmarksHeader), 1, file) != 1;
+
+    paddingSize = header.verticesStart - sizeof(LandmarksHeader);
+    failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+    failed |= fwrite(landmarks->vertices, 1, verticesSize, file) != verticesSize;
+
+    paddingSize = header.distancesStart - (header.verticesStart + verticesSize);
+    failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+    failed |= fwrite(landmarks->distances, 1, distancesSize, file) != distancesSize;
+
+    paddingSize = header.fileSize - (header.distancesStart + distancesSize);
+    failed |= fwrite(padding, 1, paddingSize, file) != paddingSize;
+
+    failed |= fclose(file) != 0;
+    return failed ? -1 : 0;
+}
+
+
+/*
+ * Function: landmarksLoad
+ * -----------------------
+ * Maps the file and checks the header against this
+ * program and the CsrGraph, and that both tables lie
+ * inside the file, then checks every landmark is a
+ * vertex of the graph at distance 0 from itself.
+ */
+Landmarks* landmarksLoad(const char* path, CsrGraph* csrGraph){
+
+    MappedFile* mappedFile = mappedFileOpen(path);
+    if(mappedFile == NULL){
+        landmarksError(path, "The file could not be opened.");
+    }
+
+    const char* data = mappedFileGetData(mappedFile);
+    size_t size = mappedFileGetSize(mappedFile);
+
+    if(size < sizeof(LandmarksHeader)){
+        landmarksError(path, "The file is too short to hold landmarks.");
+    }
+
+    const LandmarksHeader* header = (const LandmarksHeader*)data;
+
+    if(memcmp(header->magic, LANDMARKS_MAGIC, sizeof(LANDMARKS_MAGIC))){
+        landmarksError(path, "The file does not hold landmarks.");
+    }
+    if(header->version != LANDMARKS_VERSION){
+        landmarksError(path, "The landmarks were written by a different version, please make them again.");
+    }
+    if(header->byteOrderMark != BYTE_ORDER_MARK || header->intSize != sizeof(int)){
+        landmarksError(path, "The landmarks were written on a different kind of machine.");
+    }
+    if(header->weightType != WEIGHT_TYPE){
+        landmarksError(path, "The landmarks were written by a program compiled with different distance types.");
+    }
+    if(header->numberOfCities != (uint32_t)csrGraphGetNumberOfCities(csrGraph)
+       || header->numberOfEdges != (uint32_t)csrGraphGetNumberOfEdges(csrGraph)
+       || header->graphFingerprint != csrGraphGetFingerprint(csrGraph)){
+        landmarksError(path, "The landmarks were made for a different graph or numbering of its cities, please make them again.");
+    }
+    if(header->fileSize != size){
+        landmarksError(path, "The file is not the size recorded in its header.");
+    }
+
+    uint64_t numberOfLandmarks = header->numberOfLandmarks;
+    uint64_t verticesSize = numberOfLandmarks*sizeof(int);
+    uint64_t distancesSize = (uint64_t)header->numberOfCities*numberOfLandmarks*sizeof(Distance);
+
+    if(numberOfLandmarks > header->numberOfCities
+       || header->verticesStart % SECTION_ALIGNMENT != 0 || header->distancesStart % SECTION_ALIGNMENT != 0
+       || header->verticesStart < sizeof(LandmarksHeader) || header->verticesStart > size
+       || verticesSize > size - header->verticesStart
+       || header->distancesStart > size || distancesSize > size - header->distancesStart){
+        landmarksError(path, "A section of the landmarks file is damaged.");
+    }
+
+    const int* vertices = (const int*)(data + header->verticesStart);
+    const Distance* distances = (const Distance*)(data + header->distancesStart);
+
+    uint64_t i;
+    for(i = 0; i < numberOfLandmarks; i++){
+        if(vertices[i] < 0 || (uint64_t)vertices[i] >= header->numberOfCities
+           || distances[(uint64_t)vertices[i]*numberOfLandmarks + i] != 0){
+            landmarksError(path, "The tables of the landmarks file do not fit together.");
+        }
+    }
+
+    Landmarks* newLandmarks = malloc(sizeof(Landmarks));
+
+    newLandmarks->numberOfLandmarks = numberOfLandmarks;
+    newLandmarks->numberOfCities = header->numberOfCities;
+    newLandmarks->vertices = vertices;
+    newLandmarks->distances = distances;
+    newLandmarks->mappedFile = mappedFile;
+
+    return newLandmarks;
+}
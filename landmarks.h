@@ -0,0 +1,88 @@
+/*
+ * landmarks.h
+ * -----------
+ *
+ * The header file for landmarks.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <csrgraph.h>
+
+#define LANDMARKS_VERSION 3 // Increased whenever the file layout changes
+
+typedef struct Landmarks Landmarks;
+
+/*
+ * Function: landmarksConstructor
+ * ------------------------------
+ * Picks numberOfLandmarks vertices of the CsrGraph, each
+ * as far as possible from those already picked, and runs
+ * Dijkstra's from every one to store its distance to all
+ * vertices. Returns a pointer to the Landmarks. Takes one
+ * full run of Dijkstra's per landmark plus one more.
+ */
+Landmarks* landmarksConstructor(CsrGraph* csrGraph, int numberOfLandmarks);
+
+
+/*
+ * Function: landmarksDestructor
+ * -----------------------------
+ * Frees the Landmarks and their tables, or unmaps the
+ * file they were loaded from.
+ */
+void landmarksDestructor(Landmarks* landmarks);
+
+
+/*
+ * Function: landmarksGetNumberOfLandmarks
+ * ---------------------------------------
+ * Returns the number of landmarks.
+ */
+int landmarksGetNumberOfLandmarks(Landmarks* landmarks);
+
+
+/*
+ * Function: landmarksGetVertexNumber
+ * ----------------------------------
+ * Returns the vertex number of a landmark.
+ */
+int landmarksGetVertexNumber(Landmarks* landmarks, int landmark);
+
+
+/*
+ * Function: landmarksGetLowerBound
+ * --------------------------------
+ * Returns a distance the shortest route between two
+ * vertices can not be shorter than, worked out from their
+ * distances to each landmark by the triangle inequality.
+ * Returns DISTANCE_INFINITY if a landmark shows they
+ * are not connected at all.
+ */
+Distance landmarksGetLowerBound(Landmarks* landmarks, int vertexNumber, int targetVertexNumber);
+
+
+/*
+ * Function: landmarksWrite
+ * ------------------------
+ * Writes the landmark tables to a binary file, to be kept
+ * next to the graph they were made for. Returns 0 on
+ * success and -1 if the file could not be written.
+ */
+int landmarksWrite(Landmarks* landmarks, CsrGraph* csrGraph, const char* path);
+
+
+/*
+ * Function: landmarksLoad
+ * -----------------------
+ * Maps a file written by landmarksWrite() read-only and
+ * returns Landmarks whose tables point into the mapping.
+ * Exits with an error if the file is missing, damaged,
+ * of a different version or made for a graph with a
+ * different fingerprint, see csrGraphGetFingerprint().
+ */
+Landmarks* landmarksLoad(const char* path, CsrGraph* csrGraph);
+
+#endif
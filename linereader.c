@@ -0,0 +1,300 @@
+/*
+ * linereader.c
+ * ------------
+ *
+ * This file contains the functions for the LineReader abstract
+ * data type, a single pass tokenizer for the tab-delimited input
+ * files. Rather than counting the lines of a file, rewinding it and
+ * reading it again one character at a time with fscanf, a LineReader
+ * looks for the end of each line and the tabs within it with memchr
+ * and records where each field starts and how long it is. Fields are
+ * never copied, they point straight into either the caller's memory,
+ * for example a mapped file, or into a large buffer that is refilled
+ * from a FILE with fread. When a line runs past the end of the buffer
+ * the unread part is moved to the front before refilling, and if a
+ * single line is longer than the whole buffer the buffer is doubled.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <linereader.h>
+
+#define BUFFER_SIZE 1048576 // Bytes read from a FILE at a time
+
+typedef struct LineReader{
+
+    FILE* file; // NULL when reading from memory
+    char* buffer; // Owned buffer when reading from a FILE
+    size_t bufferSize;
+
+    // Unread text is from position up to end
+    const char* position;
+    const char* end;
+    int endOfInput; // Set once the FILE has no more to read
+
+    // Fields of the current line
+    const char* fields[LINE_READER_MAX_FIELDS];
+    int lengths[LINE_READER_MAX_FIELDS];
+    int numberOfFields;
+    long lineNumber;
+
+} LineReader;
+
+
+// Internal function declarations
+int lineReaderRefill(LineReader* lineReader);
+void lineReaderSplitLine(LineReader* lineReader, const char* start, const char* lineEnd);
+
+
+/*
+ * Function: lineReaderConstructor
+ * -------------------------------
+ * Constructs a LineReader with an empty buffer, the
+ * first call to lineReaderNextLine() fills it.
+ */
+LineReader* lineReaderConstructor(FILE* file){
+
+    LineReader* newLineReader = malloc(sizeof(LineReader));
+
+    newLineReader->file = file;
+    newLineReader->bufferSize = BUFFER_SIZE;
+    newLineReader->buffer = malloc(BUFFER_SIZE);
+    newLineReader->position = newLineReader->buffer;
+    newLineReader->end = newLineReader->buffer;
+    newLineReader->endOfInput = 0;
+    newLineReader->numberOfFields = 0;
+    newLineReader->lineNumber = 0;
+    return newLineReader;
+}
+
+
+/*
+ * Function: lineReaderConstructorFromMemory
+ * -----------------------------------------
+ * Constructs a LineReader whose unread text is
+ * the whole of the memory given.
+ */
+LineReader* lineReaderConstructorFromMemory(const char* data, size_t size){
+
+    LineReader* newLineReader = malloc(sizeof(LineReader));
+
+    newLineReader->file = NULL;
+    newLineReader->buffer = NULL;
+    newLineReader->bufferSize = 0;
+    newLineReader->position = data;
+    newLineReader->end = data + size;
+    newLineReader->endOfInput = 1;
+    newLineReader->numberOfFields = 0;
+    newLineReader->lineNumber = 0;
+    return newLineReader;
+}
+
+
+/*
+ * Function: lineReaderDestructor
+ * ------------------------------
+ * Frees the buffer, if any, and the LineReader.
+ */
+void lineReaderDestructor(LineReader* lineReader){
+
+    free(lineReader->buffer);
+    free(lineReader);
+}
+
+
+/*
+ * Function: lineReaderRefill
+ * --------------------------
+ * Moves the unread text to the front of the buffer, doubling
+ * the buffer if it is already full of a single line, and reads
+ * as much more of the FILE as fits. Returns 0 once nothing
+ * more can be read.
+ */
+int lineReaderRefill(LineReader* lineReader){
+
+    if(lineReader->endOfInput){
+        return 0;
+    }
+
+    size_t unread = lineReader->end - lineReader->position;
+
+    if(unread == lineReader->bufferSize){
+        lineReader->bufferSize *= 2;
+        char* newBuffer = malloc(lineReader->bufferSize);
+        memcpy(newBuffer, lineReader->position, unread);
+        free(lineReader->buffer);
+        lineReader->buffer = newBuffer;
+    } else if(unread > 0){
+        memmove(lineReader->buffer, lineReader->position, unread);
+    }
+
+    size_t bytesRead = fread(lineReader->buffer + unread, 1, lineReader->bufferSize - unread, lineReader->file);
+    if(bytesRead == 0){
+        lineReader->endOfInput = 1;
+    }
+
+    lineReader->position = lineReader->buffer;
+    lineReader->end = lineReader->buffer + unread + bytesRead;
+    return bytesRead > 0;
+}
+
+
+/*
+ * Function: lineReaderSplitLine
+ * -----------------------------
+ * Records the start and length of each tab-delimited field
+ * between start and lineEnd, which excludes the line ending.
+ */
+void lineReaderSplitLine(LineReader* lineReader, const char* start, const char* lineEnd){
+
+    const char* tab;
+
+    lineReader->numberOfFields = 0;
+
+    while(start < lineEnd && lineReader->numberOfFields < LINE_READER_MAX_FIELDS){
+        tab = memchr(start, '\t', lineEnd - start);
+        if(tab == NULL){
+            tab = lineEnd;
+        }
+        lineReader->fields[lineReader->numberOfFields] = start;
+        lineReader->lengths[lineReader->numberOfFields] = tab - start;
+        lineReader->numberOfFields++;
+
+        // A tab right at the end of the line does not start a field
+        start = tab + 1;
+    }
+}
+
+
+/*
+ * Function: lineReaderNextLine
+ * ----------------------------
+ * Finds the next newline in the unread text, refilling the
+ * buffer if there is none, strips a \r before it and splits
+ * the line into fields. The last line of the input does not
+ * need a newline. Empty lines are counted but skipped.
+ */
+int lineReaderNextLine(LineReader* lineReader){
+
+    const char* newline;
+    const char* lineStart;
+    const char* lineEnd;
+
+    while(1){
+        newline = memchr(lineReader->position, '\n', lineReader->end - lineReader->position);
+
+        if(newline == NULL){
+            if(lineReaderRefill(lineReader)){
+                continue;
+            }
+            // Nothing more to read, any text left is the last line
+            if(lineReader->position == lineReader->end){
+                lineReader->numberOfFields = 0;
+                return 0;
+            }
+            newline = lineReader->end;
+        }
+
+        lineStart = lineReader->position;
+        lineEnd = newline;
+        lineReader->position = newline < lineReader->end ? newline + 1 : newline;
+        lineReader->lineNumber++;
+
+        if(lineEnd > lineStart && lineEnd[-1] == '\r'){
+            lineEnd--;
+        }
+
+        if(lineEnd > lineStart){
+            lineReaderSplitLine(lineReader, lineStart, lineEnd);
+            return 1;
+        }
+    }
+}
+
+
+/*
+ * Function: lineReaderGetNumberOfFields
+ * -------------------------------------
+ * Returns the number of fields on the current line.
+ */
+int lineReaderGetNumberOfFields(LineReader* lineReader){
+    return lineReader->numberOfFields;
+}
+
+
+/*
+ * Function: lineReaderGetField
+ * ----------------------------
+ * Returns a pointer to the start of a field and its length.
+ */
+const char* lineReaderGetField(LineReader* lineReader, int fieldNumber, int* length){
+
+    *length = lineReader->lengths[fieldNumber];
+    return lineReader->fields[fieldNumber];
+}
+
+
+/*
+ * Function: lineReaderGetLineNumber
+ * ---------------------------------
+ * Returns the line number of the current line.
+ */
+long lineReaderGetLineNumber(LineReader* lineReader){
+    return lineReader->lineNumber;
+}
+
+
+/*
+ * Function: lineReaderParseWeight
+ * -------------------------------
+ * Accumulates the digits of a whole number Weight checking
+ * against the largest Weight before each multiply and add.
+ * A float Weight is read by strtod from a null-terminated
+ * copy of the field, which must be used up. A negative number gives 0 as a Weight may not
+ * be able to hold it, and callers report it with zero.
+ */
+int lineReaderParseWeight(const char* field, int length, Weight* value){
+
+    int negative = length > 0 && field[0] == '-';
+    int i = negative;
+
+    if(length == i){
+        return -1;
+    }
+
+#if WEIGHT_IS_WHOLE
+    Weight result = 0;
+    int digit;
+
+    for(; i < length; i++){
+        if(field[i] < '0' || field[i] > '9'){
+            return -1;
+        }
+        digit = field[i] - '0';
+        if(result > (WEIGHT_MAXIMUM - digit)/10){
+            return -1;
+        }
+        result = 10*result + digit;
+    }
+#else
+    char number[64];
+    char* numberEnd;
+
+    if(length >= (int)sizeof(number)){
+        return -1;
+    }
+    memcpy(number, field + i, length - i);
+    number[length - i] = '\0';
+
+    double result = strtod(number, &numberEnd);
+
+    // Also turns away nan and inf
+    if(numberEnd != number + length - i || !(result <= WEIGHT_MAXIMUM)){
+        return -1;
+    }
+#endif
+
+    *value = negative ? 0 : result;
+    return 0;
+}
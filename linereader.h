@@ -0,0 +1,99 @@
+/*
+ * linereader.h
+ * ------------
+ *
+ * The header file for linereader.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef LINEREADER_H
+#define LINEREADER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <weight.h>
+
+#define LINE_READER_MAX_FIELDS 8 // Fields after this are ignored
+
+typedef struct LineReader LineReader;
+
+/*
+ * Function: lineReaderConstructor
+ * -------------------------------
+ * Constructs a LineReader that reads a file through a large
+ * buffer in a single pass. The file does not need to be
+ * seekable so pipes and stdin work too.
+ */
+LineReader* lineReaderConstructor(FILE* file);
+
+
+/*
+ * Function: lineReaderConstructorFromMemory
+ * -----------------------------------------
+ * Constructs a LineReader over text that is already in
+ * memory, such as a mapped file. The text is not copied
+ * or modified.
+ */
+LineReader* lineReaderConstructorFromMemory(const char* data, size_t size);
+
+
+/*
+ * Function: lineReaderDestructor
+ * ------------------------------
+ * Frees the LineReader and its buffer. Does not close the file.
+ */
+void lineReaderDestructor(LineReader* lineReader);
+
+
+/*
+ * Function: lineReaderNextLine
+ * ----------------------------
+ * Moves on to the next line that is not empty and splits it
+ * into tab-delimited fields. Lines may end in \n or \r\n and
+ * a tab at the end of a line does not start another field.
+ * Returns 1 if a line was read and 0 at the end of the input.
+ */
+int lineReaderNextLine(LineReader* lineReader);
+
+
+/*
+ * Function: lineReaderGetNumberOfFields
+ * -------------------------------------
+ * Returns the number of fields on the current line.
+ */
+int lineReaderGetNumberOfFields(LineReader* lineReader);
+
+
+/*
+ * Function: lineReaderGetField
+ * ----------------------------
+ * Returns a pointer to the start of a field of the current
+ * line and its length through the length pointer. The field
+ * is not null-terminated and is only valid until the next
+ * call to lineReaderNextLine().
+ */
+const char* lineReaderGetField(LineReader* lineReader, int fieldNumber, int* length);
+
+
+/*
+ * Function: lineReaderGetLineNumber
+ * ---------------------------------
+ * Returns the line number of the current line, counting
+ * from one and including any empty lines skipped.
+ */
+long lineReaderGetLineNumber(LineReader* lineReader);
+
+
+/*
+ * Function: lineReaderParseWeight
+ * -------------------------------
+ * Converts a field holding a road length into a Weight, see
+ * weight.h, decimal digits optionally starting with a minus
+ * sign or for a float Weight any decimal number. Returns 0
+ * on success, setting a negative length to 0, and -1 if the
+ * field is empty, contains anything else or is too long for
+ * a Weight.
+ */
+int lineReaderParseWeight(const char* field, int length, Weight* value);
+
+#endif
@@ -22,35 +22,365 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <graph.h>
-#include <minheap.h>
+#include <csrgraph.h>
 #include <dijkstras.h>
-
-#define STRING_SIZE 250 // Maximum length of a string
-
-void fastestRoute(FILE* citypairs, FILE* output, Graph* graph, MinHeap* minHeap);
+#include <dijkstraworkspace.h>
+#include <snapshot.h>
+#include <mappedfile.h>
+#include <linereader.h>
+#include <parallelloader.h>
+#include <querybatch.h>
+#include <treecache.h>
+#include <landmarks.h>
+#include <contractionhierarchy.h>
+#include <hublabels.h>
+#include <distancematrix.h>
+#include <deltastepping.h>
+#include <vertexorder.h>
+#include <compressedgraph.h>
+
+#define DEFAULT_TREE_CACHE_SIZE 16 // Shortest path trees kept in batch mode
+#define DEFAULT_NUMBER_OF_LANDMARKS 16 // Chosen for -search alt without -landmarks
+
+// How fastestRoute() finds each route
+enum SearchMode{
+    SEARCH_FORWARD,
+    SEARCH_BIDIRECTIONAL,
+    SEARCH_ALT,
+    SEARCH_CONTRACTION_HIERARCHY,
+    SEARCH_HUB_LABELS, // Distances only
+    SEARCH_DELTA_STEPPING,
+    SEARCH_COMPRESSED
+};
+
+void fastestRoute(FILE* citypairs, FILE* output, CsrGraph* csrGraph, DijkstraWorkspace* workspace,
+                  enum SearchMode searchMode, Landmarks* landmarks, ContractionHierarchy* hierarchy,
+                  HubLabels* hubLabels, DeltaStepping* deltaStepping, CompressedGraph* compressedGraph,
+                  int compare);
+ContractionHierarchy* loadHierarchy(CsrGraph* csrGraph, const char* path, int numberOfThreads);
+int parseHeapType(const char* name, MinHeapType* heapType);
+int parseVertexOrder(const char* name, VertexOrderType* vertexOrder);
+CsrGraph* renumberCities(CsrGraph* csrGraph, VertexOrderType vertexOrder);
+QueryBatch* readCityPairs(FILE* citypairs, CsrGraph* csrGraph);
+CsrGraph* loadCities(const char* path, int numberOfThreads);
+int findCity(CsrGraph* csrGraph, const char* cityName, int length);
+void reportGraphMemory(Graph* graph);
+void printUsage(const char* programName);
+double getSeconds(void);
 
 /*
  * Function: main
  * --------------
  * Opens necessary files, makes calls to other functions
- * setting up graph and minheap structures needed for
+ * setting up graph and workspace structures needed for
  * Dijkstra's algorithm. Runs Dijkstra's until all routes
  * in the citypairs.txt file are complete and then frees
  * all dynamically allocated memory.
+ *
+ * Options:
+ *   -compile FILE   Load ukcities.txt, write it to a binary
+ *                   snapshot FILE and exit.
+ *   -compress       Also write the roads compressed for
+ *                   -search compressed into the -compile FILE.
+ *   -snapshot FILE  Load the graph from a snapshot FILE
+ *                   instead of ukcities.txt.
+ *   -order ORDER    Renumber the cities once loaded, and
+ *                   before -compile writes them, so cities
+ *                   joined by a road are near each other in
+ *                   memory, bfs in the order of a breadth
+ *                   first search, rcm in reverse Cuthill-McKee
+ *                   order or none (the default).
+ *   -threads N      Read ukcities.txt on N threads, and find
+ *                   routes on N threads with -batch or
+ *                   -search delta.
+ *   -cities FILE    Read the cities from FILE instead of
+ *                   ukcities.txt, - reads standard input.
+ *   -batch          Read every pair of citypairs.txt before
+ *                   finding any route, then find them on a
+ *                   pool of threads, one search per source.
+ *   -cache N        Keep the last N shortest path trees in
+ *                   batch mode, 0 turns the cache off.
+ *   -search MODE    How each route is found when not in batch
+ *                   mode, forward from the source (the default),
+ *                   bidirectional, alt, an A* search guided
+ *                   by landmarks, ch, a search through a
+ *                   contraction hierarchy, hubs, which only
+ *                   writes the distance of each route, looked
+ *                   up in hub labels, delta, a search from
+ *                   the source to every city shared between
+ *                   the -threads, or compressed, a forward
+ *                   search over roads compressed at start up,
+ *                   or mapped from a snapshot made with
+ *                   -compress.
+ *   -delta N        Gather cities N km apart into each bucket
+ *                   of -search delta instead of the mean
+ *                   length of a road.
+ *   -landmarks FILE Load the landmarks for -search alt from
+ *                   FILE instead of choosing them at start up.
+ *   -build-landmarks N
+ *                   Choose N landmarks, write them to the
+ *                   -landmarks FILE and exit.
+ *   -hierarchy FILE Load the contraction hierarchy for -search ch
+ *                   from FILE instead of building it at start up.
+ *   -build-hierarchy
+ *                   Build the contraction hierarchy on the
+ *                   -threads, write it to the -hierarchy FILE
+ *                   and exit.
+ *   -hub-labels FILE
+ *                   Load the hub labels for -search hubs from
+ *                   FILE instead of building them at start up.
+ *   -build-hub-labels
+ *                   Build hub labels from the -hierarchy FILE,
+ *                   or a new contraction hierarchy, write them
+ *                   to the -hub-labels FILE and exit.
+ *   -all-pairs FILE Find the distance between every pair of
+ *                   cities on the -threads, write the matrix
+ *                   to FILE and exit.
+ *   -all-pairs-paths
+ *                   Also write the city before the destination
+ *                   of every route with -all-pairs.
+ *   -queue TYPE     The priority queue searches take cities
+ *                   from, binary (the default), a d-ary heap
+ *                   such as 4-ary, pairing, radix or buckets.
+ *   -compare        Also run a forward search for every route
+ *                   and print how many vertices it settled
+ *                   and how long the searches took.
  */
-int main(){
-
-    // Importing text files and checking if they opened correctly
-    // This is the file of cities and distances
-    FILE* ukcities = NULL;
+int main(int argc, char* argv[]){
+
+    char* compilePath = NULL;
+    int compress = 0;
+    char* snapshotPath = NULL;
+    char* citiesPath = "ukcities.txt";
+    int numberOfThreads = 1;
+    int batchMode = 0;
+    int cacheSize = DEFAULT_TREE_CACHE_SIZE;
+    enum SearchMode searchMode = SEARCH_FORWARD;
+    int delta = 0;
+    char* landmarksPath = NULL;
+    int numberOfLandmarksToBuild = 0;
+    char* hierarchyPath = NULL;
+    int buildHierarchy = 0;
+    char* hubLabelsPath = NULL;
+    int buildHubLabels = 0;
+    char* allPairsPath = NULL;
+    int allPairsPaths = 0;
+    MinHeapType heapType = MIN_HEAP_DEFAULT_TYPE;
+    VertexOrderType vertexOrder = VERTEX_ORDER_NONE;
+    int compare = 0;
+
+    int i;
+    for(i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "-compile") && i + 1 < argc){
+            compilePath = argv[++i];
+        } else if(!strcmp(argv[i], "-compress")){
+            compress = 1;
+        } else if(!strcmp(argv[i], "-snapshot") && i + 1 < argc){
+            snapshotPath = argv[++i];
+        } else if(!strcmp(argv[i], "-threads") && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            numberOfThreads = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-cities") && i + 1 < argc){
+            citiesPath = argv[++i];
+        } else if(!strcmp(argv[i], "-batch")){
+            batchMode = 1;
+        } else if(!strcmp(argv[i], "-cache") && i + 1 < argc && atoi(argv[i + 1]) >= 0){
+            cacheSize = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "forward")){
+            searchMode = SEARCH_FORWARD;
+            i++;
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "bidirectional")){
+            searchMode = SEARCH_BIDIRECTIONAL;
+            i++;
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "alt")){
+            searchMode = SEARCH_ALT;
+            i++;
+        } else if(!strcmp(argv[i], "-landmarks") && i + 1 < argc){
+            landmarksPath = argv[++i];
+        } else if(!strcmp(argv[i], "-build-landmarks") && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            numberOfLandmarksToBuild = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "ch")){
+            searchMode = SEARCH_CONTRACTION_HIERARCHY;
+            i++;
+        } else if(!strcmp(argv[i], "-hierarchy") && i + 1 < argc){
+            hierarchyPath = argv[++i];
+        } else if(!strcmp(argv[i], "-build-hierarchy")){
+            buildHierarchy = 1;
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "hubs")){
+            searchMode = SEARCH_HUB_LABELS;
+            i++;
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "delta")){
+            searchMode = SEARCH_DELTA_STEPPING;
+            i++;
+        } else if(!strcmp(argv[i], "-search") && i + 1 < argc && !strcmp(argv[i + 1], "compressed")){
+            searchMode = SEARCH_COMPRESSED;
+            i++;
+        } else if(!strcmp(argv[i], "-delta") && i + 1 < argc && atoi(argv[i + 1]) > 0){
+            delta = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-hub-labels") && i + 1 < argc){
+            hubLabelsPath = argv[++i];
+        } else if(!strcmp(argv[i], "-build-hub-labels")){
+            buildHubLabels = 1;
+        } else if(!strcmp(argv[i], "-all-pairs") && i + 1 < argc){
+            allPairsPath = argv[++i];
+        } else if(!strcmp(argv[i], "-all-pairs-paths")){
+            allPairsPaths = 1;
+        } else if(!strcmp(argv[i], "-queue") && i + 1 < argc && parseHeapType(argv[i + 1], &heapType)){
+            i++;
+        } else if(!strcmp(argv[i], "-order") && i + 1 < argc && parseVertexOrder(argv[i + 1], &vertexOrder)){
+            i++;
+        } else if(!strcmp(argv[i], "-compare")){
+            compare = 1;
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
 
-    if ((ukcities = fopen("ukcities.txt", "r")) == NULL){
-        fprintf(stderr, "error: file open failed 'ukcities.txt'.\n");
+    if((numberOfLandmarksToBuild > 0 && landmarksPath == NULL) || (buildHierarchy && hierarchyPath == NULL)
+       || (buildHubLabels && hubLabelsPath == NULL) || (allPairsPaths && allPairsPath == NULL)
+       || (compress && compilePath == NULL)){
+        printUsage(argv[0]);
         return -1;
     }
 
-    printf("FILE ukcities.txt opened successfully.\n\n");
+    // The graph of cities and distances, either mapped
+    // from a snapshot or read from the text file
+    CsrGraph* csrGraph;
+
+    // Roads for -search compressed, mapped from the snapshot if it
+    // has them and the cities keep the numbers they have in it
+    CompressedGraph* compressedGraph = NULL;
+
+    if(snapshotPath != NULL){
+        csrGraph = snapshotLoad(snapshotPath, searchMode == SEARCH_COMPRESSED && !batchMode && compilePath == NULL
+                                              && vertexOrder == VERTEX_ORDER_NONE ? &compressedGraph : NULL);
+        printf("FILE %s mapped successfully.\n\n", snapshotPath);
+    } else {
+        csrGraph = loadCities(citiesPath, numberOfThreads);
+    }
+
+    if(vertexOrder != VERTEX_ORDER_NONE){
+        csrGraph = renumberCities(csrGraph, vertexOrder);
+    }
+
+    if(compilePath != NULL){
+        if(compress){
+            compressedGraph = compressedGraphConstructor(csrGraph);
+        }
+        if(snapshotWrite(csrGraph, compressedGraph, compilePath) != 0){
+            fprintf(stderr, "error: file write failed '%s'.\n", compilePath);
+            return -1;
+        }
+        printf("Snapshot of %d cities saved into %s%s.\n\n", csrGraphGetNumberOfCities(csrGraph), compilePath,
+               compress ? " with compressed roads" : "");
+        if(compressedGraph != NULL){
+            compressedGraphDestructor(compressedGraph);
+        }
+        csrGraphDestructor(csrGraph);
+        return 0;
+    }
+
+    if(allPairsPath != NULL){
+        DistanceMatrix* matrix = distanceMatrixConstructor(csrGraph, numberOfThreads, allPairsPaths, heapType);
+        if(distanceMatrixWrite(matrix, csrGraph, allPairsPath) != 0){
+            fprintf(stderr, "error: file write failed '%s'.\n", allPairsPath);
+            return -1;
+        }
+        printf("Distances between all %d cities saved into %s.\n\n", csrGraphGetNumberOfCities(csrGraph), allPairsPath);
+        distanceMatrixDestructor(matrix);
+        csrGraphDestructor(csrGraph);
+        return 0;
+    }
+
+    Landmarks* landmarks = NULL;
+
+    if(numberOfLandmarksToBuild > 0){
+        landmarks = landmarksConstructor(csrGraph, numberOfLandmarksToBuild);
+        if(landmarksWrite(landmarks, csrGraph, landmarksPath) != 0){
+            fprintf(stderr, "error: file write failed '%s'.\n", landmarksPath);
+            return -1;
+        }
+        printf("%d landmarks saved into %s.\n\n", landmarksGetNumberOfLandmarks(landmarks), landmarksPath);
+        landmarksDestructor(landmarks);
+        csrGraphDestructor(csrGraph);
+        return 0;
+    }
+
+    ContractionHierarchy* hierarchy = NULL;
+
+    if(buildHierarchy){
+        hierarchy = contractionHierarchyConstructor(csrGraph, numberOfThreads);
+        if(contractionHierarchyWrite(hierarchy, csrGraph, hierarchyPath) != 0){
+            fprintf(stderr, "error: file write failed '%s'.\n", hierarchyPath);
+            return -1;
+        }
+        printf("Contraction hierarchy with %d shortcuts saved into %s.\n\n",
+               contractionHierarchyGetNumberOfShortcuts(hierarchy), hierarchyPath);
+        contractionHierarchyDestructor(hierarchy);
+        csrGraphDestructor(csrGraph);
+        return 0;
+    }
+
+    HubLabels* hubLabels = NULL;
+
+    if(buildHubLabels || (searchMode == SEARCH_HUB_LABELS && !batchMode && hubLabelsPath == NULL)){
+        hierarchy = loadHierarchy(csrGraph, hierarchyPath, numberOfThreads);
+        hubLabels = hubLabelsConstructor(hierarchy);
+        contractionHierarchyDestructor(hierarchy);
+        hierarchy = NULL;
+        printf("Built hub labels with %ld entries, %.1f per city.\n\n", hubLabelsGetNumberOfEntries(hubLabels),
+               (double)hubLabelsGetNumberOfEntries(hubLabels)/csrGraphGetNumberOfCities(csrGraph));
+    }
+
+    if(buildHubLabels){
+        if(hubLabelsWrite(hubLabels, csrGraph, hubLabelsPath) != 0){
+            fprintf(stderr, "error: file write failed '%s'.\n", hubLabelsPath);
+            return -1;
+        }
+        printf("Hub labels saved into %s.\n\n", hubLabelsPath);
+        hubLabelsDestructor(hubLabels);
+        csrGraphDestructor(csrGraph);
+        return 0;
+    }
+
+    if(searchMode == SEARCH_HUB_LABELS && !batchMode && hubLabelsPath != NULL){
+        hubLabels = hubLabelsLoad(hubLabelsPath, csrGraph);
+        printf("FILE %s mapped successfully.\n\n", hubLabelsPath);
+    }
+
+    if(searchMode == SEARCH_CONTRACTION_HIERARCHY && !batchMode){
+        hierarchy = loadHierarchy(csrGraph, hierarchyPath, numberOfThreads);
+    }
+
+    if(searchMode == SEARCH_ALT && !batchMode){
+        if(landmarksPath != NULL){
+            landmarks = landmarksLoad(landmarksPath, csrGraph);
+            printf("FILE %s mapped successfully.\n\n", landmarksPath);
+        } else {
+            landmarks = landmarksConstructor(csrGraph, DEFAULT_NUMBER_OF_LANDMARKS);
+            printf("Chose %d landmarks.\n\n", landmarksGetNumberOfLandmarks(landmarks));
+        }
+    }
+
+    if(searchMode == SEARCH_COMPRESSED && !batchMode){
+        if(compressedGraph == NULL){
+            compressedGraph = compressedGraphConstructor(csrGraph);
+        }
+        printf("The %d roads take %lu KB compressed, %.2f bytes per road each way against %.2f uncompressed.\n\n",
+               csrGraphGetNumberOfEdges(csrGraph)/2, (unsigned long)(compressedGraphGetBytes(compressedGraph)/1024),
+               (double)compressedGraphGetBytes(compressedGraph)/csrGraphGetNumberOfEdges(csrGraph),
+               ((double)(csrGraphGetNumberOfCities(csrGraph) + 1)*sizeof(int)
+                + (double)csrGraphGetNumberOfEdges(csrGraph)*(sizeof(int) + sizeof(Weight)))
+               /csrGraphGetNumberOfEdges(csrGraph));
+
+        // Only the forward searches of -compare still read the uncompressed roads
+        if(!compare){
+            csrGraphReleaseRoads(csrGraph);
+        }
+    }
 
     // This is the cities of which the shortest distance between
     // is to be calculated
@@ -71,30 +401,58 @@ int main(){
 
     printf("FILE output.txt opened successfully.\n\n");
 
-    // Create an empty graph structure
-    Graph* graph = graphConstructor();
-
-    // Fill the graph with cities and their connections
-    graphPopulateGraph(graph, ukcities);
-
+    printf("Calculating fastest routes...\n\n");
 
-    // Create an empty minimum heap structure
-    MinHeap* minHeap = minHeapConstructor();
+    if(batchMode){
+        QueryBatch* batch = readCityPairs(citypairs, csrGraph);
+        TreeCache* cache = cacheSize > 0 ? treeCacheConstructor(csrGraphGetNumberOfCities(csrGraph), cacheSize) : NULL;
 
-    printf("Calculating fastest routes...\n\n");
+        queryBatchRun(batch, csrGraph, output, numberOfThreads, cache, heapType);
+        printf("Found %d routes with %ld searches.\n\n", queryBatchGetNumberOfPairs(batch),
+               queryBatchGetNumberOfSearches(batch));
 
-    fastestRoute(citypairs, output, graph, minHeap);
+        if(cache != NULL){
+            treeCacheDestructor(cache);
+        }
+        queryBatchDestructor(batch);
+    } else {
+        // Create the arrays and minimum heap Dijkstra's works in
+        DijkstraWorkspace* workspace = dijkstraWorkspaceConstructor(csrGraphGetNumberOfCities(csrGraph), heapType);
+        DeltaStepping* deltaStepping = NULL;
+
+        if(searchMode == SEARCH_DELTA_STEPPING){
+            deltaStepping = deltaSteppingConstructor(csrGraph, numberOfThreads, delta);
+            printf("Searching in buckets of %d km on %d threads.\n\n", deltaSteppingGetDelta(deltaStepping),
+                   numberOfThreads);
+        }
+        fastestRoute(citypairs, output, csrGraph, workspace, searchMode, landmarks, hierarchy, hubLabels,
+                     deltaStepping, compressedGraph, compare);
+        if(deltaStepping != NULL){
+            deltaSteppingDestructor(deltaStepping);
+        }
+        dijkstraWorkspaceDestructor(workspace);
+    }
 
     printf("Fastest routes have been saved into output.txt.\n\n");
 
     printf("Program terminating...\n\n");
 
     // Freeing all dynamically allocated memory
-    graphDestructor(graph);
-    minHeapDestructor(minHeap);
+    if(landmarks != NULL){
+        landmarksDestructor(landmarks);
+    }
+    if(hierarchy != NULL){
+        contractionHierarchyDestructor(hierarchy);
+    }
+    if(hubLabels != NULL){
+        hubLabelsDestructor(hubLabels);
+    }
+    if(compressedGraph != NULL){
+        compressedGraphDestructor(compressedGraph);
+    }
+    csrGraphDestructor(csrGraph);
 
     // Closing files
-    fclose(ukcities);
     fclose(citypairs);
     fclose(output);
 
@@ -105,62 +463,396 @@ int main(){
 
 
 /*
- * Function: fastestRoute
- * ----------------------
- * Reading routes to calculate from citypairs file
- * calculating their associated vertexNumber and
- * running Dijkstra's algorithm using that number.
+ * Function: loadCities
+ * --------------------
+ * Maps the file of cities and distances into memory and
+ * reads it into a Graph without copying it, or streams it
+ * through a buffer if the path is - for standard input,
+ * so it can be piped from a decompressor. Then returns
+ * the compressed sparse row copy of the Graph used by
+ * Dijkstra's. The Graph itself is no longer needed once
+ * the copy is made so it is freed. With more than one
+ * thread the copy is built straight from the text by
+ * parallelLoaderLoad() and no Graph is made.
  */
-void fastestRoute(FILE* citypairs, FILE* output, Graph* graph, MinHeap* minHeap){
+CsrGraph* loadCities(const char* path, int numberOfThreads){
 
-    char* start = (char*)malloc(STRING_SIZE*sizeof(char));
-    char* end = (char*)malloc(STRING_SIZE*sizeof(char));
-    int startVertexNumber;
-    int endVertexNumber;
+    CsrGraph* csrGraph;
+    Graph* graph;
+
+    if(!strcmp(path, "-")){
+        printf("Reading cities from standard input.\n\n");
+
+        graph = graphConstructor();
+        graphPopulateGraph(graph, stdin);
+        reportGraphMemory(graph);
+
+        csrGraph = csrGraphConstructor(graph);
+        graphDestructor(graph);
+        return csrGraph;
+    }
+
+    // Mapping text file and checking if it opened correctly
+    MappedFile* ukcities = mappedFileOpen(path);
+
+    if (ukcities == NULL){
+        fprintf(stderr, "error: file open failed '%s'.\n", path);
+        exit(-1);
+    }
+
+    printf("FILE %s opened successfully.\n\n", path);
+
+    if(numberOfThreads > 1){
+        csrGraph = parallelLoaderLoad(mappedFileGetData(ukcities), mappedFileGetSize(ukcities), numberOfThreads);
+        mappedFileClose(ukcities);
+        return csrGraph;
+    }
+
+    // Create an empty graph structure
+    graph = graphConstructor();
+
+    // Fill the graph with cities and their connections
+    graphPopulateGraphFromMemory(graph, mappedFileGetData(ukcities), mappedFileGetSize(ukcities));
+    reportGraphMemory(graph);
+
+    // Build the contiguous copy of the adjacency list used by Dijkstra's
+    csrGraph = csrGraphConstructor(graph);
 
-    // Counting the number of lines
-    // Used for error checking
-    char character;
-    int lineNumber = 0;
-    while(!feof(citypairs)){
-        character = fgetc(citypairs);
-        if(character == '\n'){
-            lineNumber++;
+    graphDestructor(graph);
+    mappedFileClose(ukcities);
+    return csrGraph;
+}
+
+
+/*
+ * Function: loadHierarchy
+ * -----------------------
+ * Maps the contraction hierarchy saved at path, or if
+ * path is NULL builds one on numberOfThreads threads.
+ */
+ContractionHierarchy* loadHierarchy(CsrGraph* csrGraph, const char* path, int numberOfThreads){
+
+    ContractionHierarchy* hierarchy;
+
+    if(path != NULL){
+        hierarchy = contractionHierarchyLoad(path, csrGraph);
+        printf("FILE %s mapped successfully.\n\n", path);
+    } else {
+        hierarchy = contractionHierarchyConstructor(csrGraph, numberOfThreads);
+        printf("Built a contraction hierarchy with %d shortcuts.\n\n",
+               contractionHierarchyGetNumberOfShortcuts(hierarchy));
+    }
+    return hierarchy;
+}
+
+
+/*
+ * Function: parseHeapType
+ * -----------------------
+ * Reads a -queue name, binary, pairing, radix, buckets or
+ * a number of children followed by -ary, into heapType. Returns 1 if
+ * the name is known and 0 otherwise.
+ */
+int parseHeapType(const char* name, MinHeapType* heapType){
+
+    size_t digits = strspn(name, "0123456789");
+
+    if(!strcmp(name, "binary")){
+        heapType->kind = MIN_HEAP_BINARY;
+        heapType->arity = 2;
+    } else if(!strcmp(name, "pairing")){
+        heapType->kind = MIN_HEAP_PAIRING;
+        heapType->arity = 0;
+    } else if(!strcmp(name, "radix")){
+        heapType->kind = MIN_HEAP_RADIX;
+        heapType->arity = 0;
+    } else if(!strcmp(name, "buckets")){
+        heapType->kind = MIN_HEAP_BUCKET;
+        heapType->arity = 0;
+    } else if(digits > 0 && !strcmp(name + digits, "-ary") && atoi(name) >= 2){
+        heapType->kind = MIN_HEAP_DARY;
+        heapType->arity = atoi(name);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+
+/*
+ * Function: parseVertexOrder
+ * --------------------------
+ * Reads an -order name, bfs, rcm or none, into
+ * vertexOrder. Returns 1 if the name is known and
+ * 0 otherwise.
+ */
+int parseVertexOrder(const char* name, VertexOrderType* vertexOrder){
+
+    if(!strcmp(name, "none")){
+        *vertexOrder = VERTEX_ORDER_NONE;
+    } else if(!strcmp(name, "bfs")){
+        *vertexOrder = VERTEX_ORDER_BREADTH_FIRST;
+    } else if(!strcmp(name, "rcm")){
+        *vertexOrder = VERTEX_ORDER_CUTHILL_MCKEE;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+
+/*
+ * Function: renumberCities
+ * ------------------------
+ * Returns a copy of the CsrGraph with the cities in the
+ * given order and frees the old one. Prints how far
+ * apart the ends of a road are numbered before and after.
+ */
+CsrGraph* renumberCities(CsrGraph* csrGraph, VertexOrderType vertexOrder){
+
+    double spanBefore = vertexOrderGetMeanSpan(csrGraph);
+    int* order = vertexOrderFind(csrGraph, vertexOrder);
+    CsrGraph* renumbered = vertexOrderApply(csrGraph, order);
+
+    printf("Renumbered %d cities in %s order, roads join cities %.0f numbers apart on average, %.0f before.\n\n",
+           csrGraphGetNumberOfCities(renumbered), vertexOrderGetName(vertexOrder),
+           vertexOrderGetMeanSpan(renumbered), spanBefore);
+
+    free(order);
+    csrGraphDestructor(csrGraph);
+    return renumbered;
+}
+
+
+/*
+ * Function: reportGraphMemory
+ * ---------------------------
+ * Prints the size of a loaded Graph and how much of the
+ * memory allocated while loading it was room for growth.
+ */
+void reportGraphMemory(Graph* graph){
+
+    size_t needed = graphGetBytesNeeded(graph);
+    size_t reserved = graphGetBytesReserved(graph);
+
+    printf("Loaded %d cities and %d roads into %lu KB, %lu KB of it in use.\n\n",
+           graphGetNumberOfCities(graph), graphGetNumberOfEdges(graph)/2,
+           (unsigned long)(reserved/1024), (unsigned long)(needed/1024));
+}
+
+
+/*
+ * Function: readCityPairs
+ * -----------------------
+ * Reads every line of the citypairs file and looks up
+ * both cities, exiting with an error for a bad line or
+ * unknown city before any route is found. Returns the
+ * pairs as a QueryBatch in the order of the file.
+ */
+QueryBatch* readCityPairs(FILE* citypairs, CsrGraph* csrGraph){
+
+    const char* start;
+    const char* end;
+    int startLength;
+    int endLength;
+
+    QueryBatch* batch = queryBatchConstructor();
+    LineReader* lineReader = lineReaderConstructor(citypairs);
+
+    while(lineReaderNextLine(lineReader)){
+
+        // Each line must contain two tab-delimited strings
+        if(lineReaderGetNumberOfFields(lineReader) != 2){
+            printf("\n######################################\n");
+            printf("There was an error reading 'citypairs.txt' line: %ld\n\n", lineReaderGetLineNumber(lineReader));
+            printf("Please check each line of the file contains two,\n");
+            printf("tab-delimited, strings.\n");
+            printf("######################################\n\n");
+            exit(-1);
         }
+
+        start = lineReaderGetField(lineReader, 0, &startLength);
+        end = lineReaderGetField(lineReader, 1, &endLength);
+        queryBatchAddPair(batch, findCity(csrGraph, start, startLength), findCity(csrGraph, end, endLength));
+    }
+
+    lineReaderDestructor(lineReader);
+    return batch;
+}
+
+
+/*
+ * Function: findCity
+ * ------------------
+ * Returns the vertex number of the first length
+ * characters of a city name or exits with an
+ * error if the city is not known.
+ */
+int findCity(CsrGraph* csrGraph, const char* cityName, int length){
+
+    int vertexNumber = csrGraphGetVertexNumber(csrGraph, cityName, length);
+    if(vertexNumber == -1){
+        printf("\n#####################################\n");
+        printf("Error, city name %.*s is not known.\n", length, cityName);
+        printf("#####################################\n\n");
+        exit(-1);
     }
+    return vertexNumber;
+}
+
+
+/*
+ * Function: printUsage
+ * --------------------
+ * Lists the command line options.
+ */
+void printUsage(const char* programName){
+
+    printf("Usage: %s [options]\n\n", programName);
+    printf("  -compile FILE   Write ukcities.txt to a binary snapshot FILE and exit\n");
+    printf("  -compress       Also write the roads compressed for -search compressed with -compile\n");
+    printf("  -snapshot FILE  Load the graph from a snapshot FILE instead of ukcities.txt\n");
+    printf("  -order ORDER    bfs, rcm or none, renumber the cities so roads join nearby numbers\n");
+    printf("  -threads N      Read ukcities.txt and, with -batch or -search delta, find routes on N threads\n");
+    printf("  -cities FILE    Read the cities from FILE, - for standard input\n");
+    printf("  -batch          Read all of citypairs.txt first, then find the routes in parallel\n");
+    printf("  -cache N        Keep N shortest path trees in batch mode, 0 for none\n");
+    printf("  -search MODE    forward, bidirectional, alt, ch, hubs, delta or compressed,\n");
+    printf("                  how routes are found without -batch\n");
+    printf("  -delta N        Width in km of the buckets of -search delta\n");
+    printf("  -landmarks FILE Load the landmarks for -search alt from FILE\n");
+    printf("  -build-landmarks N\n");
+    printf("                  Write N landmarks to the -landmarks FILE and exit\n");
+    printf("  -hierarchy FILE Load the contraction hierarchy for -search ch from FILE\n");
+    printf("  -build-hierarchy\n");
+    printf("                  Write the contraction hierarchy to the -hierarchy FILE and exit\n");
+    printf("  -hub-labels FILE\n");
+    printf("                  Load the hub labels for -search hubs from FILE\n");
+    printf("  -build-hub-labels\n");
+    printf("                  Write hub labels to the -hub-labels FILE and exit\n");
+    printf("  -all-pairs FILE Write the distance between every pair of cities to FILE and exit\n");
+    printf("  -all-pairs-paths\n");
+    printf("                  Also write the city before the destination of each route\n");
+    printf("  -queue TYPE     binary, N-ary such as 4-ary, pairing, radix or buckets,\n");
+    printf("                  the priority queue of searches\n");
+    printf("  -compare        Count the vertices a forward search settles, and time it, as well\n\n");
+}
 
-    // Sets the file position to the beginning of the file
-    rewind(citypairs);
 
-    //  %[^\t] - read any character that is not a Taking a worst-case scenario, the highest order of BigO of the entire program is:TAB
-    //  \t the TAB
-    //  \r the return carriage character
-    //  \n the new line character
-    // While fscanf has read three things, two strings and an integer on a line
+/*
+ * Function: getSeconds
+ * --------------------
+ * Returns the time in seconds from a fixed point, for
+ * timing searches.
+ */
+double getSeconds(void){
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec/1e9;
+}
+
+
+/*
+ * Function: fastestRoute
+ * ----------------------
+ * Reading routes to calculate from citypairs file in a
+ * single pass, calculating their associated vertexNumber
+ * and running Dijkstra's algorithm using that number.
+ * With hub labels only the distance is looked up and
+ * written, without the route. Delta-stepping searches
+ * from the source to every city.
+ * Prints how many vertices were settled in total. With
+ * compare set, a forward search is run after each route
+ * is written and the vertices it settled are counted and
+ * printed too, along with the time spent in each kind of
+ * search, not counting writing the routes.
+ */
+void fastestRoute(FILE* citypairs, FILE* output, CsrGraph* csrGraph, DijkstraWorkspace* workspace,
+                  enum SearchMode searchMode, Landmarks* landmarks, ContractionHierarchy* hierarchy,
+                  HubLabels* hubLabels, DeltaStepping* deltaStepping, CompressedGraph* compressedGraph,
+                  int compare){
+
+    const char* start;
+    const char* end;
+    int startLength;
+    int endLength;
+    int startVertexNumber;
+    int endVertexNumber;
+    int numberOfRoutes = 0;
+    long numberOfSettled = 0;
+    long numberOfSettledForward = 0;
+    double searchSeconds = 0;
+    double forwardSeconds = 0;
+    double startTime;
+    Distance distance;
+
+    LineReader* lineReader = lineReaderConstructor(citypairs);
+
+    while(lineReaderNextLine(lineReader)){
+
+        // Each line must contain two tab-delimited strings
+        if(lineReaderGetNumberOfFields(lineReader) != 2){
+            printf("\n######################################\n");
+            printf("There was an error reading 'citypairs.txt' line: %ld\n\n", lineReaderGetLineNumber(lineReader));
+            printf("Please check each line of the file contains two,\n");
+            printf("tab-delimited, strings.\n");
+            printf("######################################\n\n");
+            exit(-1);
+        }
 
-    int i = 0;
-    while(2 == fscanf(citypairs, "%[^\t]\t%[^\t]\r\n", start, end)){
         // Getting associated Vertex number of cities
         // or error if city is not known
-        i++;
-        startVertexNumber = graphGetVertexNumber(graph, start);
-        endVertexNumber = graphGetVertexNumber(graph, end);
-        dijkstras(graph, minHeap, startVertexNumber);
-        dijkstrasWriteToFile(graph, output, startVertexNumber, endVertexNumber);
-    }
-    // If the number of lines read by the
-    // file when importing data isn't equal
-    // to the number of lines in the file
-    // report an error.
-    if(i != lineNumber){
-        printf("\n######################################\n");
-        printf("There was an error reading 'citypairs.txt' line: %d\n\n", i);
-        printf("Please check each line of the file contains two,\n");
-        printf("tab-delimited, strings.\n");
-        printf("######################################\n\n");
-        exit(-1);
+        start = lineReaderGetField(lineReader, 0, &startLength);
+        end = lineReaderGetField(lineReader, 1, &endLength);
+        startVertexNumber = findCity(csrGraph, start, startLength);
+        endVertexNumber = findCity(csrGraph, end, endLength);
+
+        startTime = getSeconds();
+
+        if(searchMode == SEARCH_HUB_LABELS){
+            distance = hubLabelsGetDistance(hubLabels, startVertexNumber, endVertexNumber);
+            searchSeconds += getSeconds() - startTime;
+            fprintf(output, "%s to %s is %" DISTANCE_FORMAT "km\n\n", csrGraphGetCityName(csrGraph, startVertexNumber),
+                    csrGraphGetCityName(csrGraph, endVertexNumber), distance);
+        } else {
+            if(searchMode == SEARCH_BIDIRECTIONAL){
+                dijkstrasCsrBidirectional(csrGraph, workspace, startVertexNumber, endVertexNumber);
+            } else if(searchMode == SEARCH_ALT){
+                dijkstrasCsrAlt(csrGraph, workspace, landmarks, startVertexNumber, endVertexNumber);
+            } else if(searchMode == SEARCH_CONTRACTION_HIERARCHY){
+                contractionHierarchyFindRoute(hierarchy, workspace, startVertexNumber, endVertexNumber);
+            } else if(searchMode == SEARCH_DELTA_STEPPING){
+                deltaSteppingRun(deltaStepping, workspace, startVertexNumber);
+            } else if(searchMode == SEARCH_COMPRESSED){
+                compressedGraphFindRoute(compressedGraph, workspace, startVertexNumber, endVertexNumber);
+            } else {
+                dijkstrasCsrToTarget(csrGraph, workspace, startVertexNumber, endVertexNumber);
+            }
+            searchSeconds += getSeconds() - startTime;
+            dijkstrasCsrWriteToFile(csrGraph, workspace, output, startVertexNumber, endVertexNumber);
+            numberOfSettled += dijkstraWorkspaceGetNumberOfSettled(workspace);
+        }
+
+        numberOfRoutes++;
+
+        if(compare){
+            startTime = getSeconds();
+            dijkstrasCsrToTarget(csrGraph, workspace, startVertexNumber, endVertexNumber);
+            forwardSeconds += getSeconds() - startTime;
+            numberOfSettledForward += dijkstraWorkspaceGetNumberOfSettled(workspace);
+        }
     }
 
-    free(start);
-    free(end);
+    lineReaderDestructor(lineReader);
+
+    if(searchMode == SEARCH_HUB_LABELS){
+        printf("Looked up %d distances.\n\n", numberOfRoutes);
+    } else {
+        printf("Found %d routes settling %ld vertices.\n\n", numberOfRoutes, numberOfSettled);
+    }
+    if(compare){
+        printf("A forward search settles %ld vertices for the same routes.\n\n", numberOfSettledForward);
+        printf("The searches took %.2f ms, a forward search %.2f ms.\n\n", 1000*searchSeconds, 1000*forwardSeconds);
+    }
 }
@@ -0,0 +1,185 @@
+/*
+ * mappedfile.c
+ * ------------
+ *
+ * This file contains the functions for the MappedFile abstract
+ * data type. A MappedFile maps a whole file read-only into the
+ * address space of the program so its contents can be read
+ * through a pointer without copying them into buffers first.
+ * Pages are only read from disk when they are first touched, and
+ * pages of a part that will not be read again can be handed back.
+ * Windows uses CreateFileMapping and everything else uses mmap.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mappedfile.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+typedef struct MappedFile{
+
+    const char* data;
+    size_t size;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+} MappedFile;
+
+
+/*
+ * Function: mappedFileOpen
+ * ------------------------
+ * Opens the file, finds its size and maps all of it
+ * read-only. An empty file is not mapped as a zero length
+ * mapping is an error, its data pointer is left NULL.
+ */
+MappedFile* mappedFileOpen(const char* path){
+
+    MappedFile* newMappedFile = malloc(sizeof(MappedFile));
+    newMappedFile->data = NULL;
+    newMappedFile->size = 0;
+
+#ifdef _WIN32
+    newMappedFile->mapping = NULL;
+    newMappedFile->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(newMappedFile->file == INVALID_HANDLE_VALUE){
+        free(newMappedFile);
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(newMappedFile->file, &size);
+    newMappedFile->size = (size_t)size.QuadPart;
+
+    if(newMappedFile->size > 0){
+        newMappedFile->mapping = CreateFileMappingA(newMappedFile->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(newMappedFile->mapping != NULL){
+            newMappedFile->data = MapViewOfFile(newMappedFile->mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+        if(newMappedFile->data == NULL){
+            if(newMappedFile->mapping != NULL){
+                CloseHandle(newMappedFile->mapping);
+            }
+            CloseHandle(newMappedFile->file);
+            free(newMappedFile);
+            return NULL;
+        }
+    }
+#else
+    int file = open(path, O_RDONLY);
+    if(file == -1){
+        free(newMappedFile);
+        return NULL;
+    }
+
+    struct stat status;
+    if(fstat(file, &status) == -1){
+        close(file);
+        free(newMappedFile);
+        return NULL;
+    }
+    newMappedFile->size = (size_t)status.st_size;
+
+    if(newMappedFile->size > 0){
+        void* data = mmap(NULL, newMappedFile->size, PROT_READ, MAP_PRIVATE, file, 0);
+        if(data == MAP_FAILED){
+            close(file);
+            free(newMappedFile);
+            return NULL;
+        }
+        newMappedFile->data = data;
+    }
+
+    // The mapping stays valid after the file is closed
+    close(file);
+#endif
+
+    return newMappedFile;
+}
+
+
+/*
+ * Function: mappedFileClose
+ * -------------------------
+ * Unmaps the file and frees the MappedFile.
+ */
+void mappedFileClose(MappedFile* mappedFile){
+
+#ifdef _WIN32
+    if(mappedFile->data != NULL){
+        UnmapViewOfFile(mappedFile->data);
+        CloseHandle(mappedFile->mapping);
+    }
+    CloseHandle(mappedFile->file);
+#else
+    if(mappedFile->data != NULL){
+        munmap((void*)mappedFile->data, mappedFile->size);
+    }
+#endif
+
+    free(mappedFile);
+}
+
+
+/*
+ * Function: mappedFileRelease
+ * ---------------------------
+ * Tells the system the whole pages inside the range are
+ * not needed, so they leave the program's memory and are
+ * read from the file again if touched. Windows drops
+ * them from the working set with VirtualUnlock, which
+ * fails harmlessly as the pages were never locked.
+ */
+void mappedFileRelease(MappedFile* mappedFile, const void* start, size_t size){
+
+    const char* first = start;
+    const char* last = first + size;
+
+    if(mappedFile->data == NULL || size == 0){
+        return;
+    }
+
+#ifdef _WIN32
+    VirtualUnlock((void*)first, size);
+#else
+    long pageSize = sysconf(_SC_PAGESIZE);
+    size_t firstPage = ((size_t)(first - mappedFile->data) + pageSize - 1)/pageSize*pageSize;
+    size_t lastPage = (size_t)(last - mappedFile->data)/pageSize*pageSize;
+
+    if(lastPage > firstPage){
+        madvise((void*)(mappedFile->data + firstPage), lastPage - firstPage, MADV_DONTNEED);
+    }
+#endif
+}
+
+
+/*
+ * Function: mappedFileGetData
+ * ---------------------------
+ * Returns a pointer to the first byte of the file.
+ */
+const char* mappedFileGetData(MappedFile* mappedFile){
+    return mappedFile->data;
+}
+
+
+/*
+ * Function: mappedFileGetSize
+ * ---------------------------
+ * Returns the size of the file in bytes.
+ */
+size_t mappedFileGetSize(MappedFile* mappedFile){
+    return mappedFile->size;
+}
@@ -0,0 +1,58 @@
+/*
+ * mappedfile.h
+ * ------------
+ *
+ * The header file for mappedfile.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stddef.h>
+
+typedef struct MappedFile MappedFile;
+
+/*
+ * Function: mappedFileOpen
+ * ------------------------
+ * Maps a whole file read-only into memory. Returns NULL if
+ * the file could not be opened or mapped.
+ */
+MappedFile* mappedFileOpen(const char* path);
+
+
+/*
+ * Function: mappedFileClose
+ * -------------------------
+ * Unmaps the file. Pointers into its data are
+ * invalid afterwards.
+ */
+void mappedFileClose(MappedFile* mappedFile);
+
+
+/*
+ * Function: mappedFileRelease
+ * ---------------------------
+ * Lets the system drop the pages of part of the file from
+ * memory. They are read back in if used again.
+ */
+void mappedFileRelease(MappedFile* mappedFile, const void* start, size_t size);
+
+
+/*
+ * Function: mappedFileGetData
+ * ---------------------------
+ * Returns a pointer to the first byte of the file.
+ */
+const char* mappedFileGetData(MappedFile* mappedFile);
+
+
+/*
+ * Function: mappedFileGetSize
+ * ---------------------------
+ * Returns the size of the file in bytes.
+ */
+size_t mappedFileGetSize(MappedFile* mappedFile);
+
+#endif
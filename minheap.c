@@ -7,452 +7,1352 @@
  * Date 24/01/2019
  *
  * This file contains the functions of the minHeap Abstract
- * Data Type (ADT). The minHeap has a node at its zero index
- * so the equations for child and parent nodes are calculated
- * with that in mind. The Node of the Heap has a close relationship
- * with its corresponding Vertex in the Graph ADT and information
- * about the heap is updated in both structures.
+ * Data Type (ADT), the priority queue Dijkstra's takes vertices
+ * from in order of distance. There are five kinds, chosen when
+ * the minHeap is constructed, each behind its own table of
+ * MinHeapOperations so the rest of the program does not need to
+ * know which it has.
+ *
+ * The binary and d-ary heaps keep their Nodes in one array with
+ * the root at index zero, the children of the Node at index i
+ * being at arity*i + 1 to arity*i + arity, so the equations for
+ * child and parent nodes are calculated with that in mind. Each
+ * Node holds the vertex number of its corresponding Vertex and
+ * the heap keeps a map from vertex number to position in the
+ * heap so a Node's value can be decreased without searching for
+ * it. The binary heap is the d-ary heap with two children per
+ * Node, given its own functions so no division is needed. More
+ * children make the heap shallower, so decreasing a value moves
+ * a Node fewer times, but dequeuing compares more children.
+ *
+ * The pairing heap is a tree of Nodes where every Node's value is
+ * no larger than its children's, its children kept in a list.
+ * There is a Node for each vertex number, holding its first
+ * child, next sibling and previous sibling, or parent if it is
+ * the first child. Enqueuing and decreasing a value only link a
+ * Node under the root or the root under it, so cost the same
+ * however big the heap is, and all the sorting out is left to
+ * dequeuing, which pairs up the root's children and joins them
+ * back into one tree.
+ *
+ * The radix heap and bucket queue rely on Dijkstra's never adding
+ * a value lower than the last one taken off, which holds as road
+ * distances are positive. They keep each vertex
+ * number's Node on a doubly linked list, one list per bucket, so a
+ * Node can be moved to another bucket when its value decreases.
+ * The radix heap puts a Node in the bucket of the highest bit its
+ * value differs from the last value taken off in, a double's value
+ * being the bits it is stored as, which sort the same way for any
+ * that are not negative. When the lowest bucket is empty the next
+ * bucket up is emptied into the ones below it, each Node moving down
+ * at most once for each bit of a Distance. The bucket queue, from
+ * Dial's algorithm, has a bucket per value, reused in a ring from
+ * the last value taken off, and a list for values beyond the ring,
+ * so it can only be used when Distances are whole numbers.
+ * The ring doubles whenever a value will not fit, up to
+ * MAXIMUM_BUCKET_COUNT, so once it is wider than the longest road
+ * finding the next Node is only a walk along the ring.
+ *
+ * The Nodes of each kind are stored by value in arrays that only
+ * ever grow, doubling when full. Dequeuing and clearing keep their
+ * capacity, so once a minHeap has held as many Nodes as a search
+ * needs, later searches with it allocate nothing.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <minheap.h>
-#include <math.h>
+
+#define INITIAL_HEAP_CAPACITY 64
+#define RADIX_BUCKET_COUNT (8*(int)sizeof(Distance)) // One more than the bits of a non-negative Distance
+#define INITIAL_BUCKET_COUNT 64 // Both bucket counts of the bucket queue are
+#define MAXIMUM_BUCKET_COUNT 65536 // powers of two
 
 typedef struct Node{
 
-    int value;
-    int position;
-    int hasChildLeft;
-    int hasChildRight;
+    Distance value;
 
-    // Pointer to Vertex associated with this Node
-    // Vertex Structure contains information
-    // about the location of Node in heap.
-    Vertex* vertex;
+    // Number of the Vertex associated with this Node.
+    // The MinHeap's positionInHeap array records
+    // the location of the Node in heap.
+    int vertexNumber;
 
 } Node;
 
 
+// A Node of the pairing heap, at the index of its vertex number.
+// Links are vertex numbers, -1 for none.
+typedef struct PairingNode{
+
+    Distance value;
+    int child;
+    int sibling;
+    int previous; // Previous sibling, or parent of a first child
+
+} PairingNode;
+
+
+// A Node of the radix heap or bucket queue, at the index of its
+// vertex number. Links are vertex numbers, -1 for none.
+typedef struct BucketNode{
+
+    Distance value;
+    int bucket; // Index of the list it is on, -1 for beyond the ring
+    int next;
+    int previous;
+
+} BucketNode;
+
+
+typedef struct MinHeapOperations{
+
+    void (*enqueue)(MinHeap* minHeap, int vertexNumber, Distance value);
+    int (*dequeue)(MinHeap* minHeap);
+    void (*decreaseNodeValue)(MinHeap* minHeap, int vertexNumber, Distance value);
+    Distance (*peekValue)(MinHeap* minHeap);
+
+} MinHeapOperations;
+
+
 typedef struct MinHeap{
 
-    // Pointer to Node pointers creating array
-    Node** heap;
+    const MinHeapOperations* operations;
+    MinHeapType type;
+
     // size is the number of Nodes
     int size;
 
+    // Binary and d-ary heaps, the first size Nodes in use
+    Node* heap;
+    int capacity;
+
+    // Index of each vertex number's Node in heap,
+    // grown to fit the largest vertex number seen.
+    int* positionInHeap;
+    int positionCapacity;
+
+    // Pairing heap, radix heap and bucket queue, one Node
+    // per vertex number up to nodeCapacity
+    PairingNode* pairingNodes;
+    BucketNode* bucketNodes;
+    int nodeCapacity;
+
+    // Vertex number of the pairing heap's root
+    int root;
+
+    // First vertex number on each bucket's list, -1 if empty
+    int* buckets;
+    int numberOfBuckets;
+
+    // Radix heap and bucket queue, the last value taken off or
+    // the value of the Node that will be, below which no value
+    // may be added
+    Distance lowest;
+
+    // Bucket queue list of Nodes beyond the ring, with a value
+    // no larger than any of theirs
+    int outside;
+    int numberOutside;
+    Distance outsideMinimum;
+
 } MinHeap;
 
 
 // Internal function declarations
-Node* nodeConstructor(int position, Vertex* vertex);
-void swapNode(MinHeap* minHeap, int currentPosition, int otherPosition);
-void minHeapResizeUp(MinHeap* minHeap);
-void minHeapResizeDown(MinHeap* minHeap);
-void minHeapSiftDown(MinHeap* minHeap);
-void nodeDestructor(Node* node);
+void minHeapSetPosition(MinHeap* minHeap, int vertexNumber, int position);
+void binaryHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value);
+int binaryHeapDequeue(MinHeap* minHeap);
+void binaryHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value);
+void binaryHeapSiftUp(MinHeap* minHeap, int currentPosition);
+void binaryHeapSiftDown(MinHeap* minHeap);
+void daryHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value);
+int daryHeapDequeue(MinHeap* minHeap);
+void daryHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value);
+void daryHeapSiftUp(MinHeap* minHeap, int currentPosition);
+void daryHeapSiftDown(MinHeap* minHeap);
+Distance arrayHeapPeekValue(MinHeap* minHeap);
+void pairingHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value);
+int pairingHeapDequeue(MinHeap* minHeap);
+void pairingHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value);
+Distance pairingHeapPeekValue(MinHeap* minHeap);
+int pairingHeapLink(PairingNode* nodes, int first, int second);
+void minHeapGrowNodes(MinHeap* minHeap, int capacity);
+void minHeapFitNode(MinHeap* minHeap, int vertexNumber);
+void bucketListPush(MinHeap* minHeap, int bucket, int vertexNumber);
+void bucketListRemove(MinHeap* minHeap, int vertexNumber);
+void bucketListClear(MinHeap* minHeap);
+void bucketCheckValue(MinHeap* minHeap, Distance value);
+int radixHeapBucket(Distance value, Distance lowest);
+void radixHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value);
+int radixHeapDequeue(MinHeap* minHeap);
+void radixHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value);
+Distance radixHeapPeekValue(MinHeap* minHeap);
+void radixHeapRedistribute(MinHeap* minHeap);
+void bucketQueueEnqueue(MinHeap* minHeap, int vertexNumber, Distance value);
+int bucketQueueDequeue(MinHeap* minHeap);
+void bucketQueueDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value);
+Distance bucketQueuePeekValue(MinHeap* minHeap);
+void bucketQueuePlace(MinHeap* minHeap, int vertexNumber);
+void bucketQueueGrow(MinHeap* minHeap, int gap);
+void bucketQueueAdvance(MinHeap* minHeap);
+int bucketQueueIndex(MinHeap* minHeap, Distance value);
+
+
+static const MinHeapOperations binaryHeapOperations = {
+    binaryHeapEnqueue, binaryHeapDequeue, binaryHeapDecreaseNodeValue, arrayHeapPeekValue
+};
+
+static const MinHeapOperations daryHeapOperations = {
+    daryHeapEnqueue, daryHeapDequeue, daryHeapDecreaseNodeValue, arrayHeapPeekValue
+};
+
+static const MinHeapOperations pairingHeapOperations = {
+    pairingHeapEnqueue, pairingHeapDequeue, pairingHeapDecreaseNodeValue, pairingHeapPeekValue
+};
+
+static const MinHeapOperations radixHeapOperations = {
+    radixHeapEnqueue, radixHeapDequeue, radixHeapDecreaseNodeValue, radixHeapPeekValue
+};
+
+static const MinHeapOperations bucketQueueOperations = {
+    bucketQueueEnqueue, bucketQueueDequeue, bucketQueueDecreaseNodeValue, bucketQueuePeekValue
+};
 
 
 /*
- * Function: nodeConstructor
- * -------------------------
- * Mallocs space for a Node and returns a pointer
- * to the new Node. Each new node has no child Nodes
- * and is assigned a pointer to it's corresponding
- * Vertex in the graph.
+ * Function: minHeapConstructor
+ * ----------------------------
+ * Constructs an empty minHeap of the given type and
+ * returns a pointer to the new minHeap. A d-ary heap
+ * with two children per Node is made a binary heap.
  */
-Node* nodeConstructor(int position, Vertex* vertex){
+MinHeap* minHeapConstructor(MinHeapType type){
 
-    Node* newNode = malloc(sizeof(Node));
+    MinHeap* newMinHeap = malloc(sizeof(MinHeap));
+
+    if(type.kind == MIN_HEAP_DARY && type.arity <= 2){
+        type.kind = MIN_HEAP_BINARY;
+    }
+    if(type.kind == MIN_HEAP_BINARY){
+        type.arity = 2;
+    } else if(type.kind != MIN_HEAP_DARY){
+        type.arity = 0;
+    }
+
+    newMinHeap->type = type;
+    newMinHeap->size = 0;
+    newMinHeap->heap = NULL;
+    newMinHeap->capacity = 0;
+    newMinHeap->positionInHeap = NULL;
+    newMinHeap->positionCapacity = 0;
+    newMinHeap->pairingNodes = NULL;
+    newMinHeap->bucketNodes = NULL;
+    newMinHeap->nodeCapacity = 0;
+    newMinHeap->root = -1;
+    newMinHeap->buckets = NULL;
+    newMinHeap->numberOfBuckets = 0;
+    newMinHeap->lowest = 0;
+    newMinHeap->outside = -1;
+    newMinHeap->numberOutside = 0;
+    newMinHeap->outsideMinimum = DISTANCE_INFINITY;
+
+    if(type.kind == MIN_HEAP_PAIRING){
+        newMinHeap->operations = &pairingHeapOperations;
+    } else if(type.kind == MIN_HEAP_RADIX || type.kind == MIN_HEAP_BUCKET){
+        if(type.kind == MIN_HEAP_BUCKET && !WEIGHT_IS_WHOLE){
+            printf("\n#####################################\n");
+            printf("Error, a buckets queue needs whole number distances.\n");
+            printf("Please use another queue with this build.\n");
+            printf("#####################################\n\n");
+            exit(-1);
+        }
+        newMinHeap->operations = type.kind == MIN_HEAP_RADIX ? &radixHeapOperations : &bucketQueueOperations;
+        newMinHeap->numberOfBuckets = type.kind == MIN_HEAP_RADIX ? RADIX_BUCKET_COUNT : INITIAL_BUCKET_COUNT;
+        newMinHeap->buckets = malloc(newMinHeap->numberOfBuckets*sizeof(int));
+        bucketListClear(newMinHeap);
+    } else {
+        newMinHeap->operations = type.kind == MIN_HEAP_DARY ? &daryHeapOperations : &binaryHeapOperations;
+        newMinHeap->capacity = INITIAL_HEAP_CAPACITY;
+        newMinHeap->heap = malloc(INITIAL_HEAP_CAPACITY*sizeof(Node));
+    }
+    return newMinHeap;
+}
 
-    // This will initially be INT_MAX for all Nodes except source Node
-    newNode->value = vertexGetDistanceFromSource(vertex);
 
-    // Position is the index of the node within the heap
-    newNode->position = position;
+/*
+ * Function: minHeapDestructor
+ * ---------------------------
+ * Used to free memory used by heap. Frees the
+ * arrays of Nodes and positions then the minHeap
+ * structure.
+ */
+void minHeapDestructor(MinHeap* minHeap){
 
-    newNode->hasChildLeft = 0;
-    newNode->hasChildRight = 0;
-    newNode->vertex = vertex;
-    return newNode;
+    free(minHeap->heap);
+    free(minHeap->positionInHeap);
+    free(minHeap->pairingNodes);
+    free(minHeap->bucketNodes);
+    free(minHeap->buckets);
+    free(minHeap);
 }
 
 
 /*
- * Function: nodeDestructor
+ * Function: minHeapGetType
  * ------------------------
- * Frees the memory allocated for a Node.
+ * Returns the type the minHeap was constructed with.
  */
-void nodeDestructor(Node* node){
-    free(node);
+MinHeapType minHeapGetType(MinHeap* minHeap){
+    return minHeap->type;
 }
 
 
 /*
- * Function: minHeapConstructor
- * ----------------------------
- * Constructs an empty minHeap and returns
- * a pointer to the new minHeap.
+ * Function: minHeapEnqueue
+ * ------------------------
+ * Passes the new Node to the minHeap's own enqueue.
  */
-MinHeap* minHeapConstructor(){
+void minHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value){
+    minHeap->operations->enqueue(minHeap, vertexNumber, value);
+}
 
-    MinHeap* newMinHeap = malloc(sizeof(MinHeap));
-    newMinHeap->size = 0;
-    // Has no Nodes at first
-    newMinHeap->heap = NULL;
-    return newMinHeap;
+
+/*
+ * Function: minHeapDequeue
+ * ------------------------
+ * Returns the vertex number from the minHeap's own
+ * dequeue.
+ */
+int minHeapDequeue(MinHeap* minHeap){
+    return minHeap->operations->dequeue(minHeap);
 }
 
 
 /*
- * Function: minHeapResizeUp
- * -------------------------
- * Increases the size of the heap array by one
- * for adding new Nodes to heap.
+ * Function: minHeapDecreaseNodeValue
+ * ----------------------------------
+ * Passes the new value to the minHeap's own decrease.
  */
-void minHeapResizeUp(MinHeap* minHeap){
+void minHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value){
+    minHeap->operations->decreaseNodeValue(minHeap, vertexNumber, value);
+}
 
-    minHeap->heap = realloc(minHeap->heap, (minHeap->size + 1)*sizeof(Node*));
 
-    minHeap->heap[minHeap->size] = (Node*)malloc(sizeof(Node));
-    minHeap->heap[minHeap->size] = NULL;
+/*
+ * Function: minHeapPeekValue
+ * --------------------------
+ * Returns the value of the top Node from the minHeap's
+ * own peek.
+ */
+Distance minHeapPeekValue(MinHeap* minHeap){
+    return minHeap->operations->peekValue(minHeap);
 }
 
 
 /*
- * Function: minHeapResizeDown
- * ---------------------------
- * When removing Nodes decreases heap array by one.
+ * Function: printHeap
+ * -------------------
+ * Runs through the heap array printing all values, for
+ * a pairing heap only the value of the root and for a
+ * radix heap or bucket queue the values on each bucket's
+ * list in turn.
  */
-void minHeapResizeDown(MinHeap* minHeap){
+void printHeap(MinHeap* minHeap){
 
-    nodeDestructor(minHeap->heap[(minHeap->size -1)]);
-    minHeap->heap = realloc(minHeap->heap, (minHeap->size - 1)*sizeof(Node*));
+    int i;
+    int vertexNumber;
+    if(minHeap->type.kind == MIN_HEAP_PAIRING){
+        if(minHeap->root != -1){
+            printf("%" DISTANCE_FORMAT "\n", minHeap->pairingNodes[minHeap->root].value);
+        }
+    } else if(minHeap->buckets != NULL){
+        for(i = -1; i < minHeap->numberOfBuckets; i++){
+            vertexNumber = i == -1 ? minHeap->outside : minHeap->buckets[i];
+            for(; vertexNumber != -1; vertexNumber = minHeap->bucketNodes[vertexNumber].next){
+                printf("%" DISTANCE_FORMAT "\n", minHeap->bucketNodes[vertexNumber].value);
+            }
+        }
+    } else {
+        for(i = 0; i < minHeap->size; i++){
+            printf("%" DISTANCE_FORMAT "\n", minHeap->heap[i].value);
+        }
+    }
+    printf("\n");
 }
 
 
 /*
- * Function: minHeapDestructor
- * ---------------------------
- * Used to free memory used by heap. Frees all
- * Nodes in heap array first then frees minHeap
- * structure.
+ * Function: minHeapGetSize
+ * ------------------------
+ * Returns the size of the heap.
  */
-void minHeapDestructor(MinHeap* minHeap){
+int minHeapGetSize(MinHeap* minHeap){
+    return minHeap->size;
+}
 
-    int i;
-    for(i = 0; i < minHeap->size; i++){
-        nodeDestructor(minHeap->heap[i]);
+
+/*
+ * Function: minHeapIsEmpty
+ * ------------------------
+ * If size of heap is zero returns true.
+ */
+int minHeapIsEmpty(MinHeap* minHeap){
+    if(minHeap->size == 0){
+        return 1;
+    } else {
+        return 0;
     }
+}
 
-    free(minHeap);
+
+/*
+ * Function: minHeapClear
+ * ----------------------
+ * Empties the heap, keeping its arrays at their current
+ * capacity for reuse. The pairing heap's Nodes are set up
+ * again when next enqueued so need no clearing, but each
+ * bucket's list is emptied.
+ */
+void minHeapClear(MinHeap* minHeap){
+    minHeap->size = 0;
+    minHeap->root = -1;
+    if(minHeap->buckets != NULL){
+        bucketListClear(minHeap);
+    }
 }
 
 
 /*
- * Function: swapNode
- * ------------------
- * Swaps all the necessary information between two Nodes in the
- * Heap. Initially creates a temporary pointer to one of the
- * Nodes and two temporary integers to store the state of one
- * of the Nodes children.
+ * Function: minHeapReserve
+ * ------------------------
+ * Grows the arrays of the minHeap's kind to hold capacity
+ * Nodes with vertex numbers up to capacity - 1, if they
+ * are smaller.
  */
-void swapNode(MinHeap* minHeap, int currentPosition, int otherPosition){
+void minHeapReserve(MinHeap* minHeap, int capacity){
+
+    if(minHeap->type.kind == MIN_HEAP_PAIRING || minHeap->buckets != NULL){
+        if(capacity > minHeap->nodeCapacity){
+            minHeap->nodeCapacity = capacity;
+            minHeapGrowNodes(minHeap, capacity);
+        }
+        return;
+    }
+
+    if(capacity > minHeap->capacity){
+        minHeap->capacity = capacity;
+        minHeap->heap = realloc(minHeap->heap, capacity*sizeof(Node));
+    }
+    if(capacity > minHeap->positionCapacity){
+        minHeap->positionCapacity = capacity;
+        minHeap->positionInHeap = realloc(minHeap->positionInHeap, capacity*sizeof(int));
+    }
+}
 
-    Node* tempNode;
-    tempNode = minHeap->heap[currentPosition];
 
-    // This is needed as information would otherwise
-    // be lost when swapping state of children
-    int tempHasChildLeft, tempHasChildRight;
-    tempHasChildLeft = tempNode->hasChildLeft;
-    tempHasChildRight = tempNode->hasChildRight;
+/*
+ * Function: minHeapSetPosition
+ * ----------------------------
+ * Records where the Node of a vertex number is in the heap,
+ * doubling the positionInHeap array first if the vertex
+ * number does not fit.
+ */
+void minHeapSetPosition(MinHeap* minHeap, int vertexNumber, int position){
 
-    // Swapping state of child Nodes
-    minHeap->heap[currentPosition]->hasChildLeft = minHeap->heap[otherPosition]->hasChildLeft;
-    minHeap->heap[currentPosition]->hasChildRight = minHeap->heap[otherPosition]->hasChildRight;
-    minHeap->heap[otherPosition]->hasChildLeft = tempHasChildLeft;
-    minHeap->heap[otherPosition]->hasChildRight = tempHasChildRight;
+    if(vertexNumber >= minHeap->positionCapacity){
+        int newCapacity = minHeap->positionCapacity == 0 ? 64 : minHeap->positionCapacity;
+        while(newCapacity <= vertexNumber){
+            newCapacity *= 2;
+        }
+        minHeap->positionInHeap = realloc(minHeap->positionInHeap, newCapacity*sizeof(int));
+        minHeap->positionCapacity = newCapacity;
+    }
+    minHeap->positionInHeap[vertexNumber] = position;
+}
 
-    // Swapping actual Node pointers
-    minHeap->heap[currentPosition] = minHeap->heap[otherPosition];
-    minHeap->heap[otherPosition] = tempNode;
 
-    // Swapping position indices
-    minHeap->heap[otherPosition]->position = otherPosition;
-    // Updating information of location in Heap for the Vertex in the Graph
-    vertexSetPositionInHeap(minHeap->heap[otherPosition]->vertex, otherPosition);
+/*
+ * Function: minHeapGrowNodes
+ * --------------------------
+ * Reallocates the array of Nodes indexed by vertex number
+ * used by the minHeap's kind to hold capacity Nodes.
+ */
+void minHeapGrowNodes(MinHeap* minHeap, int capacity){
 
-    minHeap->heap[currentPosition]->position = currentPosition;
-    vertexSetPositionInHeap(minHeap->heap[currentPosition]->vertex, currentPosition);
+    if(minHeap->type.kind == MIN_HEAP_PAIRING){
+        minHeap->pairingNodes = realloc(minHeap->pairingNodes, capacity*sizeof(PairingNode));
+    } else {
+        minHeap->bucketNodes = realloc(minHeap->bucketNodes, capacity*sizeof(BucketNode));
+    }
 }
 
 
 /*
- * Function: minHeapEnqueue
+ * Function: minHeapFitNode
  * ------------------------
+ * Doubles the array of Nodes indexed by vertex number
+ * until the vertex number fits.
+ */
+void minHeapFitNode(MinHeap* minHeap, int vertexNumber){
+
+    int newCapacity = minHeap->nodeCapacity == 0 ? INITIAL_HEAP_CAPACITY : minHeap->nodeCapacity;
+    while(newCapacity <= vertexNumber){
+        newCapacity *= 2;
+    }
+    minHeapGrowNodes(minHeap, newCapacity);
+    minHeap->nodeCapacity = newCapacity;
+}
+
+
+/*
+ * Function: arrayHeapPeekValue
+ * ----------------------------
+ * Returns the value of the Node at index zero.
+ */
+Distance arrayHeapPeekValue(MinHeap* minHeap){
+    return minHeap->heap[0].value;
+}
+
+
+/*
+ * Function: binaryHeapSiftUp
+ * --------------------------
+ * While the Node at currentPosition has a smaller value
+ * than its parent, moves the parent down into its place.
+ * The Node is only written once, where it ends up.
+ */
+void binaryHeapSiftUp(MinHeap* minHeap, int currentPosition){
+
+    Node node = minHeap->heap[currentPosition];
+    int parentPosition;
+
+    while(currentPosition > 0){
+
+        // MinHeap has Node at index zero so parent position is (childPosition - 1)/2
+        parentPosition = (currentPosition - 1)/2;
+
+        if(node.value >= minHeap->heap[parentPosition].value){
+            break;
+        }
+
+        minHeap->heap[currentPosition] = minHeap->heap[parentPosition];
+        minHeap->positionInHeap[minHeap->heap[currentPosition].vertexNumber] = currentPosition;
+        currentPosition = parentPosition;
+    }
+
+    minHeap->heap[currentPosition] = node;
+    minHeap->positionInHeap[node.vertexNumber] = currentPosition;
+}
+
+
+/*
+ * Function: binaryHeapEnqueue
+ * ---------------------------
  * Add a new Node to the Heap. Need to send in
- * a Vertex pointer as information associated with
- * the Heap is stored in each Vertex. Increases size
- * of the Heap array. Adds a new Node to end of heap
- * array and then sifts up the Node to the correct
- * position in the heap.
+ * the vertex number and its distance from source.
+ * Doubles the heap array if it is full. Adds the new
+ * Node to end of heap array and then sifts up the
+ * Node to the correct position in the heap.
  */
-void minHeapEnqueue(MinHeap* minHeap, Vertex* vertex){
+void binaryHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    if(minHeap->size == minHeap->capacity){
+        minHeap->capacity *= 2;
+        minHeap->heap = realloc(minHeap->heap, minHeap->capacity*sizeof(Node));
+    }
 
-    minHeapResizeUp(minHeap);
     // Furthest right point in array gets the new Node
-    minHeap->heap[minHeap->size] = nodeConstructor(minHeap->size, vertex);
-    // Update the associated Vertex with position in Heap
-    vertexSetPositionInHeap(vertex, minHeap->size);
+    minHeap->heap[minHeap->size].value = value;
+    minHeap->heap[minHeap->size].vertexNumber = vertexNumber;
+    // Record the position in Heap of the vertex number
+    minHeapSetPosition(minHeap, vertexNumber, minHeap->size);
     minHeap->size++;
 
-    int currentPosition;
-    int parentPosition;
+    binaryHeapSiftUp(minHeap, minHeap->size - 1);
+}
 
-    currentPosition = minHeap->size - 1;
-    // MinHeap has Node at index zero so parent position is floor((childPosition - 1)/2)
-    parentPosition = (int)floor(((currentPosition - 1)/2));
 
-    // If new Node is not the top Node
-    if(currentPosition > 0){
-        // If new Node index is even
-        if( currentPosition % 2 == 0){
-            // The parent Node now has a child on it's right
-            minHeap->heap[parentPosition]->hasChildRight = 1;
-        } else {
-            // The parent Node now has a child on it's Left
-            minHeap->heap[parentPosition]->hasChildLeft = 1;
+/*
+ * Function: binaryHeapSiftDown
+ * ----------------------------
+ * Checks if top Node is greater than or equal in value to the
+ * smallest of its children and if so moves that child up, the
+ * right one if they are equal. This is repeated until Heap
+ * order is satisfied, then the Node is written where it ends up.
+ */
+void binaryHeapSiftDown(MinHeap* minHeap){
+
+    Node node = minHeap->heap[0];
+    int currentPosition = 0;
+    int childPosition;
+
+    // Heap has Node at index zero so the left child is at 2*position + 1
+    while((childPosition = 2*currentPosition + 1) < minHeap->size){
+
+        // Right child, if there is one and it is not larger
+        if(childPosition + 1 < minHeap->size
+           && minHeap->heap[childPosition + 1].value <= minHeap->heap[childPosition].value){
+            childPosition++;
         }
+
+        if(node.value < minHeap->heap[childPosition].value){
+            break; // In correct position
+        }
+
+        minHeap->heap[currentPosition] = minHeap->heap[childPosition];
+        minHeap->positionInHeap[minHeap->heap[currentPosition].vertexNumber] = currentPosition;
+        currentPosition = childPosition;
     }
 
-    // While the new Nodes value is smaller than its parents value
-    // swap them around. Sifting up.
-    while((minHeap->heap[currentPosition]->value < minHeap->heap[parentPosition]->value)){
-        swapNode(minHeap, currentPosition, parentPosition);
+    minHeap->heap[currentPosition] = node;
+    minHeap->positionInHeap[node.vertexNumber] = currentPosition;
+}
+
+
+/*
+ * Function: binaryHeapDequeue
+ * ---------------------------
+ * Returns the vertex number associated with the
+ * top Node of the Heap. Then removes that Node from
+ * the heap and moves the furthest right Node to the
+ * top. Then sifts down to re-establish heap structure.
+ */
+int binaryHeapDequeue(MinHeap* minHeap){
+
+    // Associated vertex number of the top Node
+    int minVertex = minHeap->heap[0].vertexNumber;
+
+    minHeap->size--;
+
+    // If there was more than one Node
+    if(minHeap->size > 0){
+        // Moving most right Node to top
+        minHeap->heap[0] = minHeap->heap[minHeap->size];
+        binaryHeapSiftDown(minHeap);
+    }
+    return minVertex;
+}
+
+
+/*
+ * Function: binaryHeapDecreaseNodeValue
+ * -------------------------------------
+ * Reduces a specific Nodes value and then sifts up
+ * till the Heap is correctly sorted.
+ */
+void binaryHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    int currentPosition = minHeap->positionInHeap[vertexNumber];
+
+    // Reducing Node value with new distance of associated Vertex
+    minHeap->heap[currentPosition].value = value;
+    binaryHeapSiftUp(minHeap, currentPosition);
+}
+
+
+/*
+ * Function: daryHeapSiftUp
+ * ------------------------
+ * Same as binaryHeapSiftUp with arity children per Node.
+ */
+void daryHeapSiftUp(MinHeap* minHeap, int currentPosition){
+
+    int arity = minHeap->type.arity;
+    Node node = minHeap->heap[currentPosition];
+    int parentPosition;
+
+    while(currentPosition > 0){
+
+        parentPosition = (currentPosition - 1)/arity;
+
+        if(node.value >= minHeap->heap[parentPosition].value){
+            break;
+        }
+
+        minHeap->heap[currentPosition] = minHeap->heap[parentPosition];
+        minHeap->positionInHeap[minHeap->heap[currentPosition].vertexNumber] = currentPosition;
         currentPosition = parentPosition;
-        parentPosition = (int)floor(((currentPosition - 1)/2));
     }
+
+    minHeap->heap[currentPosition] = node;
+    minHeap->positionInHeap[node.vertexNumber] = currentPosition;
 }
 
 
 /*
- * Function: minHeapSiftDown
+ * Function: daryHeapEnqueue
  * -------------------------
- * Checks if top Node is greater in value than it's children
- * and if so swaps with the smallest of it's children. This is
- * repeated until Heap order is satisfied.
- */
-void minHeapSiftDown(MinHeap* minHeap){
-
-    int currentPosition;
-    int childPositionLeft, childPositionRight;
-    int leftValue, rightValue;
-
-    // Current position is top of heap
-    currentPosition = 0;
-
-    // Heap has Node at index zero so child positions are:
-    childPositionLeft = 2*currentPosition + 1;
-    childPositionRight = 2*currentPosition + 2;
-
-    // While current Node has a child on either the left or right
-    while(minHeap->heap[currentPosition]->hasChildLeft || minHeap->heap[currentPosition]->hasChildRight){
-
-        // If it has children on both sides
-        if(minHeap->heap[currentPosition]->hasChildLeft && minHeap->heap[currentPosition]->hasChildRight){
-            // Assign values of children to variables for readability
-            leftValue = minHeap->heap[childPositionLeft]->value;
-            rightValue = minHeap->heap[childPositionRight]->value;
-
-            // If current Node is greater than or equal in value than either of its children
-            if(minHeap->heap[currentPosition]->value >= leftValue
-                || minHeap->heap[currentPosition]->value >= rightValue){
-
-                // Checking which of children is smaller
-                if((rightValue - leftValue) <= 0) {
-                    // Right value is smaller or both equal
-                    swapNode(minHeap, currentPosition, childPositionRight);
-                    // Update current position variable
-                    currentPosition = childPositionRight;
-
-                } else{
-                    // Left value is smaller
-                    swapNode(minHeap, currentPosition, childPositionLeft);
-                    currentPosition = childPositionLeft;
-                }
-            } else {
-                break; // In correct position
-            }
+ * Same as binaryHeapEnqueue with arity children per Node.
+ */
+void daryHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    if(minHeap->size == minHeap->capacity){
+        minHeap->capacity *= 2;
+        minHeap->heap = realloc(minHeap->heap, minHeap->capacity*sizeof(Node));
+    }
+
+    minHeap->heap[minHeap->size].value = value;
+    minHeap->heap[minHeap->size].vertexNumber = vertexNumber;
+    minHeapSetPosition(minHeap, vertexNumber, minHeap->size);
+    minHeap->size++;
+
+    daryHeapSiftUp(minHeap, minHeap->size - 1);
+}
+
+
+/*
+ * Function: daryHeapSiftDown
+ * --------------------------
+ * Same as binaryHeapSiftDown but finds the smallest of up
+ * to arity children, the last of them if several are equal.
+ */
+void daryHeapSiftDown(MinHeap* minHeap){
 
-        // Only has a child on its left side
-        } else if(minHeap->heap[currentPosition]->hasChildLeft){
-            // Assign value of child to variable for readability
-            leftValue = minHeap->heap[childPositionLeft]->value;
-
-            // If current Node is greater than or equal in value than its child
-            if(minHeap->heap[currentPosition]->value >= leftValue){
-                swapNode(minHeap, currentPosition, childPositionLeft);
-                currentPosition = childPositionLeft;
-            } else {
-                break; // In correct position
+    int arity = minHeap->type.arity;
+    Node node = minHeap->heap[0];
+    int currentPosition = 0;
+    int firstChild;
+    int lastChild;
+    int childPosition;
+
+    int i;
+    while((firstChild = arity*currentPosition + 1) < minHeap->size){
+
+        lastChild = firstChild + arity - 1 < minHeap->size - 1 ? firstChild + arity - 1 : minHeap->size - 1;
+
+        childPosition = firstChild;
+        for(i = firstChild + 1; i <= lastChild; i++){
+            if(minHeap->heap[i].value <= minHeap->heap[childPosition].value){
+                childPosition = i;
             }
+        }
+
+        if(node.value < minHeap->heap[childPosition].value){
+            break; // In correct position
+        }
 
-        // Only has a child on its right side
+        minHeap->heap[currentPosition] = minHeap->heap[childPosition];
+        minHeap->positionInHeap[minHeap->heap[currentPosition].vertexNumber] = currentPosition;
+        currentPosition = childPosition;
+    }
+
+    minHeap->heap[currentPosition] = node;
+    minHeap->positionInHeap[node.vertexNumber] = currentPosition;
+}
+
+
+/*
+ * Function: daryHeapDequeue
+ * -------------------------
+ * Same as binaryHeapDequeue with arity children per Node.
+ */
+int daryHeapDequeue(MinHeap* minHeap){
+
+    int minVertex = minHeap->heap[0].vertexNumber;
+
+    minHeap->size--;
+
+    if(minHeap->size > 0){
+        minHeap->heap[0] = minHeap->heap[minHeap->size];
+        daryHeapSiftDown(minHeap);
+    }
+    return minVertex;
+}
+
+
+/*
+ * Function: daryHeapDecreaseNodeValue
+ * -----------------------------------
+ * Same as binaryHeapDecreaseNodeValue with arity
+ * children per Node.
+ */
+void daryHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    int currentPosition = minHeap->positionInHeap[vertexNumber];
+
+    minHeap->heap[currentPosition].value = value;
+    daryHeapSiftUp(minHeap, currentPosition);
+}
+
+
+/*
+ * Function: pairingHeapLink
+ * -------------------------
+ * Joins two trees, given by their roots, by making the
+ * root with the larger value the first child of the
+ * other, the first root if they are equal. Returns the
+ * root of the joined tree, with no siblings or parent.
+ */
+int pairingHeapLink(PairingNode* nodes, int first, int second){
+
+    int parent = first;
+    int child = second;
+
+    if(nodes[second].value < nodes[first].value){
+        parent = second;
+        child = first;
+    }
+
+    nodes[child].sibling = nodes[parent].child;
+    if(nodes[parent].child != -1){
+        nodes[nodes[parent].child].previous = child;
+    }
+    nodes[child].previous = parent;
+    nodes[parent].child = child;
+    nodes[parent].sibling = -1;
+    nodes[parent].previous = -1;
+
+    return parent;
+}
+
+
+/*
+ * Function: pairingHeapEnqueue
+ * ----------------------------
+ * Sets up the vertex number's Node, growing the array of
+ * Nodes first if it does not fit, as a tree of its own
+ * and links it with the root.
+ */
+void pairingHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    if(vertexNumber >= minHeap->nodeCapacity){
+        minHeapFitNode(minHeap, vertexNumber);
+    }
+
+    PairingNode* nodes = minHeap->pairingNodes;
+
+    nodes[vertexNumber].value = value;
+    nodes[vertexNumber].child = -1;
+    nodes[vertexNumber].sibling = -1;
+    nodes[vertexNumber].previous = -1;
+
+    minHeap->root = minHeap->root == -1 ? vertexNumber : pairingHeapLink(nodes, minHeap->root, vertexNumber);
+    minHeap->size++;
+}
+
+
+/*
+ * Function: pairingHeapDequeue
+ * ----------------------------
+ * Returns the vertex number of the root and joins its
+ * children into the new tree in two passes. The first
+ * links them in pairs from the left, keeping the joined
+ * pairs in a list through their sibling links, which ends
+ * up with the rightmost pair first. The second links each
+ * pair into the tree in that order.
+ */
+int pairingHeapDequeue(MinHeap* minHeap){
+
+    PairingNode* nodes = minHeap->pairingNodes;
+    int minVertex = minHeap->root;
+    int pairs = -1;
+    int first = nodes[minVertex].child;
+    int second;
+    int next;
+    int joined;
+
+    while(first != -1){
+        second = nodes[first].sibling;
+        if(second == -1){
+            next = -1;
+            joined = first;
         } else {
-            // Assign value of child to variable for readability
-            rightValue = minHeap->heap[childPositionRight]->value;
-
-            // If current Node is greater than or equal in value than its child
-            if(minHeap->heap[currentPosition]->value >= rightValue){
-                swapNode(minHeap, currentPosition, childPositionRight);
-                currentPosition = childPositionRight;
-            } else {
-                break; // In correct position
-            }
+            next = nodes[second].sibling;
+            joined = pairingHeapLink(nodes, first, second);
         }
+        nodes[joined].sibling = pairs;
+        pairs = joined;
+        first = next;
+    }
 
-        // New children positions in heap
-        childPositionLeft = 2*currentPosition + 1;
-        childPositionRight = 2*currentPosition + 2;
+    minHeap->root = pairs;
+    if(pairs != -1){
+        next = nodes[pairs].sibling;
+        nodes[pairs].sibling = -1;
+        nodes[pairs].previous = -1;
+        while(next != -1){
+            joined = next;
+            next = nodes[joined].sibling;
+            minHeap->root = pairingHeapLink(nodes, minHeap->root, joined);
+        }
     }
+
+    minHeap->size--;
+    return minVertex;
 }
 
 
 /*
- * Function: printHeap
- * -------------------
- * Runs through the heap array printing all values.
+ * Function: pairingHeapDecreaseNodeValue
+ * --------------------------------------
+ * Lowers the value of the vertex number's Node. Unless it
+ * is the root its tree is cut from its parent's list of
+ * children and linked with the root.
  */
-void printHeap(MinHeap* minHeap){
+void pairingHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value){
 
-    int i;
-    for(i = 0; i < minHeap->size; i++){
-        printf("%d\n", minHeap->heap[i]->value);
+    PairingNode* nodes = minHeap->pairingNodes;
+    nodes[vertexNumber].value = value;
+
+    if(vertexNumber == minHeap->root){
+        return;
     }
-    printf("\n");
+
+    int previous = nodes[vertexNumber].previous;
+    int sibling = nodes[vertexNumber].sibling;
+
+    if(nodes[previous].child == vertexNumber){
+        nodes[previous].child = sibling;
+    } else {
+        nodes[previous].sibling = sibling;
+    }
+    if(sibling != -1){
+        nodes[sibling].previous = previous;
+    }
+
+    minHeap->root = pairingHeapLink(nodes, minHeap->root, vertexNumber);
 }
 
 
 /*
- * Function: minHeapGetSize
- * ------------------------
- * Returns the size of the heap.
+ * Function: pairingHeapPeekValue
+ * ------------------------------
+ * Returns the value of the root.
  */
-int minHeapGetSize(MinHeap* minHeap){
-    return minHeap->size;
+Distance pairingHeapPeekValue(MinHeap* minHeap){
+    return minHeap->pairingNodes[minHeap->root].value;
 }
 
 
 /*
- * Function: minHeapIsEmpty
+ * Function: bucketListPush
  * ------------------------
- * If size of heap is zero returns true.
+ * Puts the vertex number's Node at the front of the list of
+ * a bucket, or of the bucket queue's list beyond the ring if
+ * bucket is -1.
  */
-int minHeapIsEmpty(MinHeap* minHeap){
-    if(minHeap->size == 0){
-        return 1;
+void bucketListPush(MinHeap* minHeap, int bucket, int vertexNumber){
+
+    BucketNode* nodes = minHeap->bucketNodes;
+    int* first = bucket == -1 ? &minHeap->outside : &minHeap->buckets[bucket];
+
+    nodes[vertexNumber].bucket = bucket;
+    nodes[vertexNumber].previous = -1;
+    nodes[vertexNumber].next = *first;
+    if(*first != -1){
+        nodes[*first].previous = vertexNumber;
+    }
+    *first = vertexNumber;
+}
+
+
+/*
+ * Function: bucketListRemove
+ * --------------------------
+ * Takes the vertex number's Node off the list it is on.
+ */
+void bucketListRemove(MinHeap* minHeap, int vertexNumber){
+
+    BucketNode* nodes = minHeap->bucketNodes;
+    int bucket = nodes[vertexNumber].bucket;
+    int previous = nodes[vertexNumber].previous;
+    int next = nodes[vertexNumber].next;
+
+    if(previous != -1){
+        nodes[previous].next = next;
+    } else if(bucket == -1){
+        minHeap->outside = next;
     } else {
+        minHeap->buckets[bucket] = next;
+    }
+    if(next != -1){
+        nodes[next].previous = previous;
+    }
+}
+
+
+/*
+ * Function: bucketListClear
+ * -------------------------
+ * Empties every bucket's list, ready for a new search
+ * starting from a value of zero.
+ */
+void bucketListClear(MinHeap* minHeap){
+
+    int i;
+    for(i = 0; i < minHeap->numberOfBuckets; i++){
+        minHeap->buckets[i] = -1;
+    }
+    minHeap->lowest = 0;
+    minHeap->outside = -1;
+    minHeap->numberOutside = 0;
+    minHeap->outsideMinimum = DISTANCE_INFINITY;
+}
+
+
+/*
+ * Function: bucketCheckValue
+ * --------------------------
+ * Exits with an error if a value lower than the last one
+ * taken off is added to a radix heap or bucket queue, which
+ * can not sort it.
+ */
+void bucketCheckValue(MinHeap* minHeap, Distance value){
+
+    if(value < minHeap->lowest){
+        printf("\n#####################################\n");
+        printf("Error, %" DISTANCE_FORMAT " added to a %s queue after %" DISTANCE_FORMAT " was taken off.\n", value,
+               minHeap->type.kind == MIN_HEAP_RADIX ? "radix" : "buckets", minHeap->lowest);
+        printf("Please use a heap for searches whose values can go down.\n");
+        printf("#####################################\n\n");
+        exit(-1);
+    }
+}
+
+
+/*
+ * Function: radixHeapBucket
+ * -------------------------
+ * Returns the bucket for a value, zero if it equals
+ * lowest and otherwise one more than the position of
+ * the highest bit they differ in. Doubles are compared
+ * by the bits they are stored as.
+ */
+int radixHeapBucket(Distance value, Distance lowest){
+
+#if WEIGHT_IS_WHOLE
+    uint64_t difference = (uint64_t)value ^ (uint64_t)lowest;
+#else
+    // A double that is not negative sorts the same way as its bits
+    uint64_t valueBits;
+    uint64_t lowestBits;
+    memcpy(&valueBits, &value, sizeof(uint64_t));
+    memcpy(&lowestBits, &lowest, sizeof(uint64_t));
+    uint64_t difference = valueBits ^ lowestBits;
+#endif
+
+    if(difference == 0){
         return 0;
     }
+#ifdef __GNUC__
+    return 64 - __builtin_clzll(difference);
+#else
+    int bucket = 0;
+    while(difference != 0){
+        difference >>= 1;
+        bucket++;
+    }
+    return bucket;
+#endif
 }
 
 
 /*
- * Function: minHeapDequeue
- * ------------------------
- * Returns pointer to the Vertex associated with the
- * top Node of the Heap. Then removes that Node from
- * the heap and moves the furthest right Node to the
- * top. Then sifts down to re-establish heap structure.
+ * Function: radixHeapEnqueue
+ * --------------------------
+ * Sets up the vertex number's Node, growing the array of
+ * Nodes first if it does not fit, and puts it in the bucket
+ * for its value. An empty heap is cleared first, as a
+ * search that took every Node off leaves lowest behind.
  */
-Vertex* minHeapDequeue(MinHeap* minHeap){
+void radixHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value){
 
-    Vertex* minVertex;
-    Node* tempNode;
-    // Top Node on Heap
-    tempNode = minHeap->heap[0];
-    // Associated Vertex
-    minVertex = tempNode->vertex;
+    // An empty queue can start again from any value
+    if(minHeap->size == 0){
+        bucketListClear(minHeap);
+    }
+    bucketCheckValue(minHeap, value);
 
-    // If there is more than one Node
-    if(minHeap->size > 1){
+    if(vertexNumber >= minHeap->nodeCapacity){
+        minHeapFitNode(minHeap, vertexNumber);
+    }
 
-        // Moving most right value to top
-        minHeap->heap[0] = minHeap->heap[(minHeap->size - 1)];
+    minHeap->bucketNodes[vertexNumber].value = value;
+    bucketListPush(minHeap, radixHeapBucket(value, minHeap->lowest), vertexNumber);
+    minHeap->size++;
+}
 
-        // Changing its position variable value to 0;
-        minHeap->heap[0]->position = 0;
-        vertexSetPositionInHeap(minHeap->heap[0]->vertex, 0);
 
-        // Updating state of children with previous top Nodes values
-        minHeap->heap[0]->hasChildLeft = tempNode->hasChildLeft;
-        minHeap->heap[0]->hasChildRight = tempNode->hasChildRight;
+/*
+ * Function: radixHeapRedistribute
+ * -------------------------------
+ * If bucket zero is empty finds the smallest value in the
+ * lowest bucket that is not, makes it lowest and moves
+ * that bucket's Nodes to the buckets for their values,
+ * which are all lower and include bucket zero. Buckets
+ * further up keep their Nodes as lowest has not changed
+ * in the bits that chose them.
+ */
+void radixHeapRedistribute(MinHeap* minHeap){
 
-        int parentNode;
+    BucketNode* nodes = minHeap->bucketNodes;
+    int bucket = 0;
+    int vertexNumber;
+    int next;
 
-        // Parent of most right Node
-        parentNode = (int)floor(((minHeap->size - 2)/2));
+    if(minHeap->buckets[0] != -1){
+        return;
+    }
+    while(minHeap->buckets[bucket] == -1){
+        bucket++;
+    }
 
-        // Updating state of its children as it has
-        // just lost one to the top of the heap
-        // If size is even
-        if( minHeap->size % 2 == 0){
-            // It lost a child on its left
-            minHeap->heap[parentNode]->hasChildLeft = 0;
-        } else {
-            // It lost a child on its right
-            minHeap->heap[parentNode]->hasChildRight = 0;
+    minHeap->lowest = DISTANCE_INFINITY;
+    for(vertexNumber = minHeap->buckets[bucket]; vertexNumber != -1; vertexNumber = nodes[vertexNumber].next){
+        if(nodes[vertexNumber].value < minHeap->lowest){
+            minHeap->lowest = nodes[vertexNumber].value;
         }
+    }
 
+    vertexNumber = minHeap->buckets[bucket];
+    minHeap->buckets[bucket] = -1;
+    while(vertexNumber != -1){
+        next = nodes[vertexNumber].next;
+        bucketListPush(minHeap, radixHeapBucket(nodes[vertexNumber].value, minHeap->lowest), vertexNumber);
+        vertexNumber = next;
+    }
+}
 
-        // Setting most right Node of heap as null pointer
-        minHeap->heap[(minHeap->size - 1)] = NULL;
-        // Resizing heap
-        minHeapResizeDown(minHeap);
-        minHeap->size--;
-        minHeapSiftDown(minHeap);
-        nodeDestructor(tempNode);
 
-    // Only one Node Remaining
-    } else {
-        minHeap->heap[(minHeap->size - 1)] = NULL;
-        minHeapResizeDown(minHeap);
-        minHeap->size--;
-        nodeDestructor(tempNode);
-    }
+/*
+ * Function: radixHeapDequeue
+ * --------------------------
+ * Returns the vertex number of a Node in bucket zero,
+ * filling it first if needed, and takes it off.
+ */
+int radixHeapDequeue(MinHeap* minHeap){
+
+    radixHeapRedistribute(minHeap);
+
+    int minVertex = minHeap->buckets[0];
+    bucketListRemove(minHeap, minVertex);
+    minHeap->size--;
     return minVertex;
 }
 
 
 /*
- * Function: minHeapDecreaseNodeValue
- * ----------------------------------
- * Reduces a specific Nodes value and then sifts up
- * till the Heap is correctly sorted.
+ * Function: radixHeapDecreaseNodeValue
+ * ------------------------------------
+ * Lowers the value of the vertex number's Node and moves
+ * it to the bucket for its new value if that is another.
  */
-void minHeapDecreaseNodeValue(MinHeap* minHeap, Vertex* vertex){
+void radixHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value){
 
-    int currentPosition;
-    int parentPosition;
+    bucketCheckValue(minHeap, value);
 
-    currentPosition = vertexGetPositionInHeap(vertex);
-    // MinHeap has Node at index zero so parent position is floor((childPosition - 1)/2)
-    parentPosition = (int)floor(((currentPosition - 1)/2));
+    int bucket = radixHeapBucket(value, minHeap->lowest);
 
-    // Reducing Node value with new distance of associated Vertex
-    minHeap->heap[currentPosition]->value = vertexGetDistanceFromSource(vertex);
+    minHeap->bucketNodes[vertexNumber].value = value;
+    if(bucket != minHeap->bucketNodes[vertexNumber].bucket){
+        bucketListRemove(minHeap, vertexNumber);
+        bucketListPush(minHeap, bucket, vertexNumber);
+    }
+}
 
-    // While the new Nodes value is smaller than its parents value
-    // swap them around. Sifting up.
-    while((minHeap->heap[currentPosition]->value < minHeap->heap[parentPosition]->value)){
-        swapNode(minHeap, currentPosition, parentPosition);
-        currentPosition = parentPosition;
-        parentPosition = (int)floor(((currentPosition - 1)/2));
+
+/*
+ * Function: radixHeapPeekValue
+ * ----------------------------
+ * Fills bucket zero if needed and returns lowest, the
+ * value of every Node in it.
+ */
+Distance radixHeapPeekValue(MinHeap* minHeap){
+
+    radixHeapRedistribute(minHeap);
+    return minHeap->lowest;
+}
+
+
+/*
+ * Function: bucketQueueIndex
+ * --------------------------
+ * Returns the bucket of the ring a whole number value
+ * goes in, the ring being a power of two long.
+ */
+int bucketQueueIndex(MinHeap* minHeap, Distance value){
+    return (int)((int64_t)value & (minHeap->numberOfBuckets - 1));
+}
+
+
+/*
+ * Function: bucketQueueGrow
+ * -------------------------
+ * Doubles the ring of buckets until gap fits in it and
+ * moves every Node in the ring to its bucket in the new
+ * ring.
+ */
+void bucketQueueGrow(MinHeap* minHeap, int gap){
+
+    BucketNode* nodes = minHeap->bucketNodes;
+    int* oldBuckets = minHeap->buckets;
+    int oldNumberOfBuckets = minHeap->numberOfBuckets;
+    int vertexNumber;
+    int next;
+
+    while(minHeap->numberOfBuckets <= gap){
+        minHeap->numberOfBuckets *= 2;
+    }
+    minHeap->buckets = malloc(minHeap->numberOfBuckets*sizeof(int));
+
+    int i;
+    for(i = 0; i < minHeap->numberOfBuckets; i++){
+        minHeap->buckets[i] = -1;
+    }
+    for(i = 0; i < oldNumberOfBuckets; i++){
+        vertexNumber = oldBuckets[i];
+        while(vertexNumber != -1){
+            next = nodes[vertexNumber].next;
+            bucketListPush(minHeap, bucketQueueIndex(minHeap, nodes[vertexNumber].value), vertexNumber);
+            vertexNumber = next;
+        }
+    }
+    free(oldBuckets);
+}
+
+
+/*
+ * Function: bucketQueuePlace
+ * --------------------------
+ * Puts the vertex number's Node in the ring, growing the
+ * ring if its value is too far above lowest to fit, or on
+ * the list beyond the ring if the ring can not grow that
+ * far or the value is larger than one already beyond it.
+ * Every value in the ring is then no larger than those
+ * beyond it.
+ */
+void bucketQueuePlace(MinHeap* minHeap, int vertexNumber){
+
+    Distance value = minHeap->bucketNodes[vertexNumber].value;
+    Distance gap = value - minHeap->lowest;
+
+    if(value <= minHeap->outsideMinimum){
+        if(gap >= minHeap->numberOfBuckets && gap < MAXIMUM_BUCKET_COUNT){
+            bucketQueueGrow(minHeap, (int)gap);
+        }
+        if(gap < minHeap->numberOfBuckets){
+            bucketListPush(minHeap, bucketQueueIndex(minHeap, value), vertexNumber);
+            return;
+        }
+        minHeap->outsideMinimum = value;
+    }
+
+    bucketListPush(minHeap, -1, vertexNumber);
+    minHeap->numberOutside++;
+}
+
+
+/*
+ * Function: bucketQueueAdvance
+ * ----------------------------
+ * Moves lowest up to the value of the first Node in the
+ * ring. If the ring is empty lowest becomes the smallest
+ * value beyond it and those Nodes are placed again, which
+ * moves the ones now in reach into the ring.
+ */
+void bucketQueueAdvance(MinHeap* minHeap){
+
+    BucketNode* nodes = minHeap->bucketNodes;
+    int vertexNumber;
+    int next;
+
+    if(minHeap->numberOutside == minHeap->size){
+
+        minHeap->lowest = DISTANCE_INFINITY;
+        for(vertexNumber = minHeap->outside; vertexNumber != -1; vertexNumber = nodes[vertexNumber].next){
+            if(nodes[vertexNumber].value < minHeap->lowest){
+                minHeap->lowest = nodes[vertexNumber].value;
+            }
+        }
+
+        vertexNumber = minHeap->outside;
+        minHeap->outside = -1;
+        minHeap->numberOutside = 0;
+        minHeap->outsideMinimum = DISTANCE_INFINITY;
+        while(vertexNumber != -1){
+            next = nodes[vertexNumber].next;
+            bucketQueuePlace(minHeap, vertexNumber);
+            vertexNumber = next;
+        }
+    }
+
+    // The ring holds values from lowest to lowest + numberOfBuckets - 1,
+    // so the first bucket found in use holds the smallest
+    while(minHeap->buckets[bucketQueueIndex(minHeap, minHeap->lowest)] == -1){
+        minHeap->lowest++;
+    }
+}
+
+
+/*
+ * Function: bucketQueueEnqueue
+ * ----------------------------
+ * Sets up the vertex number's Node, growing the array of
+ * Nodes first if it does not fit, and places it, clearing
+ * an empty queue first as radixHeapEnqueue does.
+ */
+void bucketQueueEnqueue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    // An empty queue can start again from any value
+    if(minHeap->size == 0){
+        bucketListClear(minHeap);
+    }
+    bucketCheckValue(minHeap, value);
+
+    if(vertexNumber >= minHeap->nodeCapacity){
+        minHeapFitNode(minHeap, vertexNumber);
     }
+
+    minHeap->bucketNodes[vertexNumber].value = value;
+    bucketQueuePlace(minHeap, vertexNumber);
+    minHeap->size++;
+}
+
+
+/*
+ * Function: bucketQueueDequeue
+ * ----------------------------
+ * Returns the vertex number of the first Node in the
+ * bucket of the smallest value and takes it off.
+ */
+int bucketQueueDequeue(MinHeap* minHeap){
+
+    bucketQueueAdvance(minHeap);
+
+    int minVertex = minHeap->buckets[bucketQueueIndex(minHeap, minHeap->lowest)];
+    bucketListRemove(minHeap, minVertex);
+    minHeap->size--;
+    return minVertex;
 }
 
 
+/*
+ * Function: bucketQueueDecreaseNodeValue
+ * --------------------------------------
+ * Lowers the value of the vertex number's Node and
+ * places it again.
+ */
+void bucketQueueDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value){
+
+    bucketCheckValue(minHeap, value);
+
+    bucketListRemove(minHeap, vertexNumber);
+    if(minHeap->bucketNodes[vertexNumber].bucket == -1){
+        minHeap->numberOutside--;
+    }
+    minHeap->bucketNodes[vertexNumber].value = value;
+    bucketQueuePlace(minHeap, vertexNumber);
+}
 
 
+/*
+ * Function: bucketQueuePeekValue
+ * ------------------------------
+ * Moves lowest up to the smallest value and returns it.
+ */
+Distance bucketQueuePeekValue(MinHeap* minHeap){
 
+    bucketQueueAdvance(minHeap);
+    return minHeap->lowest;
+}
@@ -13,19 +13,44 @@
 #ifndef MINHEAP_H
 #define MINHEAP_H
 
-#include <graph.h>
+#include <weight.h>
 
 typedef struct Node Node;
 
 typedef struct MinHeap MinHeap;
 
+// How a minHeap is kept, see minheap.c
+typedef enum MinHeapKind{
+    MIN_HEAP_BINARY,
+    MIN_HEAP_DARY,
+    MIN_HEAP_PAIRING,
+    MIN_HEAP_RADIX, // Radix heap and Dial's bucket queue, for values
+    MIN_HEAP_BUCKET // that never go below the last one dequeued
+} MinHeapKind;
+
+typedef struct MinHeapType{
+
+    MinHeapKind kind;
+    int arity; // Children per Node of a d-ary heap
+
+} MinHeapType;
+
+#define MIN_HEAP_DEFAULT_TYPE ((MinHeapType){MIN_HEAP_BINARY, 2})
+
 /*
  * Function: minHeapConstructor
  * ----------------------------
- * Constructs an empty minHeap and returns
- * a pointer to the new minHeap.
+ * Constructs an empty minHeap of the given type and
+ * returns a pointer to the new minHeap. Every type
+ * takes Nodes off in the same order apart from Nodes
+ * with equal values. A radix heap or bucket queue
+ * exits with an error if a value below the last one
+ * dequeued is added, so they can only be used where
+ * that never happens, as in Dijkstra's. A bucket
+ * queue also exits with an error when Distances are
+ * not whole numbers, see weight.h.
  */
-MinHeap* minHeapConstructor();
+MinHeap* minHeapConstructor(MinHeapType type);
 
 
 /*
@@ -36,19 +61,31 @@ MinHeap* minHeapConstructor();
 void minHeapDestructor(MinHeap* minHeap);
 
 
+/*
+ * Function: minHeapGetType
+ * ------------------------
+ * Returns the type of the minHeap. A d-ary heap with
+ * two children per Node is a binary heap.
+ */
+MinHeapType minHeapGetType(MinHeap* minHeap);
+
+
 /*
  * Function: minHeapEnqueue
  * ------------------------
  * Add a new Node to the Heap. Need to send in
- * a associated Vertex pointer.
+ * the associated vertex number and its value.
  */
-void minHeapEnqueue(MinHeap* minHeap, Vertex* vertex);
+void minHeapEnqueue(MinHeap* minHeap, int vertexNumber, Distance value);
 
 
 /*
  * Function: printHeap
  * -------------------
- * Runs through the heap array printing all values.
+ * Runs through the heap array printing all values,
+ * only the top value for a pairing heap and the values
+ * of each bucket in turn for a radix heap or bucket
+ * queue.
  */
 void printHeap(MinHeap* minHeap);
 
@@ -69,22 +106,49 @@ int minHeapGetSize(MinHeap* minHeap);
 int minHeapIsEmpty(MinHeap* minHeap);
 
 
+/*
+ * Function: minHeapPeekValue
+ * --------------------------
+ * Returns the value of the top Node without removing
+ * it. The heap must not be empty.
+ */
+Distance minHeapPeekValue(MinHeap* minHeap);
+
+
 /*
  * Function: minHeapDequeue
  * ------------------------
- * Returns pointer to the Vertex associated with the
+ * Returns the vertex number associated with the
  * top Node of the Heap. Then removes that Node from
  * the heap.
  */
-Vertex* minHeapDequeue(MinHeap* minHeap);
+int minHeapDequeue(MinHeap* minHeap);
 
 
 /*
  * Function: minHeapDecreaseNodeValue
  * ----------------------------------
- * Reduces a specific Nodes value and then sifts up
- * till the Heap is correctly sorted.
+ * Reduces the value of the Node of a vertex number
+ * and then sifts up till the Heap is correctly sorted.
+ */
+void minHeapDecreaseNodeValue(MinHeap* minHeap, int vertexNumber, Distance value);
+
+
+/*
+ * Function: minHeapClear
+ * ----------------------
+ * Removes every Node from the heap, for example when
+ * a search stops before the heap is empty.
+ */
+void minHeapClear(MinHeap* minHeap);
+
+
+/*
+ * Function: minHeapReserve
+ * ------------------------
+ * Makes room for capacity Nodes with vertex numbers
+ * below capacity, so enqueuing them never allocates.
  */
-void minHeapDecreaseNodeValue(MinHeap* minHeap, Vertex* vertex);
+void minHeapReserve(MinHeap* minHeap, int capacity);
 
 #endif
@@ -0,0 +1,213 @@
+/*
+ * nameindex.c
+ * -----------
+ *
+ * This file contains the functions for the NameIndex abstract
+ * data type. A NameIndex is an open addressing hash table that
+ * maps a city name to its vertex number in expected constant
+ * time. Collisions are resolved by linear probing and the table
+ * doubles in size whenever it becomes half full so probe
+ * sequences stay short. Each slot keeps the full hash of its name
+ * so most mismatches are rejected without comparing strings and
+ * the table can be regrown without hashing every name again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <nameindex.h>
+
+#define INITIAL_CAPACITY 64 // Must be a power of two
+
+typedef struct Slot{
+
+    unsigned int hash;
+    int length;
+    int vertexNumber; // -1 marks an empty slot
+    const char* name;
+
+} Slot;
+
+
+typedef struct NameIndex{
+
+    Slot* slots;
+    // capacity is always a power of two so
+    // hash & (capacity - 1) gives the slot index
+    int capacity;
+    int size;
+
+} NameIndex;
+
+
+// Internal function declarations
+Slot* nameIndexAllocateSlots(int capacity);
+void nameIndexGrow(NameIndex* nameIndex);
+
+
+/*
+ * Function: nameIndexAllocateSlots
+ * --------------------------------
+ * Mallocs an array of empty slots.
+ */
+Slot* nameIndexAllocateSlots(int capacity){
+
+    Slot* slots = malloc(capacity*sizeof(Slot));
+
+    int i;
+    for(i = 0; i < capacity; i++){
+        slots[i].vertexNumber = -1;
+    }
+    return slots;
+}
+
+
+/*
+ * Function: nameIndexConstructor
+ * ------------------------------
+ * Constructs an empty NameIndex and returns a pointer to it.
+ */
+NameIndex* nameIndexConstructor(){
+
+    NameIndex* newNameIndex = malloc(sizeof(NameIndex));
+    newNameIndex->capacity = INITIAL_CAPACITY;
+    newNameIndex->size = 0;
+    newNameIndex->slots = nameIndexAllocateSlots(INITIAL_CAPACITY);
+    return newNameIndex;
+}
+
+
+/*
+ * Function: nameIndexDestructor
+ * -----------------------------
+ * Frees the slot array and then the NameIndex.
+ */
+void nameIndexDestructor(NameIndex* nameIndex){
+
+    free(nameIndex->slots);
+    free(nameIndex);
+}
+
+
+/*
+ * Function: nameIndexHash
+ * -----------------------
+ * 32 bit FNV-1a hash of the first length characters of name.
+ */
+unsigned int nameIndexHash(const char* name, int length){
+
+    unsigned int hash = 2166136261u;
+
+    int i;
+    for(i = 0; i < length; i++){
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+/*
+ * Function: nameIndexGrow
+ * -----------------------
+ * Doubles the number of slots and reinserts every stored
+ * name using its saved hash.
+ */
+void nameIndexGrow(NameIndex* nameIndex){
+
+    Slot* oldSlots = nameIndex->slots;
+    int oldCapacity = nameIndex->capacity;
+
+    nameIndex->capacity = 2*oldCapacity;
+    nameIndex->slots = nameIndexAllocateSlots(nameIndex->capacity);
+
+    unsigned int mask = nameIndex->capacity - 1;
+    unsigned int position;
+
+    int i;
+    for(i = 0; i < oldCapacity; i++){
+        if(oldSlots[i].vertexNumber != -1){
+            position = oldSlots[i].hash & mask;
+            // Linear probe to the next empty slot
+            while(nameIndex->slots[position].vertexNumber != -1){
+                position = (position + 1) & mask;
+            }
+            nameIndex->slots[position] = oldSlots[i];
+        }
+    }
+
+    free(oldSlots);
+}
+
+
+/*
+ * Function: nameIndexFind
+ * -----------------------
+ * Probes from the name's home slot until either a slot holding
+ * the same name or an empty slot is found.
+ */
+int nameIndexFind(NameIndex* nameIndex, const char* name, int length){
+
+    unsigned int hash = nameIndexHash(name, length);
+    unsigned int mask = nameIndex->capacity - 1;
+    unsigned int position = hash & mask;
+    Slot* slot;
+
+    while(nameIndex->slots[position].vertexNumber != -1){
+        slot = &nameIndex->slots[position];
+        if(slot->hash == hash && slot->length == length && !memcmp(slot->name, name, length)){
+            return slot->vertexNumber;
+        }
+        position = (position + 1) & mask;
+    }
+    return -1;
+}
+
+
+/*
+ * Function: nameIndexInsert
+ * -------------------------
+ * Grows the table first if it would become more than
+ * half full and then stores the name in the first empty
+ * slot from its home slot.
+ */
+void nameIndexInsert(NameIndex* nameIndex, const char* name, int length, int vertexNumber){
+
+    if(2*(nameIndex->size + 1) > nameIndex->capacity){
+        nameIndexGrow(nameIndex);
+    }
+
+    unsigned int hash = nameIndexHash(name, length);
+    unsigned int mask = nameIndex->capacity - 1;
+    unsigned int position = hash & mask;
+
+    while(nameIndex->slots[position].vertexNumber != -1){
+        position = (position + 1) & mask;
+    }
+
+    nameIndex->slots[position].hash = hash;
+    nameIndex->slots[position].length = length;
+    nameIndex->slots[position].vertexNumber = vertexNumber;
+    nameIndex->slots[position].name = name;
+    nameIndex->size++;
+}
+
+
+/*
+ * Function: nameIndexGetSize
+ * --------------------------
+ * Returns the number of names stored.
+ */
+int nameIndexGetSize(NameIndex* nameIndex){
+    return nameIndex->size;
+}
+
+
+/*
+ * Function: nameIndexGetBytesReserved
+ * -----------------------------------
+ * Returns the size of the slots array.
+ */
+size_t nameIndexGetBytesReserved(NameIndex* nameIndex){
+    return nameIndex->capacity*sizeof(Slot);
+}
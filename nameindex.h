@@ -0,0 +1,76 @@
+/*
+ * nameindex.h
+ * -----------
+ *
+ * The header file for nameindex.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <stddef.h>
+
+typedef struct NameIndex NameIndex;
+
+/*
+ * Function: nameIndexConstructor
+ * ------------------------------
+ * Constructs an empty NameIndex and returns a pointer to it.
+ */
+NameIndex* nameIndexConstructor();
+
+
+/*
+ * Function: nameIndexDestructor
+ * -----------------------------
+ * Frees the memory used by the NameIndex. The name strings
+ * themselves are owned by the caller and are not freed.
+ */
+void nameIndexDestructor(NameIndex* nameIndex);
+
+
+/*
+ * Function: nameIndexHash
+ * -----------------------
+ * Returns the hash of the first length characters of name.
+ */
+unsigned int nameIndexHash(const char* name, int length);
+
+
+/*
+ * Function: nameIndexFind
+ * -----------------------
+ * Returns the vertex number stored against the first length
+ * characters of name, or -1 if the name is not known.
+ */
+int nameIndexFind(NameIndex* nameIndex, const char* name, int length);
+
+
+/*
+ * Function: nameIndexInsert
+ * -------------------------
+ * Stores vertexNumber against a name that is not already in
+ * the index. Only the pointer to the name is kept so the string
+ * must stay in place for as long as the NameIndex is used.
+ */
+void nameIndexInsert(NameIndex* nameIndex, const char* name, int length, int vertexNumber);
+
+
+/*
+ * Function: nameIndexGetSize
+ * --------------------------
+ * Returns the number of names stored.
+ */
+int nameIndexGetSize(NameIndex* nameIndex);
+
+
+/*
+ * Function: nameIndexGetBytesReserved
+ * -----------------------------------
+ * Returns the number of bytes malloced for the slots.
+ * The names themselves are not counted.
+ */
+size_t nameIndexGetBytesReserved(NameIndex* nameIndex);
+
+#endif
@@ -0,0 +1,556 @@
+/*
+ * parallelloader.c
+ * ----------------
+ *
+ * This file contains the functions for loading a ukcities file
+ * into a CsrGraph on several threads. The text is split into one
+ * chunk per thread, each starting at the beginning of a line, and
+ * the graph is built in four passes:
+ *
+ *   1. Parse. Each thread reads its chunk with a LineReader and
+ *      keeps every road in its own array. City names are numbered
+ *      in a private NameIndex in the order the thread first sees
+ *      them, so no thread waits on another.
+ *   2. Merge names. The private names are added to one NameIndex
+ *      chunk by chunk, each chunk's names in the order that chunk
+ *      first saw them. That is exactly the order a single pass over
+ *      the whole file would first see them, so vertex numbers are
+ *      the same as graphPopulateGraph() gives for any number of
+ *      threads. Each thread then renumbers its roads.
+ *   3. Count. Each thread counts how many edges it adds to every
+ *      vertex. A prefix sum over vertices, and over threads within
+ *      each vertex, gives the offsets array and the place each
+ *      thread's first edge of every vertex goes. The vertices are
+ *      split into one block per thread, each thread totals its
+ *      block, and only the totals are summed serially before every
+ *      thread sums its own block.
+ *   4. Scatter. Each thread writes its edges into the targets and
+ *      distances arrays in the order of its roads, so every vertex's
+ *      edges end up in file order just as addEdge() would add them.
+ *
+ * Only the name merge is serial and it does one hash lookup per
+ * distinct name per chunk rather than two per road. Each thread's
+ * counts take one int per vertex.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <parallelloader.h>
+#include <linereader.h>
+#include <nameindex.h>
+#include <threadrunner.h>
+
+#define INITIAL_ROAD_CAPACITY 1024
+
+enum LoadError{
+    LOAD_OK,
+    LOAD_BAD_LINE,
+    LOAD_BAD_DISTANCE,
+    LOAD_NOT_POSITIVE
+};
+
+typedef struct Road{
+
+    // Private vertex numbers after the parse pass,
+    // shared vertex numbers after the merge pass.
+    int start;
+    int end;
+    Weight distance;
+
+} Road;
+
+
+typedef struct LoadThread{
+
+    // Chunk of the file read by this thread
+    const char* data;
+    size_t size;
+
+    Road* roads;
+    int numberOfRoads;
+    int roadCapacity;
+
+    // Names in the order this thread first saw them
+    NameIndex* names;
+    const char** nameStarts;
+    int* nameLengths;
+    int numberOfNames;
+    int nameCapacity;
+    int* sharedNumbers; // Private vertex number to shared vertex number
+
+    // Number of edges this thread adds to each vertex, then
+    // turned into the position of its next edge of each vertex
+    int* counts;
+
+    long numberOfLines;
+    enum LoadError error;
+    long errorLine; // Line number within the chunk
+    const char* errorStart;
+    int errorStartLength;
+    const char* errorEnd;
+    int errorEndLength;
+
+} LoadThread;
+
+
+typedef struct LoadContext{
+
+    LoadThread* threads;
+    int numberOfThreads;
+    int numberOfCities;
+
+    int* offsets;
+    int* targets;
+    Weight* distances;
+
+    // Edges of each thread's block of vertex numbers,
+    // then the number of edges before the block
+    int* blockTotals;
+
+} LoadContext;
+
+
+typedef struct LoadTask{
+
+    LoadContext* context;
+    int threadNumber;
+
+} LoadTask;
+
+
+// Internal function declarations
+void runOnThreads(LoadContext* context, void* (*function)(void*));
+void* parsePass(void* argument);
+void* renumberPass(void* argument);
+void* countPass(void* argument);
+void* blockTotalPass(void* argument);
+void* sumPass(void* argument);
+void* scatterPass(void* argument);
+int internName(LoadThread* thread, const char* name, int length);
+void reportError(LoadThread* thread, long lineNumber);
+
+
+/*
+ * Function: runOnThreads
+ * ----------------------
+ * Runs a pass on every thread and waits for them all.
+ * Exits with an error if a thread can not be started.
+ */
+void runOnThreads(LoadContext* context, void* (*function)(void*)){
+
+    LoadTask* tasks = malloc(context->numberOfThreads*sizeof(LoadTask));
+
+    int i;
+    for(i = 0; i < context->numberOfThreads; i++){
+        tasks[i].context = context;
+        tasks[i].threadNumber = i;
+    }
+    threadRunnerRun(context->numberOfThreads, function, tasks, sizeof(LoadTask));
+
+    free(tasks);
+}
+
+
+/*
+ * Function: internName
+ * --------------------
+ * Returns the private vertex number of a name, numbering
+ * it next if this thread has not seen it before.
+ */
+int internName(LoadThread* thread, const char* name, int length){
+
+    int vertexNumber = nameIndexFind(thread->names, name, length);
+
+    if(vertexNumber == -1){
+        if(thread->numberOfNames == thread->nameCapacity){
+            thread->nameCapacity *= 2;
+            thread->nameStarts = realloc(thread->nameStarts, thread->nameCapacity*sizeof(const char*));
+            thread->nameLengths = realloc(thread->nameLengths, thread->nameCapacity*sizeof(int));
+        }
+        vertexNumber = thread->numberOfNames;
+        thread->nameStarts[vertexNumber] = name;
+        thread->nameLengths[vertexNumber] = length;
+        thread->numberOfNames++;
+        nameIndexInsert(thread->names, name, length, vertexNumber);
+    }
+    return vertexNumber;
+}
+
+
+/*
+ * Function: parsePass
+ * -------------------
+ * Reads every line of one chunk into Roads, stopping
+ * at the first line that can not be read.
+ */
+void* parsePass(void* argument){
+
+    LoadTask* task = argument;
+    LoadThread* thread = &task->context->threads[task->threadNumber];
+    LineReader* lineReader = lineReaderConstructorFromMemory(thread->data, thread->size);
+
+    const char* start;
+    const char* end;
+    const char* distanceField;
+    int startLength;
+    int endLength;
+    int distanceLength;
+    Weight distance;
+
+    while(lineReaderNextLine(lineReader)){
+
+        if(lineReaderGetNumberOfFields(lineReader) != 3){
+            thread->error = LOAD_BAD_LINE;
+            break;
+        }
+
+        start = lineReaderGetField(lineReader, 0, &startLength);
+        end = lineReaderGetField(lineReader, 1, &endLength);
+        distanceField = lineReaderGetField(lineReader, 2, &distanceLength);
+
+        if(startLength == 0 || endLength == 0 || lineReaderParseWeight(distanceField, distanceLength, &distance)){
+            thread->error = LOAD_BAD_DISTANCE;
+            break;
+        }
+        if(distance <= 0){
+            thread->error = LOAD_NOT_POSITIVE;
+            thread->errorStart = start;
+            thread->errorStartLength = startLength;
+            thread->errorEnd = end;
+            thread->errorEndLength = endLength;
+            break;
+        }
+
+        if(thread->numberOfRoads == thread->roadCapacity){
+            thread->roadCapacity *= 2;
+            thread->roads = realloc(thread->roads, thread->roadCapacity*sizeof(Road));
+        }
+
+        // Start is numbered before end as in checkStringsKnown()
+        thread->roads[thread->numberOfRoads].start = internName(thread, start, startLength);
+        thread->roads[thread->numberOfRoads].end = internName(thread, end, endLength);
+        thread->roads[thread->numberOfRoads].distance = distance;
+        thread->numberOfRoads++;
+    }
+
+    thread->errorLine = lineReaderGetLineNumber(lineReader);
+    thread->numberOfLines = lineReaderGetLineNumber(lineReader);
+
+    lineReaderDestructor(lineReader);
+    return NULL;
+}
+
+
+/*
+ * Function: renumberPass
+ * ----------------------
+ * Replaces the private vertex numbers of one thread's
+ * Roads with the shared ones.
+ */
+void* renumberPass(void* argument){
+
+    LoadTask* task = argument;
+    LoadThread* thread = &task->context->threads[task->threadNumber];
+
+    int i;
+    for(i = 0; i < thread->numberOfRoads; i++){
+        thread->roads[i].start = thread->sharedNumbers[thread->roads[i].start];
+        thread->roads[i].end = thread->sharedNumbers[thread->roads[i].end];
+    }
+    return NULL;
+}
+
+
+/*
+ * Function: countPass
+ * -------------------
+ * Counts the edges one thread adds to each vertex,
+ * one each way for every Road.
+ */
+void* countPass(void* argument){
+
+    LoadTask* task = argument;
+    LoadThread* thread = &task->context->threads[task->threadNumber];
+
+    thread->counts = calloc(task->context->numberOfCities, sizeof(int));
+
+    int i;
+    for(i = 0; i < thread->numberOfRoads; i++){
+        thread->counts[thread->roads[i].start]++;
+        thread->counts[thread->roads[i].end]++;
+    }
+    return NULL;
+}
+
+
+/*
+ * Function: blockTotalPass
+ * ------------------------
+ * Adds up every thread's counts over one block of vertex
+ * numbers into blockTotals.
+ */
+void* blockTotalPass(void* argument){
+
+    LoadTask* task = argument;
+    LoadContext* context = task->context;
+
+    int blockSize = (context->numberOfCities + context->numberOfThreads - 1)/context->numberOfThreads;
+    int first = task->threadNumber*blockSize;
+    int last = first + blockSize < context->numberOfCities ? first + blockSize : context->numberOfCities;
+    int blockEdges = 0;
+
+    int i;
+    int j;
+    for(j = 0; j < context->numberOfThreads; j++){
+        for(i = first; i < last; i++){
+            blockEdges += context->threads[j].counts[i];
+        }
+    }
+    context->blockTotals[task->threadNumber] = blockEdges;
+    return NULL;
+}
+
+
+/*
+ * Function: sumPass
+ * -----------------
+ * For one block of vertex numbers turns every thread's
+ * counts into the position of its first edge of each
+ * vertex and fills in the offsets. blockTotals must hold
+ * the number of edges before the block.
+ */
+void* sumPass(void* argument){
+
+    LoadTask* task = argument;
+    LoadContext* context = task->context;
+
+    int blockSize = (context->numberOfCities + context->numberOfThreads - 1)/context->numberOfThreads;
+    int first = task->threadNumber*blockSize;
+    int last = first + blockSize < context->numberOfCities ? first + blockSize : context->numberOfCities;
+    int position = context->blockTotals[task->threadNumber];
+    int count;
+
+    int i;
+    int j;
+    for(i = first; i < last; i++){
+        context->offsets[i] = position;
+        for(j = 0; j < context->numberOfThreads; j++){
+            count = context->threads[j].counts[i];
+            context->threads[j].counts[i] = position;
+            position += count;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+ * Function: scatterPass
+ * ---------------------
+ * Writes both edges of each of one thread's Roads into
+ * the next free place of their start vertex.
+ */
+void* scatterPass(void* argument){
+
+    LoadTask* task = argument;
+    LoadContext* context = task->context;
+    LoadThread* thread = &context->threads[task->threadNumber];
+    Road* road;
+    int position;
+
+    int i;
+    for(i = 0; i < thread->numberOfRoads; i++){
+        road = &thread->roads[i];
+
+        position = thread->counts[road->start]++;
+        context->targets[position] = road->end;
+        context->distances[position] = road->distance;
+
+        position = thread->counts[road->end]++;
+        context->targets[position] = road->start;
+        context->distances[position] = road->distance;
+    }
+    return NULL;
+}
+
+
+/*
+ * Function: reportError
+ * ---------------------
+ * Prints the same error as graphPopulateGraph() for the
+ * first bad line of a chunk and exits.
+ */
+void reportError(LoadThread* thread, long lineNumber){
+
+    if(thread->error == LOAD_NOT_POSITIVE){
+        printf("#################################################\n");
+        printf("Distance is equal too or less than zero\n");
+        printf("Please check distance between %.*s and %.*s on line: %ld\n",
+               thread->errorStartLength, thread->errorStart, thread->errorEndLength, thread->errorEnd, lineNumber);
+        printf("#################################################\n\n");
+        exit(-1);
+    }
+
+    printf("\n######################################\n");
+    printf("There was an error reading 'ukcities.txt' on line: %ld\n\n", lineNumber);
+    if(thread->error == LOAD_BAD_LINE){
+        printf("Please check each line of the file contains two,\n");
+        printf("tab-delimited, strings followed by an integer\n");
+    } else {
+        printf("Please check the city names are not empty and\n");
+        printf("the distance is %s\n", WEIGHT_DESCRIPTION);
+    }
+    printf("and try again.\n");
+    printf("######################################\n\n");
+    exit(-1);
+}
+
+
+/*
+ * Function: parallelLoaderLoad
+ * ----------------------------
+ * Splits the text into chunks and runs the passes
+ * described at the top of this file.
+ */
+CsrGraph* parallelLoaderLoad(const char* data, size_t size, int numberOfThreads){
+
+    if(numberOfThreads < 1){
+        numberOfThreads = 1;
+    }
+
+    LoadContext context;
+    context.numberOfThreads = numberOfThreads;
+    context.threads = calloc(numberOfThreads, sizeof(LoadThread));
+
+    int i;
+    int j;
+    LoadThread* thread;
+
+    // Chunks of roughly equal size, each moved on to start after a newline
+    size_t chunkStart = 0;
+    size_t chunkEnd;
+    const char* newline;
+
+    for(i = 0; i < numberOfThreads; i++){
+        thread = &context.threads[i];
+
+        chunkEnd = i == numberOfThreads - 1 ? size : (size/numberOfThreads)*(i + 1);
+        if(chunkEnd < chunkStart){
+            chunkEnd = chunkStart;
+        }
+        if(chunkEnd < size && chunkEnd > 0 && data[chunkEnd - 1] != '\n'){
+            newline = memchr(data + chunkEnd, '\n', size - chunkEnd);
+            chunkEnd = newline == NULL ? size : (size_t)(newline - data) + 1;
+        }
+
+        thread->data = data + chunkStart;
+        thread->size = chunkEnd - chunkStart;
+        thread->roadCapacity = INITIAL_ROAD_CAPACITY;
+        thread->roads = malloc(INITIAL_ROAD_CAPACITY*sizeof(Road));
+        thread->names = nameIndexConstructor();
+        thread->nameCapacity = INITIAL_ROAD_CAPACITY;
+        thread->nameStarts = malloc(INITIAL_ROAD_CAPACITY*sizeof(const char*));
+        thread->nameLengths = malloc(INITIAL_ROAD_CAPACITY*sizeof(int));
+        thread->error = LOAD_OK;
+
+        chunkStart = chunkEnd;
+    }
+
+    runOnThreads(&context, parsePass);
+
+    // The first error in file order is in the first chunk with
+    // one, and every chunk before it was read to its end
+    long linesBefore = 0;
+    for(i = 0; i < numberOfThreads; i++){
+        if(context.threads[i].error != LOAD_OK){
+            reportError(&context.threads[i], linesBefore + context.threads[i].errorLine);
+        }
+        linesBefore += context.threads[i].numberOfLines;
+    }
+
+    // Merge names chunk by chunk in first seen order
+    NameIndex* names = nameIndexConstructor();
+    int numberOfCities = 0;
+    int nameCapacity = INITIAL_ROAD_CAPACITY;
+    const char** nameStarts = malloc(nameCapacity*sizeof(const char*));
+    int* nameLengths = malloc(nameCapacity*sizeof(int));
+    int vertexNumber;
+
+    for(i = 0; i < numberOfThreads; i++){
+        thread = &context.threads[i];
+        thread->sharedNumbers = malloc((thread->numberOfNames > 0 ? thread->numberOfNames : 1)*sizeof(int));
+
+        for(j = 0; j < thread->numberOfNames; j++){
+            vertexNumber = nameIndexFind(names, thread->nameStarts[j], thread->nameLengths[j]);
+            if(vertexNumber == -1){
+                if(numberOfCities == nameCapacity){
+                    nameCapacity *= 2;
+                    nameStarts = realloc(nameStarts, nameCapacity*sizeof(const char*));
+                    nameLengths = realloc(nameLengths, nameCapacity*sizeof(int));
+                }
+                vertexNumber = numberOfCities;
+                nameStarts[vertexNumber] = thread->nameStarts[j];
+                nameLengths[vertexNumber] = thread->nameLengths[j];
+                numberOfCities++;
+                nameIndexInsert(names, thread->nameStarts[j], thread->nameLengths[j], vertexNumber);
+            }
+            thread->sharedNumbers[j] = vertexNumber;
+        }
+    }
+    nameIndexDestructor(names);
+
+    context.numberOfCities = numberOfCities;
+    runOnThreads(&context, renumberPass);
+    runOnThreads(&context, countPass);
+
+    // Edges of each block of vertices, then the edges before each block
+    context.blockTotals = malloc(numberOfThreads*sizeof(int));
+    runOnThreads(&context, blockTotalPass);
+
+    int numberOfEdges = 0;
+    int blockEdges;
+
+    for(i = 0; i < numberOfThreads; i++){
+        blockEdges = context.blockTotals[i];
+        context.blockTotals[i] = numberOfEdges;
+        numberOfEdges += blockEdges;
+    }
+
+    context.offsets = malloc((numberOfCities + 1)*sizeof(int));
+    context.offsets[numberOfCities] = numberOfEdges;
+    context.targets = malloc((numberOfEdges > 0 ? numberOfEdges : 1)*sizeof(int));
+    context.distances = malloc((numberOfEdges > 0 ? numberOfEdges : 1)*sizeof(Weight));
+
+    runOnThreads(&context, sumPass);
+    runOnThreads(&context, scatterPass);
+
+    // Names are copied out of the text into the pool
+    int* nameOffsets = malloc((numberOfCities + 1)*sizeof(int));
+    nameOffsets[0] = 0;
+    for(i = 0; i < numberOfCities; i++){
+        nameOffsets[i + 1] = nameOffsets[i] + nameLengths[i] + 1;
+    }
+    char* namePool = malloc(nameOffsets[numberOfCities] > 0 ? nameOffsets[numberOfCities] : 1);
+    for(i = 0; i < numberOfCities; i++){
+        memcpy(namePool + nameOffsets[i], nameStarts[i], nameLengths[i]);
+        namePool[nameOffsets[i] + nameLengths[i]] = '\0';
+    }
+
+    for(i = 0; i < numberOfThreads; i++){
+        thread = &context.threads[i];
+        free(thread->roads);
+        nameIndexDestructor(thread->names);
+        free(thread->nameStarts);
+        free(thread->nameLengths);
+        free(thread->sharedNumbers);
+        free(thread->counts);
+    }
+    free(context.threads);
+    free(context.blockTotals);
+    free(nameStarts);
+    free(nameLengths);
+
+    return csrGraphConstructorFromOwnedArrays(numberOfCities, numberOfEdges, context.offsets,
+                                              context.targets, context.distances, nameOffsets, namePool);
+}
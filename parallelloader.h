@@ -0,0 +1,27 @@
+/*
+ * parallelloader.h
+ * ----------------
+ *
+ * The header file for parallelloader.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef PARALLELLOADER_H
+#define PARALLELLOADER_H
+
+#include <stddef.h>
+#include <csrgraph.h>
+
+/*
+ * Function: parallelLoaderLoad
+ * ----------------------------
+ * Builds a CsrGraph from the text of a ukcities file held
+ * in memory using numberOfThreads worker threads. The result
+ * is identical to reading the file with graphPopulateGraph()
+ * and csrGraphConstructor(), whatever the number of threads.
+ * Exits with an error giving the line number of the first
+ * line that can not be read.
+ */
+CsrGraph* parallelLoaderLoad(const char* data, size_t size, int numberOfThreads);
+
+#endif
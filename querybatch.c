@@ -0,0 +1,387 @@
+/*
+ * querybatch.c
+ * ------------
+ *
+ * This file contains the functions for the QueryBatch abstract
+ * data type. A QueryBatch is a list of routes to find, each given
+ * by the vertex numbers of its source and destination, so every
+ * city name is looked up before any route is calculated.
+ *
+ * The routes are found by a fixed pool of worker threads. Each
+ * worker has its own DijkstraWorkspace and they all read the same
+ * CsrGraph, which is never written to, so they need no locking
+ * while Dijkstra's algorithm runs. The batch is handed out a block
+ * of QUERY_BLOCK_SIZE routes at a time. The routes of a block are
+ * sorted by source into groups, and workers take the next group
+ * under a mutex. One run of Dijkstra's from the group's source
+ * answers every route of the group, so a depot with hundreds of
+ * destinations costs one search rather than hundreds. If a TreeCache
+ * is given the tree of the source is looked for there first and
+ * every tree found is added to it, so a source repeated in a later
+ * block or batch is not searched again. Workers store the distance
+ * and list of cities of each route in the block's results, then once
+ * every route of the block is done the main thread writes them to
+ * the file in the order they were added. Only one block of results
+ * is held at once however many routes there are.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <querybatch.h>
+#include <dijkstras.h>
+#include <dijkstraworkspace.h>
+#include <treecache.h>
+#include <threadrunner.h>
+
+#define INITIAL_PAIR_CAPACITY 64
+#define QUERY_BLOCK_SIZE 4096 // Routes found before results are written
+
+typedef struct QueryBatch{
+
+    int numberOfPairs;
+    int pairCapacity;
+    int* sources;
+    int* destinations;
+
+    long numberOfSearches; // Runs of Dijkstra's by queryBatchRun()
+
+} QueryBatch;
+
+
+typedef struct SourcePair{
+
+    int source;
+    int pair;
+
+} SourcePair;
+
+
+typedef struct RouteResult{
+
+    Distance distance;
+    int numberOfCities;
+    int* cities; // Destination first, as from dijkstrasTraceRoute()
+
+} RouteResult;
+
+
+typedef struct QueryPool{
+
+    QueryBatch* batch;
+    CsrGraph* csrGraph;
+    TreeCache* cache;
+    MinHeapType heapType;
+
+    // Results of the current block, indexed from blockStart
+    RouteResult* results;
+    int blockStart;
+    int blockEnd;
+
+    // Pairs of the current block sorted by source, group i
+    // is order[groupStarts[i]] to order[groupStarts[i + 1] - 1]
+    SourcePair* order;
+    int* groupStarts;
+    int numberOfGroups;
+    int nextGroup;
+    int groupsDone;
+    int finished;
+
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t blockDone;
+
+} QueryPool;
+
+
+// Internal function declarations
+void* queryWorker(void* argument);
+int compareSourcePairs(const void* a, const void* b);
+void groupBlock(QueryPool* pool);
+
+
+/*
+ * Function: queryBatchConstructor
+ * -------------------------------
+ * Creates an empty QueryBatch.
+ */
+QueryBatch* queryBatchConstructor(){
+
+    QueryBatch* newBatch = malloc(sizeof(QueryBatch));
+
+    newBatch->numberOfPairs = 0;
+    newBatch->pairCapacity = INITIAL_PAIR_CAPACITY;
+    newBatch->sources = malloc(INITIAL_PAIR_CAPACITY*sizeof(int));
+    newBatch->destinations = malloc(INITIAL_PAIR_CAPACITY*sizeof(int));
+    newBatch->numberOfSearches = 0;
+
+    return newBatch;
+}
+
+
+/*
+ * Function: queryBatchDestructor
+ * ------------------------------
+ * Frees the arrays of pairs and the QueryBatch.
+ */
+void queryBatchDestructor(QueryBatch* batch){
+
+    free(batch->sources);
+    free(batch->destinations);
+    free(batch);
+}
+
+
+/*
+ * Function: queryBatchAddPair
+ * ---------------------------
+ * Appends a pair, doubling the arrays when full.
+ */
+void queryBatchAddPair(QueryBatch* batch, int sourceVertexNumber, int destinationVertexNumber){
+
+    if(batch->numberOfPairs == batch->pairCapacity){
+        batch->pairCapacity *= 2;
+        batch->sources = realloc(batch->sources, batch->pairCapacity*sizeof(int));
+        batch->destinations = realloc(batch->destinations, batch->pairCapacity*sizeof(int));
+    }
+
+    batch->sources[batch->numberOfPairs] = sourceVertexNumber;
+    batch->destinations[batch->numberOfPairs] = destinationVertexNumber;
+    batch->numberOfPairs++;
+}
+
+
+/*
+ * Function: queryBatchGetNumberOfPairs
+ * ------------------------------------
+ * Returns the number of pairs.
+ */
+int queryBatchGetNumberOfPairs(QueryBatch* batch){
+    return batch->numberOfPairs;
+}
+
+
+/*
+ * Function: queryBatchGetNumberOfSearches
+ * ---------------------------------------
+ * Returns the number of searches run.
+ */
+long queryBatchGetNumberOfSearches(QueryBatch* batch){
+    return batch->numberOfSearches;
+}
+
+
+/*
+ * Function: compareSourcePairs
+ * ----------------------------
+ * Orders SourcePairs by source and then by pair so
+ * the sort gives the same groups every time.
+ */
+int compareSourcePairs(const void* a, const void* b){
+
+    const SourcePair* pairA = a;
+    const SourcePair* pairB = b;
+
+    if(pairA->source != pairB->source){
+        return pairA->source < pairB->source ? -1 : 1;
+    }
+    return pairA->pair < pairB->pair ? -1 : pairA->pair > pairB->pair;
+}
+
+
+/*
+ * Function: groupBlock
+ * --------------------
+ * Sorts the pairs of the current block by source and
+ * records where each source's group starts.
+ */
+void groupBlock(QueryPool* pool){
+
+    int size = pool->blockEnd - pool->blockStart;
+
+    int i;
+    for(i = 0; i < size; i++){
+        pool->order[i].source = pool->batch->sources[pool->blockStart + i];
+        pool->order[i].pair = pool->blockStart + i;
+    }
+    qsort(pool->order, size, sizeof(SourcePair), compareSourcePairs);
+
+    pool->numberOfGroups = 0;
+    for(i = 0; i < size; i++){
+        if(i == 0 || pool->order[i].source != pool->order[i - 1].source){
+            pool->groupStarts[pool->numberOfGroups] = i;
+            pool->numberOfGroups++;
+        }
+    }
+    pool->groupStarts[pool->numberOfGroups] = size;
+}
+
+
+/*
+ * Function: queryWorker
+ * ---------------------
+ * Waits for a block of routes, then takes its groups one
+ * at a time until there are none left. Each group's tree
+ * comes from the TreeCache or a run of Dijkstra's and
+ * answers all of its routes. Signals the main thread when
+ * the last group of the block is stored. Returns when the
+ * pool is finished.
+ */
+void* queryWorker(void* argument){
+
+    QueryPool* pool = argument;
+    DijkstraWorkspace* workspace = dijkstraWorkspaceConstructor(csrGraphGetNumberOfCities(pool->csrGraph), pool->heapType);
+    int* route = malloc(csrGraphGetNumberOfCities(pool->csrGraph)*sizeof(int));
+
+    RouteResult* result;
+    const Distance* distanceFromSource;
+    const int* previous;
+    int group;
+    int source;
+    int destination;
+    int slot;
+    int searched;
+    int i;
+
+    pthread_mutex_lock(&pool->lock);
+
+    while(1){
+        while(!pool->finished && pool->nextGroup == pool->numberOfGroups){
+            pthread_cond_wait(&pool->workReady, &pool->lock);
+        }
+        if(pool->finished){
+            break;
+        }
+
+        group = pool->nextGroup;
+        pool->nextGroup++;
+        pthread_mutex_unlock(&pool->lock);
+
+        source = pool->order[pool->groupStarts[group]].source;
+        slot = pool->cache != NULL ? treeCacheAcquire(pool->cache, source) : -1;
+        searched = slot == -1;
+
+        if(slot != -1){
+            distanceFromSource = treeCacheGetDistanceFromSource(pool->cache, slot);
+            previous = treeCacheGetPrevious(pool->cache, slot);
+        } else {
+            dijkstrasCsr(pool->csrGraph, workspace, source);
+            distanceFromSource = dijkstraWorkspaceGetDistanceFromSource(workspace);
+            previous = dijkstraWorkspaceGetPrevious(workspace);
+        }
+
+        // Every route of the group from the same tree
+        for(i = pool->groupStarts[group]; i < pool->groupStarts[group + 1]; i++){
+            destination = pool->batch->destinations[pool->order[i].pair];
+            result = &pool->results[pool->order[i].pair - pool->blockStart];
+
+            result->distance = distanceFromSource[destination];
+            result->numberOfCities = dijkstrasTraceRoute(previous, destination, route);
+            result->cities = malloc(result->numberOfCities*sizeof(int));
+            memcpy(result->cities, route, result->numberOfCities*sizeof(int));
+        }
+
+        if(slot != -1){
+            treeCacheRelease(pool->cache, slot);
+        } else if(pool->cache != NULL){
+            treeCacheInsert(pool->cache, source, distanceFromSource, previous);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        pool->batch->numberOfSearches += searched;
+        pool->groupsDone++;
+        if(pool->groupsDone == pool->numberOfGroups){
+            pthread_cond_signal(&pool->blockDone);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    free(route);
+    dijkstraWorkspaceDestructor(workspace);
+    return NULL;
+}
+
+
+/*
+ * Function: queryBatchRun
+ * -----------------------
+ * Starts the workers, then for each block of the batch
+ * groups it by source, hands it to them, waits for it
+ * to finish and writes its results. Finally stops the
+ * workers.
+ */
+void queryBatchRun(QueryBatch* batch, CsrGraph* csrGraph, FILE* output, int numberOfThreads, TreeCache* cache,
+                   MinHeapType heapType){
+
+    if(numberOfThreads < 1){
+        numberOfThreads = 1;
+    }
+
+    QueryPool pool;
+    pool.batch = batch;
+    pool.csrGraph = csrGraph;
+    pool.cache = cache;
+    pool.heapType = heapType;
+    pool.results = malloc(QUERY_BLOCK_SIZE*sizeof(RouteResult));
+    pool.order = malloc(QUERY_BLOCK_SIZE*sizeof(SourcePair));
+    pool.groupStarts = malloc((QUERY_BLOCK_SIZE + 1)*sizeof(int));
+    pool.blockStart = 0;
+    pool.blockEnd = 0;
+    pool.numberOfGroups = 0;
+    pool.nextGroup = 0;
+    pool.groupsDone = 0;
+    pool.finished = 0;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.workReady, NULL);
+    pthread_cond_init(&pool.blockDone, NULL);
+
+    pthread_t* workers = malloc(numberOfThreads*sizeof(pthread_t));
+    threadRunnerStart(workers, numberOfThreads, queryWorker, &pool, 0);
+
+    int i;
+    int j;
+
+    RouteResult* result;
+
+    for(i = 0; i < batch->numberOfPairs; i += QUERY_BLOCK_SIZE){
+
+        pthread_mutex_lock(&pool.lock);
+        pool.blockStart = i;
+        pool.blockEnd = i + QUERY_BLOCK_SIZE < batch->numberOfPairs ? i + QUERY_BLOCK_SIZE : batch->numberOfPairs;
+        groupBlock(&pool);
+        pool.nextGroup = 0;
+        pool.groupsDone = 0;
+        pthread_cond_broadcast(&pool.workReady);
+
+        while(pool.groupsDone < pool.numberOfGroups){
+            pthread_cond_wait(&pool.blockDone, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+
+        // Workers are waiting so the results are only read here
+        for(j = 0; j < pool.blockEnd - pool.blockStart; j++){
+            result = &pool.results[j];
+            dijkstrasCsrWriteRoute(csrGraph, output, batch->sources[i + j],
+                                   result->cities, result->numberOfCities, result->distance);
+            free(result->cities);
+        }
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.finished = 1;
+    pthread_cond_broadcast(&pool.workReady);
+    pthread_mutex_unlock(&pool.lock);
+
+    for(i = 0; i < numberOfThreads; i++){
+        pthread_join(workers[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.workReady);
+    pthread_cond_destroy(&pool.blockDone);
+    free(workers);
+    free(pool.results);
+    free(pool.order);
+    free(pool.groupStarts);
+}
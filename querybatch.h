@@ -0,0 +1,77 @@
+/*
+ * querybatch.h
+ * ------------
+ *
+ * The header file for querybatch.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef QUERYBATCH_H
+#define QUERYBATCH_H
+
+#include <stdio.h>
+#include <csrgraph.h>
+#include <treecache.h>
+#include <minheap.h>
+
+typedef struct QueryBatch QueryBatch;
+
+/*
+ * Function: queryBatchConstructor
+ * -------------------------------
+ * Constructs an empty QueryBatch and returns a pointer to it.
+ */
+QueryBatch* queryBatchConstructor();
+
+
+/*
+ * Function: queryBatchDestructor
+ * ------------------------------
+ * Frees the QueryBatch.
+ */
+void queryBatchDestructor(QueryBatch* batch);
+
+
+/*
+ * Function: queryBatchAddPair
+ * ---------------------------
+ * Adds a route to find, given by the vertex numbers of
+ * its source and destination, to the end of the batch.
+ */
+void queryBatchAddPair(QueryBatch* batch, int sourceVertexNumber, int destinationVertexNumber);
+
+
+/*
+ * Function: queryBatchGetNumberOfPairs
+ * ------------------------------------
+ * Returns the number of routes in the batch.
+ */
+int queryBatchGetNumberOfPairs(QueryBatch* batch);
+
+
+/*
+ * Function: queryBatchGetNumberOfSearches
+ * ---------------------------------------
+ * Returns how many runs of Dijkstra's algorithm
+ * queryBatchRun() has needed for the batch so far.
+ */
+long queryBatchGetNumberOfSearches(QueryBatch* batch);
+
+
+/*
+ * Function: queryBatchRun
+ * -----------------------
+ * Finds every route of the batch on numberOfThreads worker
+ * threads sharing the CsrGraph, each with its own
+ * DijkstraWorkspace, and writes them to output in the order
+ * they were added in the same format as
+ * dijkstrasCsrWriteToFile(). Routes from the same source
+ * share one run of Dijkstra's algorithm. cache may be NULL,
+ * otherwise trees are read from and added to it and it can
+ * be kept for later batches on the same CsrGraph. The
+ * workers' MinHeaps are of type heapType.
+ */
+void queryBatchRun(QueryBatch* batch, CsrGraph* csrGraph, FILE* output, int numberOfThreads, TreeCache* cache,
+                   MinHeapType heapType);
+
+#endif
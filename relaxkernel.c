@@ -0,0 +1,214 @@
+/*
+ * relaxkernel.c
+ * -------------
+ *
+ * This file contains the kernels Dijkstra's uses to relax the roads
+ * of a vertex with many of them. The roads of a CsrGraph are kept as
+ * separate arrays of targets and distances, so a block of either can
+ * be loaded straight into a vector register. Each kernel adds the
+ * distance of the vertex to a block of road distances, fetches the
+ * distances from the source of the vertices at the other ends, and
+ * compares the two, so only the vertices a shorter or equal route
+ * has been found to are passed back to be updated one at a time.
+ * Most vertices' routes do not improve, so most roads are dealt with
+ * without a branch.
+ *
+ * The AVX2 kernel works on eight roads at a time and fetches the
+ * distances with a gather instruction, the SSE4.1 kernel on four,
+ * fetching them one by one. Roads left over at the end of a block
+ * are done by the scalar kernel, which is also used on processors
+ * with neither. The vector kernels are compiled for their own
+ * instruction sets, whatever the rest of the program is compiled
+ * for, so relaxKernelDetect() picks the one to use when the program
+ * runs. A route too long for a Distance stops at DISTANCE_INFINITY
+ * in every kernel, so every kernel gives the same answer. The vector
+ * kernels are written for int Weights and Distances and are only
+ * compiled in when those are the types chosen, see weight.h.
+ */
+
+#include <relaxkernel.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && WEIGHT_TYPE == 2
+#define RELAX_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+// Internal function declarations
+int relaxKernelScalar(const int* targets, const Weight* distances, int first, int last,
+                      Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes);
+#ifdef RELAX_KERNEL_X86
+int relaxKernelSse4(const int* targets, const Weight* distances, int first, int last,
+                    Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes);
+int relaxKernelAvx2(const int* targets, const Weight* distances, int first, int last,
+                    Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes);
+#endif
+
+
+/*
+ * Function: relaxKernelDetect
+ * ---------------------------
+ * Asks the processor which instruction sets it has.
+ */
+RelaxKernelType relaxKernelDetect(){
+
+#ifdef RELAX_KERNEL_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        return RELAX_KERNEL_AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.1")){
+        return RELAX_KERNEL_SSE4;
+    }
+#endif
+    return RELAX_KERNEL_SCALAR;
+}
+
+
+/*
+ * Function: relaxKernelGetName
+ * ----------------------------
+ * Returns the name of a kernel, for printing.
+ */
+const char* relaxKernelGetName(RelaxKernelType type){
+
+    if(type == RELAX_KERNEL_AVX2){
+        return "AVX2";
+    } else if(type == RELAX_KERNEL_SSE4){
+        return "SSE4.1";
+    }
+    return "scalar";
+}
+
+
+/*
+ * Function: relaxKernelRun
+ * ------------------------
+ * Runs the kernel of the given type, or the scalar one
+ * if the vector kernels were not compiled in.
+ */
+int relaxKernelRun(RelaxKernelType type, const int* targets, const Weight* distances, int first, int last,
+                   Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes){
+
+#ifdef RELAX_KERNEL_X86
+    if(type == RELAX_KERNEL_AVX2){
+        return relaxKernelAvx2(targets, distances, first, last, distanceOfU, distanceFromSource, vertices, routes);
+    } else if(type == RELAX_KERNEL_SSE4){
+        return relaxKernelSse4(targets, distances, first, last, distanceOfU, distanceFromSource, vertices, routes);
+    }
+#else
+    (void)type; // Only the scalar kernel is compiled in
+#endif
+    return relaxKernelScalar(targets, distances, first, last, distanceOfU, distanceFromSource, vertices, routes);
+}
+
+
+/*
+ * Function: relaxKernelScalar
+ * ---------------------------
+ * One road at a time.
+ */
+int relaxKernelScalar(const int* targets, const Weight* distances, int first, int last,
+                      Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes){
+
+    int numberFound = 0;
+    Distance route;
+
+    int j;
+    for(j = first; j < last; j++){
+        route = DISTANCE_ADD(distanceOfU, distances[j]);
+        if(route <= distanceFromSource[targets[j]]){
+            vertices[numberFound] = targets[j];
+            routes[numberFound] = route;
+            numberFound++;
+        }
+    }
+    return numberFound;
+}
+
+
+#ifdef RELAX_KERNEL_X86
+
+/*
+ * Function: relaxKernelSse4
+ * -------------------------
+ * Four roads at a time. Two ints that are not negative
+ * can not overflow an unsigned add, so an unsigned min
+ * stops the route at DISTANCE_INFINITY. The lanes where
+ * the route is greater than the distance already found
+ * are set in a mask, and the vertices of the rest written
+ * out in order, lowest lane first.
+ */
+__attribute__((target("sse4.1")))
+int relaxKernelSse4(const int* targets, const Weight* distances, int first, int last,
+                    Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes){
+
+    __m128i fromU = _mm_set1_epi32(distanceOfU);
+    __m128i infinity = _mm_set1_epi32(DISTANCE_INFINITY);
+    int numberFound = 0;
+    int found;
+    int lane;
+
+    int j = first;
+    for(; j + 4 <= last; j += 4){
+
+        __m128i route = _mm_min_epu32(_mm_add_epi32(fromU, _mm_loadu_si128((const __m128i*)(distances + j))), infinity);
+        __m128i current = _mm_setzero_si128();
+        current = _mm_insert_epi32(current, distanceFromSource[targets[j]], 0);
+        current = _mm_insert_epi32(current, distanceFromSource[targets[j + 1]], 1);
+        current = _mm_insert_epi32(current, distanceFromSource[targets[j + 2]], 2);
+        current = _mm_insert_epi32(current, distanceFromSource[targets[j + 3]], 3);
+
+        found = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(route, current))) & 0xF;
+        while(found != 0){
+            lane = __builtin_ctz(found);
+            vertices[numberFound] = targets[j + lane];
+            routes[numberFound] = DISTANCE_ADD(distanceOfU, distances[j + lane]);
+            numberFound++;
+            found &= found - 1;
+        }
+    }
+
+    return numberFound + relaxKernelScalar(targets, distances, j, last, distanceOfU, distanceFromSource,
+                                           vertices + numberFound, routes + numberFound);
+}
+
+
+/*
+ * Function: relaxKernelAvx2
+ * -------------------------
+ * Eight roads at a time, the same as relaxKernelSse4()
+ * but fetching the distances with a gather.
+ */
+__attribute__((target("avx2")))
+int relaxKernelAvx2(const int* targets, const Weight* distances, int first, int last,
+                    Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes){
+
+    __m256i fromU = _mm256_set1_epi32(distanceOfU);
+    __m256i infinity = _mm256_set1_epi32(DISTANCE_INFINITY);
+    int numberFound = 0;
+    int found;
+    int lane;
+
+    int j = first;
+    for(; j + 8 <= last; j += 8){
+
+        __m256i route = _mm256_min_epu32(_mm256_add_epi32(fromU, _mm256_loadu_si256((const __m256i*)(distances + j))),
+                                         infinity);
+        __m256i current = _mm256_i32gather_epi32(distanceFromSource,
+                                                 _mm256_loadu_si256((const __m256i*)(targets + j)), 4);
+
+        found = ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(route, current))) & 0xFF;
+        while(found != 0){
+            lane = __builtin_ctz(found);
+            vertices[numberFound] = targets[j + lane];
+            routes[numberFound] = DISTANCE_ADD(distanceOfU, distances[j + lane]);
+            numberFound++;
+            found &= found - 1;
+        }
+    }
+
+    return numberFound + relaxKernelScalar(targets, distances, j, last, distanceOfU, distanceFromSource,
+                                           vertices + numberFound, routes + numberFound);
+}
+
+#endif
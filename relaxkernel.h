@@ -0,0 +1,58 @@
+/*
+ * relaxkernel.h
+ * -------------
+ *
+ * The header file for relaxkernel.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef RELAXKERNEL_H
+#define RELAXKERNEL_H
+
+#include <weight.h>
+
+#define RELAX_KERNEL_BLOCK 64 // Most roads one call of relaxKernelRun() looks at
+
+// Instructions the kernel is written with, see relaxkernel.c
+typedef enum RelaxKernelType{
+    RELAX_KERNEL_SCALAR,
+    RELAX_KERNEL_SSE4,
+    RELAX_KERNEL_AVX2
+} RelaxKernelType;
+
+/*
+ * Function: relaxKernelDetect
+ * ---------------------------
+ * Returns the fastest kernel the processor running the
+ * program supports, RELAX_KERNEL_SCALAR if it supports
+ * neither SSE4.1 nor AVX2, is not an x86 processor or
+ * the program was compiled with Weights other than ints.
+ */
+RelaxKernelType relaxKernelDetect();
+
+
+/*
+ * Function: relaxKernelGetName
+ * ----------------------------
+ * Returns the name of a kernel, for printing.
+ */
+const char* relaxKernelGetName(RelaxKernelType type);
+
+
+/*
+ * Function: relaxKernelRun
+ * ------------------------
+ * Looks at the roads first to last - 1 of the CSR arrays,
+ * no more than RELAX_KERNEL_BLOCK of them, leading from a
+ * vertex distanceOfU from the source. Writes the vertex
+ * at the end of each road whose route through it is no
+ * longer than the vertex's distanceFromSource into
+ * vertices, in road order, and that route into routes.
+ * Returns how many were written. A vertex with two roads
+ * may be written twice, so the caller checks each again
+ * before using it. Every kernel writes the same.
+ */
+int relaxKernelRun(RelaxKernelType type, const int* targets, const Weight* distances, int first, int last,
+                   Distance distanceOfU, const Distance* distanceFromSource, int* vertices, Distance* routes);
+
+#endif
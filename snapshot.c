@@ -0,0 +1,342 @@
+/*
+ * snapshot.c
+ * ----------
+ *
+ * This file contains the functions for writing a CsrGraph to a
+ * binary snapshot file and loading it back. Reading ukcities.txt
+ * means parsing every line and hashing every city name again,
+ * whereas a snapshot holds the finished arrays of a CsrGraph so
+ * loading one is just mapping the file into memory and pointing
+ * a CsrGraph at the arrays inside it. Nothing is parsed or copied
+ * and pages are only read from disk when a query touches them.
+ *
+ * The file starts with a SnapshotHeader followed by each section
+ * of the CsrGraph, every one starting on an 8 byte boundary:
+ *
+ *     offsets      (numberOfCities + 1) ints
+ *     targets      numberOfEdges ints
+ *     distances    numberOfEdges Weights
+ *     nameOffsets  (numberOfCities + 1) ints
+ *     namePool     null-terminated city names
+ *     nameSlots    nameSlotCapacity ints
+ *     originalNumbers  numberOfCities ints, or none
+ *     newNumbers       numberOfCities ints, or none
+ *     compressedBlockStarts  numberOfCities/COMPRESSED_BLOCK_SIZE + 1
+ *                            uint64s, or none
+ *     compressedOffsets      (numberOfCities + 1) uint32s, or none
+ *     compressedStream       the encoded roads, or none
+ *
+ * originalNumbers and newNumbers are the translation table of a
+ * renumbered CsrGraph, see vertexorder.c, and are empty if the
+ * vertices still have the numbers the cities were read as. The last
+ * three are the arrays of a CompressedGraph, see compressedgraph.c,
+ * only written when asked for. A search over them then never reads
+ * the targets and distances, so those pages are never loaded.
+ * The header records where each section starts and how long it is
+ * so the loader can check a file fits together before using it. The
+ * arrays are stored in the byte order and int size of the machine
+ * that wrote them, both recorded in the header, and a snapshot
+ * written on a different kind of machine is rejected rather than
+ * converted. So is one written by a program compiled with another
+ * Weight type, see weight.h. The CsrGraph's fingerprint is kept in
+ * the header too, so files made from the graph can be checked
+ * against a mapped snapshot without reading all its roads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <snapshot.h>
+#include <mappedfile.h>
+
+#define SNAPSHOT_MAGIC "DJKSNAP" // 7 characters and the null-terminator
+#define BYTE_ORDER_MARK 0x01020304u
+#define SECTION_ALIGNMENT 8
+
+enum SnapshotSection{
+    SECTION_OFFSETS,
+    SECTION_TARGETS,
+    SECTION_DISTANCES,
+    SECTION_NAME_OFFSETS,
+    SECTION_NAME_POOL,
+    SECTION_NAME_SLOTS,
+    SECTION_ORIGINAL_NUMBERS,
+    SECTION_NEW_NUMBERS,
+    SECTION_COMPRESSED_BLOCK_STARTS,
+    SECTION_COMPRESSED_OFFSETS,
+    SECTION_COMPRESSED_STREAM,
+    NUMBER_OF_SECTIONS
+};
+
+typedef struct SnapshotHeader{
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark; // Reads back differently on the other byte order
+    uint32_t intSize;
+    uint32_t weightType; // WEIGHT_TYPE of the program that wrote it
+    uint32_t numberOfCities;
+    uint32_t numberOfEdges;
+    uint32_t nameSlotCapacity;
+    uint32_t compressedBlockSize; // COMPRESSED_BLOCK_SIZE, 0 without compressed roads
+    uint64_t fileSize;
+    uint64_t graphFingerprint; // See csrGraphGetFingerprint()
+
+    // Byte position and length of each section from the start of the file
+    uint64_t sectionStart[NUMBER_OF_SECTIONS];
+    uint64_t sectionSize[NUMBER_OF_SECTIONS];
+
+} SnapshotHeader;
+
+
+// Internal function declarations
+uint64_t snapshotAlign(uint64_t position);
+void snapshotError(const char* path, const char* reason);
+
+
+/*
+ * Function: snapshotAlign
+ * -----------------------
+ * Rounds a file position up to the next section boundary.
+ */
+uint64_t snapshotAlign(uint64_t position){
+    return (position + SECTION_ALIGNMENT - 1) & ~(uint64_t)(SECTION_ALIGNMENT - 1);
+}
+
+
+/*
+ * Function: snapshotError
+ * -----------------------
+ * Reports a snapshot that can not be used and exits.
+ */
+void snapshotError(const char* path, const char* reason){
+
+    printf("\n#####################################\n");
+    printf("Error, can not load snapshot '%s'.\n", path);
+    printf("%s\n", reason);
+    printf("#####################################\n\n");
+    exit(-1);
+}
+
+
+/*
+ * Function: snapshotWrite
+ * -----------------------
+ * Fills in the header with the size and position of every
+ * section, then writes the header and sections in order
+ * with zero bytes padding each section to the next boundary.
+ */
+int snapshotWrite(CsrGraph* csrGraph, CompressedGraph* compressedGraph, const char* path){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    int numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+
+    const void* sectionData[NUMBER_OF_SECTIONS];
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(SnapshotHeader));
+
+    strcpy(header.magic, SNAPSHOT_MAGIC);
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.intSize = sizeof(int);
+    header.weightType = WEIGHT_TYPE;
+    header.numberOfCities = numberOfCities;
+    header.numberOfEdges = numberOfEdges;
+    header.nameSlotCapacity = csrGraphGetNameSlotCapacity(csrGraph);
+    header.graphFingerprint = csrGraphGetFingerprint(csrGraph);
+
+    sectionData[SECTION_OFFSETS] = csrGraphGetOffsets(csrGraph);
+    header.sectionSize[SECTION_OFFSETS] = (uint64_t)(numberOfCities + 1)*sizeof(int);
+    sectionData[SECTION_TARGETS] = csrGraphGetTargets(csrGraph);
+    header.sectionSize[SECTION_TARGETS] = (uint64_t)numberOfEdges*sizeof(int);
+    sectionData[SECTION_DISTANCES] = csrGraphGetDistances(csrGraph);
+    header.sectionSize[SECTION_DISTANCES] = (uint64_t)numberOfEdges*sizeof(Weight);
+    sectionData[SECTION_NAME_OFFSETS] = csrGraphGetNameOffsets(csrGraph);
+    header.sectionSize[SECTION_NAME_OFFSETS] = (uint64_t)(numberOfCities + 1)*sizeof(int);
+    sectionData[SECTION_NAME_POOL] = csrGraphGetNamePool(csrGraph);
+    header.sectionSize[SECTION_NAME_POOL] = csrGraphGetNameOffsets(csrGraph)[numberOfCities];
+    sectionData[SECTION_NAME_SLOTS] = csrGraphGetNameSlots(csrGraph);
+    header.sectionSize[SECTION_NAME_SLOTS] = (uint64_t)header.nameSlotCapacity*sizeof(int);
+    sectionData[SECTION_ORIGINAL_NUMBERS] = csrGraphGetOriginalNumbers(csrGraph);
+    sectionData[SECTION_NEW_NUMBERS] = csrGraphGetNewNumbers(csrGraph);
+    if(sectionData[SECTION_ORIGINAL_NUMBERS] != NULL){
+        header.sectionSize[SECTION_ORIGINAL_NUMBERS] = (uint64_t)numberOfCities*sizeof(int);
+        header.sectionSize[SECTION_NEW_NUMBERS] = (uint64_t)numberOfCities*sizeof(int);
+    }
+    sectionData[SECTION_COMPRESSED_BLOCK_STARTS] = NULL;
+    sectionData[SECTION_COMPRESSED_OFFSETS] = NULL;
+    sectionData[SECTION_COMPRESSED_STREAM] = NULL;
+    if(compressedGraph != NULL){
+        header.compressedBlockSize = COMPRESSED_BLOCK_SIZE;
+        sectionData[SECTION_COMPRESSED_BLOCK_STARTS] = compressedGraphGetBlockStarts(compressedGraph);
+        header.sectionSize[SECTION_COMPRESSED_BLOCK_STARTS] = (uint64_t)(numberOfCities/COMPRESSED_BLOCK_SIZE + 1)
+                                                              *sizeof(uint64_t);
+        sectionData[SECTION_COMPRESSED_OFFSETS] = compressedGraphGetOffsets(compressedGraph);
+        header.sectionSize[SECTION_COMPRESSED_OFFSETS] = (uint64_t)(numberOfCities + 1)*sizeof(uint32_t);
+        sectionData[SECTION_COMPRESSED_STREAM] = compressedGraphGetStream(compressedGraph);
+        header.sectionSize[SECTION_COMPRESSED_STREAM] = compressedGraphGetStreamSize(compressedGraph);
+    }
+
+    int i;
+    uint64_t position = snapshotAlign(sizeof(SnapshotHeader));
+    for(i = 0; i < NUMBER_OF_SECTIONS; i++){
+        header.sectionStart[i] = position;
+        position = snapshotAlign(position + header.sectionSize[i]);
+    }
+    header.fileSize = position;
+
+    FILE* snapshot = fopen(path, "wb");
+    if(snapshot == NULL){
+        return -1;
+    }
+
+    static const char padding[SECTION_ALIGNMENT] = {0};
+    int failed = 0;
+
+    failed |= fwrite(&header, sizeof(SnapshotHeader), 1, snapshot) != 1;
+    position = sizeof(SnapshotHeader);
+
+    for(i = 0; i < NUMBER_OF_SECTIONS; i++){
+        failed |= fwrite(padding, 1, header.sectionStart[i] - position, snapshot) != header.sectionStart[i] - position;
+        // Empty sections, such as the translation table of a
+        // graph never renumbered, have no data to write
+        if(header.sectionSize[i] != 0){
+            failed |= fwrite(sectionData[i], 1, header.sectionSize[i], snapshot) != header.sectionSize[i];
+        }
+        position = header.sectionStart[i] + header.sectionSize[i];
+    }
+    failed |= fwrite(padding, 1, header.fileSize - position, snapshot) != header.fileSize - position;
+
+    failed |= fclose(snapshot) != 0;
+    return failed ? -1 : 0;
+}
+
+
+/*
+ * Function: snapshotLoad
+ * ----------------------
+ * Maps the file and checks the header: the magic string,
+ * version, byte order, int size and Weight type must
+ * match this program and every section must lie inside
+ * the file with the size its counts imply. A few cheap
+ * checks are made on the arrays themselves but the
+ * targets are not checked one by one as that would read
+ * the whole file, nor is the compressed stream decoded.
+ */
+CsrGraph* snapshotLoad(const char* path, CompressedGraph** compressedGraph){
+
+    MappedFile* mappedFile = mappedFileOpen(path);
+    if(mappedFile == NULL){
+        snapshotError(path, "The file could not be opened.");
+    }
+
+    const char* data = mappedFileGetData(mappedFile);
+    size_t size = mappedFileGetSize(mappedFile);
+
+    if(size < sizeof(SnapshotHeader)){
+        snapshotError(path, "The file is too short to be a snapshot.");
+    }
+
+    const SnapshotHeader* header = (const SnapshotHeader*)data;
+
+    if(memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC))){
+        snapshotError(path, "The file is not a snapshot.");
+    }
+    if(header->version != SNAPSHOT_VERSION){
+        snapshotError(path, "The snapshot was written by a different version, please compile it again.");
+    }
+    if(header->byteOrderMark != BYTE_ORDER_MARK || header->intSize != sizeof(int)){
+        snapshotError(path, "The snapshot was written on a different kind of machine.");
+    }
+    if(header->weightType != WEIGHT_TYPE){
+        snapshotError(path, "The snapshot was written by a program compiled with different distance types.");
+    }
+    if(header->fileSize != size){
+        snapshotError(path, "The file is not the size recorded in its header.");
+    }
+
+    uint64_t numberOfCities = header->numberOfCities;
+    uint64_t numberOfEdges = header->numberOfEdges;
+    uint64_t expectedSize[NUMBER_OF_SECTIONS];
+
+    expectedSize[SECTION_OFFSETS] = (numberOfCities + 1)*sizeof(int);
+    expectedSize[SECTION_TARGETS] = numberOfEdges*sizeof(int);
+    expectedSize[SECTION_DISTANCES] = numberOfEdges*sizeof(Weight);
+    expectedSize[SECTION_NAME_OFFSETS] = (numberOfCities + 1)*sizeof(int);
+    expectedSize[SECTION_NAME_POOL] = header->sectionSize[SECTION_NAME_POOL];
+    expectedSize[SECTION_NAME_SLOTS] = (uint64_t)header->nameSlotCapacity*sizeof(int);
+    expectedSize[SECTION_ORIGINAL_NUMBERS] = header->sectionSize[SECTION_ORIGINAL_NUMBERS] != 0
+                                             ? numberOfCities*sizeof(int) : 0;
+    expectedSize[SECTION_NEW_NUMBERS] = expectedSize[SECTION_ORIGINAL_NUMBERS];
+    expectedSize[SECTION_COMPRESSED_BLOCK_STARTS] = 0;
+    expectedSize[SECTION_COMPRESSED_OFFSETS] = 0;
+    expectedSize[SECTION_COMPRESSED_STREAM] = 0;
+    if(header->compressedBlockSize != 0){
+        if(header->compressedBlockSize != COMPRESSED_BLOCK_SIZE){
+            snapshotError(path, "The compressed roads were written by a different version, please compile it again.");
+        }
+        expectedSize[SECTION_COMPRESSED_BLOCK_STARTS] = (numberOfCities/COMPRESSED_BLOCK_SIZE + 1)*sizeof(uint64_t);
+        expectedSize[SECTION_COMPRESSED_OFFSETS] = (numberOfCities + 1)*sizeof(uint32_t);
+        expectedSize[SECTION_COMPRESSED_STREAM] = header->sectionSize[SECTION_COMPRESSED_STREAM];
+    }
+
+    int i;
+    for(i = 0; i < NUMBER_OF_SECTIONS; i++){
+        if(header->sectionSize[i] != expectedSize[i]
+           || header->sectionStart[i] % SECTION_ALIGNMENT != 0
+           || header->sectionStart[i] > size
+           || header->sectionSize[i] > size - header->sectionStart[i]){
+            snapshotError(path, "A section of the snapshot is damaged.");
+        }
+    }
+
+    const int* offsets = (const int*)(data + header->sectionStart[SECTION_OFFSETS]);
+    const int* nameOffsets = (const int*)(data + header->sectionStart[SECTION_NAME_OFFSETS]);
+    const char* namePool = data + header->sectionStart[SECTION_NAME_POOL];
+    uint64_t namePoolSize = header->sectionSize[SECTION_NAME_POOL];
+
+    if(offsets[0] != 0 || (uint64_t)offsets[numberOfCities] != numberOfEdges
+       || nameOffsets[0] != 0 || (uint64_t)nameOffsets[numberOfCities] != namePoolSize
+       || (namePoolSize > 0 && namePool[namePoolSize - 1] != '\0')
+       || header->nameSlotCapacity == 0 || (header->nameSlotCapacity & (header->nameSlotCapacity - 1))
+       || header->nameSlotCapacity <= numberOfCities || header->graphFingerprint == 0){
+        snapshotError(path, "The arrays of the snapshot do not fit together.");
+    }
+
+    CsrGraph* csrGraph = csrGraphConstructorFromArrays(numberOfCities, numberOfEdges, offsets,
+                                                       (const int*)(data + header->sectionStart[SECTION_TARGETS]),
+                                                       (const Weight*)(data + header->sectionStart[SECTION_DISTANCES]),
+                                                       nameOffsets, namePool,
+                                                       (const int*)(data + header->sectionStart[SECTION_NAME_SLOTS]),
+                                                       header->nameSlotCapacity, mappedFile);
+    csrGraphSetFingerprint(csrGraph, header->graphFingerprint);
+
+    if(compressedGraph != NULL){
+        *compressedGraph = NULL;
+    }
+    if(compressedGraph != NULL && header->compressedBlockSize != 0){
+        const uint64_t* blockStarts = (const uint64_t*)(data + header->sectionStart[SECTION_COMPRESSED_BLOCK_STARTS]);
+        const uint32_t* compressedOffsets = (const uint32_t*)(data + header->sectionStart[SECTION_COMPRESSED_OFFSETS]);
+        uint64_t streamSize = header->sectionSize[SECTION_COMPRESSED_STREAM];
+
+        // The end of the last vertex's roads must be the end of the stream
+        if(blockStarts[0] != 0 || compressedOffsets[0] != 0
+           || blockStarts[numberOfCities/COMPRESSED_BLOCK_SIZE] > streamSize
+           || compressedOffsets[numberOfCities] != streamSize - blockStarts[numberOfCities/COMPRESSED_BLOCK_SIZE]){
+            snapshotError(path, "The compressed roads of the snapshot do not fit together.");
+        }
+        *compressedGraph = compressedGraphConstructorFromArrays(numberOfCities, numberOfEdges, blockStarts,
+                                                                compressedOffsets,
+                                                                (const unsigned char*)data
+                                                                + header->sectionStart[SECTION_COMPRESSED_STREAM],
+                                                                streamSize);
+    }
+
+    if(expectedSize[SECTION_ORIGINAL_NUMBERS] != 0){
+        csrGraphSetOriginalNumbers(csrGraph,
+                                   (const int*)(data + header->sectionStart[SECTION_ORIGINAL_NUMBERS]),
+                                   (const int*)(data + header->sectionStart[SECTION_NEW_NUMBERS]));
+    }
+    return csrGraph;
+}
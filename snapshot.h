@@ -0,0 +1,41 @@
+/*
+ * snapshot.h
+ * ----------
+ *
+ * The header file for snapshot.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <csrgraph.h>
+#include <compressedgraph.h>
+
+#define SNAPSHOT_VERSION 5 // Increased whenever the file layout changes
+
+/*
+ * Function: snapshotWrite
+ * -----------------------
+ * Writes a CsrGraph to a binary snapshot file, along with
+ * the CompressedGraph made from it unless that is NULL.
+ * Returns 0 on success and -1 if the file could not be
+ * written.
+ */
+int snapshotWrite(CsrGraph* csrGraph, CompressedGraph* compressedGraph, const char* path);
+
+
+/*
+ * Function: snapshotLoad
+ * ----------------------
+ * Maps a snapshot file read-only and returns a CsrGraph
+ * whose arrays point straight into the mapping. Exits
+ * with an error if the file is missing, of a different
+ * version or damaged. Unless compressedGraph is NULL it
+ * is set to a CompressedGraph over the compressed roads
+ * in the mapping, or to NULL if none were written; it
+ * must be destroyed before the CsrGraph.
+ */
+CsrGraph* snapshotLoad(const char* path, CompressedGraph** compressedGraph);
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * threadrunner.c
+ * --------------
+ *
+ * This file contains the functions every part of the program that
+ * shares work between threads uses to start them. pthread_create()
+ * fails when there is not enough memory for another stack, and a
+ * thread that was never started must not be joined or waited for
+ * at a barrier, so a failure is reported and the program exits
+ * rather than carrying on with part of the work never done.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <threadrunner.h>
+
+
+/*
+ * Function: threadRunnerStart
+ * ---------------------------
+ * Creates each thread in turn. Threads already started
+ * end with the program if a later one can not be.
+ */
+void threadRunnerStart(pthread_t* handles, int numberOfThreads, void* (*function)(void*),
+                       void* arguments, size_t argumentSize){
+
+    int i;
+    for(i = 0; i < numberOfThreads; i++){
+        if(pthread_create(&handles[i], NULL, function, (char*)arguments + i*argumentSize) != 0){
+            printf("\n#####################################\n");
+            printf("Error, could not start thread %d\n", i + 1);
+            printf("of %d, please try fewer -threads.\n", numberOfThreads);
+            printf("#####################################\n\n");
+            exit(-1);
+        }
+    }
+}
+
+
+/*
+ * Function: threadRunnerRun
+ * -------------------------
+ * Starts the threads and joins them all.
+ */
+void threadRunnerRun(int numberOfThreads, void* (*function)(void*), void* arguments, size_t argumentSize){
+
+    pthread_t* handles = malloc(numberOfThreads*sizeof(pthread_t));
+
+    threadRunnerStart(handles, numberOfThreads, function, arguments, argumentSize);
+
+    int i;
+    for(i = 0; i < numberOfThreads; i++){
+        pthread_join(handles[i], NULL);
+    }
+
+    free(handles);
+}
@@ -0,0 +1,37 @@
+/*
+ * threadrunner.h
+ * --------------
+ *
+ * The header file for threadrunner.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef THREADRUNNER_H
+#define THREADRUNNER_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+/*
+ * Function: threadRunnerStart
+ * ---------------------------
+ * Starts numberOfThreads threads running function, thread
+ * i being passed the i-th of the arguments, each
+ * argumentSize bytes long, or arguments itself when
+ * argumentSize is 0. Their handles are written to handles
+ * for the caller to join. Exits with an error if a thread
+ * can not be started.
+ */
+void threadRunnerStart(pthread_t* handles, int numberOfThreads, void* (*function)(void*),
+                       void* arguments, size_t argumentSize);
+
+
+/*
+ * Function: threadRunnerRun
+ * -------------------------
+ * Starts the threads as threadRunnerStart() does and waits for
+ * them all to finish.
+ */
+void threadRunnerRun(int numberOfThreads, void* (*function)(void*), void* arguments, size_t argumentSize);
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * treecache.c
+ * -----------
+ *
+ * This file contains the functions for the TreeCache abstract
+ * data type. A run of Dijkstra's algorithm from a source finds the
+ * shortest route to every other city, its shortest path tree, made
+ * of the distance and previous vertex of each city. A TreeCache
+ * keeps a fixed number of recently found trees so a later query from
+ * the same source can read its route straight out of the cache
+ * instead of running Dijkstra's again.
+ *
+ * The trees are stored in slots malloced when the TreeCache is made,
+ * so the memory used never grows. When a new tree is inserted the
+ * least recently used slot is overwritten. A thread reading a tree
+ * acquires its slot first, which stops the slot being overwritten
+ * until it is released, so several threads can share one TreeCache.
+ * The number of slots is expected to be small so they are searched
+ * one by one under a single mutex.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <treecache.h>
+
+typedef struct TreeCache{
+
+    int numberOfCities;
+    int capacity;
+
+    // Per slot: source vertex number or -1 if empty, number of
+    // threads reading it and when it was last acquired or inserted
+    int* sources;
+    int* readers;
+    unsigned long* lastUsed;
+    unsigned long clock;
+
+    // Tree of slot i starts at i*numberOfCities in both arrays
+    Distance* distanceFromSource;
+    int* previous;
+
+    long hits;
+    long misses;
+
+    pthread_mutex_t lock;
+
+} TreeCache;
+
+
+/*
+ * Function: treeCacheConstructor
+ * ------------------------------
+ * Mallocs every slot and marks them all empty.
+ */
+TreeCache* treeCacheConstructor(int numberOfCities, int capacity){
+
+    TreeCache* newCache = malloc(sizeof(TreeCache));
+
+    if(capacity < 0){
+        capacity = 0;
+    }
+
+    newCache->numberOfCities = numberOfCities;
+    newCache->capacity = capacity;
+    newCache->sources = malloc((capacity > 0 ? capacity : 1)*sizeof(int));
+    newCache->readers = calloc(capacity > 0 ? capacity : 1, sizeof(int));
+    newCache->lastUsed = calloc(capacity > 0 ? capacity : 1, sizeof(unsigned long));
+    newCache->clock = 0;
+    newCache->distanceFromSource = malloc(((size_t)capacity*numberOfCities > 0 ? (size_t)capacity*numberOfCities : 1)*sizeof(Distance));
+    newCache->previous = malloc(((size_t)capacity*numberOfCities > 0 ? (size_t)capacity*numberOfCities : 1)*sizeof(int));
+    newCache->hits = 0;
+    newCache->misses = 0;
+    pthread_mutex_init(&newCache->lock, NULL);
+
+    int i;
+    for(i = 0; i < capacity; i++){
+        newCache->sources[i] = -1;
+    }
+
+    return newCache;
+}
+
+
+/*
+ * Function: treeCacheDestructor
+ * -----------------------------
+ * Frees every array and the TreeCache.
+ */
+void treeCacheDestructor(TreeCache* cache){
+
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->sources);
+    free(cache->readers);
+    free(cache->lastUsed);
+    free(cache->distanceFromSource);
+    free(cache->previous);
+    free(cache);
+}
+
+
+/*
+ * Function: treeCacheAcquire
+ * --------------------------
+ * Searches the slots for the source and if found counts
+ * another reader of the slot and marks it as used now.
+ */
+int treeCacheAcquire(TreeCache* cache, int sourceVertexNumber){
+
+    int slot = -1;
+
+    pthread_mutex_lock(&cache->lock);
+
+    int i;
+    for(i = 0; i < cache->capacity; i++){
+        if(cache->sources[i] == sourceVertexNumber){
+            slot = i;
+            break;
+        }
+    }
+
+    if(slot == -1){
+        cache->misses++;
+    } else {
+        cache->hits++;
+        cache->readers[slot]++;
+        cache->clock++;
+        cache->lastUsed[slot] = cache->clock;
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+    return slot;
+}
+
+
+/*
+ * Function: treeCacheRelease
+ * --------------------------
+ * Counts one less reader of the slot.
+ */
+void treeCacheRelease(TreeCache* cache, int slot){
+
+    pthread_mutex_lock(&cache->lock);
+    cache->readers[slot]--;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+
+/*
+ * Function: treeCacheGetDistanceFromSource
+ * ----------------------------------------
+ * Returns the distances of a slot.
+ */
+const Distance* treeCacheGetDistanceFromSource(TreeCache* cache, int slot){
+    return cache->distanceFromSource + (size_t)slot*cache->numberOfCities;
+}
+
+
+/*
+ * Function: treeCacheGetPrevious
+ * ------------------------------
+ * Returns the previous vertex numbers of a slot.
+ */
+const int* treeCacheGetPrevious(TreeCache* cache, int slot){
+    return cache->previous + (size_t)slot*cache->numberOfCities;
+}
+
+
+/*
+ * Function: treeCacheInsert
+ * -------------------------
+ * Picks an empty slot or else the unread slot used
+ * longest ago. The slot is emptied and given a reader
+ * while the tree is copied in outside the lock, so
+ * no other thread can find or pick it meanwhile.
+ */
+void treeCacheInsert(TreeCache* cache, int sourceVertexNumber, const Distance* distanceFromSource, const int* previous){
+
+    int slot = -1;
+
+    pthread_mutex_lock(&cache->lock);
+
+    int i;
+    for(i = 0; i < cache->capacity; i++){
+        if(cache->sources[i] == sourceVertexNumber){
+            pthread_mutex_unlock(&cache->lock);
+            return;
+        }
+        if(cache->readers[i] == 0 && (slot == -1 || cache->sources[i] == -1
+           || (cache->sources[slot] != -1 && cache->lastUsed[i] < cache->lastUsed[slot]))){
+            slot = i;
+        }
+    }
+
+    if(slot == -1){
+        pthread_mutex_unlock(&cache->lock);
+        return;
+    }
+
+    cache->sources[slot] = -1;
+    cache->readers[slot] = 1;
+    pthread_mutex_unlock(&cache->lock);
+
+    memcpy(cache->distanceFromSource + (size_t)slot*cache->numberOfCities, distanceFromSource,
+           cache->numberOfCities*sizeof(Distance));
+    memcpy(cache->previous + (size_t)slot*cache->numberOfCities, previous,
+           cache->numberOfCities*sizeof(int));
+
+    pthread_mutex_lock(&cache->lock);
+    cache->sources[slot] = sourceVertexNumber;
+    cache->readers[slot] = 0;
+    cache->clock++;
+    cache->lastUsed[slot] = cache->clock;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+
+/*
+ * Function: treeCacheGetHits
+ * --------------------------
+ * Returns the number of hits.
+ */
+long treeCacheGetHits(TreeCache* cache){
+    return cache->hits;
+}
+
+
+/*
+ * Function: treeCacheGetMisses
+ * ----------------------------
+ * Returns the number of misses.
+ */
+long treeCacheGetMisses(TreeCache* cache){
+    return cache->misses;
+}
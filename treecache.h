@@ -0,0 +1,101 @@
+/*
+ * treecache.h
+ * -----------
+ *
+ * The header file for treecache.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef TREECACHE_H
+#define TREECACHE_H
+
+#include <weight.h>
+
+typedef struct TreeCache TreeCache;
+
+/*
+ * Function: treeCacheConstructor
+ * ------------------------------
+ * Constructs an empty TreeCache that holds up to capacity
+ * shortest path trees of a graph of numberOfCities
+ * vertices. Each tree takes a Distance and an int per
+ * vertex and all of them are malloced up front. The
+ * TreeCache may be shared between threads.
+ */
+TreeCache* treeCacheConstructor(int numberOfCities, int capacity);
+
+
+/*
+ * Function: treeCacheDestructor
+ * -----------------------------
+ * Frees the TreeCache and every tree in it.
+ */
+void treeCacheDestructor(TreeCache* cache);
+
+
+/*
+ * Function: treeCacheAcquire
+ * --------------------------
+ * Looks for the tree of a source vertex. Returns the slot
+ * number of the tree, which is kept in the cache until
+ * treeCacheRelease() is called with the slot, or -1 if the
+ * tree is not in the cache.
+ */
+int treeCacheAcquire(TreeCache* cache, int sourceVertexNumber);
+
+
+/*
+ * Function: treeCacheRelease
+ * --------------------------
+ * Allows the tree in a slot returned by treeCacheAcquire()
+ * to be replaced again.
+ */
+void treeCacheRelease(TreeCache* cache, int slot);
+
+
+/*
+ * Function: treeCacheGetDistanceFromSource
+ * ----------------------------------------
+ * Returns the distances from the source of the tree in
+ * an acquired slot, indexed by vertex number.
+ */
+const Distance* treeCacheGetDistanceFromSource(TreeCache* cache, int slot);
+
+
+/*
+ * Function: treeCacheGetPrevious
+ * ------------------------------
+ * Returns the previous vertex numbers of the tree in an
+ * acquired slot, -1 for the source.
+ */
+const int* treeCacheGetPrevious(TreeCache* cache, int slot);
+
+
+/*
+ * Function: treeCacheInsert
+ * -------------------------
+ * Copies a tree into the cache in place of the least
+ * recently used tree that is not acquired. Does nothing
+ * if the source is already cached, the capacity is zero
+ * or every tree is acquired.
+ */
+void treeCacheInsert(TreeCache* cache, int sourceVertexNumber, const Distance* distanceFromSource, const int* previous);
+
+
+/*
+ * Function: treeCacheGetHits
+ * --------------------------
+ * Returns how many times treeCacheAcquire() found a tree.
+ */
+long treeCacheGetHits(TreeCache* cache);
+
+
+/*
+ * Function: treeCacheGetMisses
+ * ----------------------------
+ * Returns how many times treeCacheAcquire() did not
+ * find a tree.
+ */
+long treeCacheGetMisses(TreeCache* cache);
+
+#endif
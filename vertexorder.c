@@ -0,0 +1,352 @@
+/*
+ * vertexorder.c
+ * -------------
+ *
+ * This file contains the functions for renumbering the vertices of
+ * a CsrGraph so that roads join vertices with nearby numbers. The
+ * cities are numbered in the order the file first names them, which
+ * on a map is no order at all, so the distance, previous and visited
+ * entries a search reads for the ends of a vertex's roads are each
+ * in a different part of memory and most of them miss the cache.
+ *
+ * Numbering the vertices in the order a breadth first search reaches
+ * them puts the ends of every road at most a level or so apart.
+ * Cuthill-McKee does better: it starts from a vertex at the edge of
+ * the graph, found by searching again from the furthest vertex found
+ * until the graph gets no deeper, so the levels are narrow, and takes
+ * the new neighbours of each vertex in order of how many roads they
+ * have. The order is then reversed, as is usual. Each part of a graph
+ * that is not joined to the rest is numbered on its own, one after
+ * another. An order along a space filling curve would need the
+ * position of each city, and the cities come with no coordinates.
+ *
+ * Renumbering copies every array of the CsrGraph in the new order,
+ * changing the end vertex number of every road, and builds the name
+ * hash table again. The new CsrGraph keeps a translation table to and
+ * from the numbers the cities were read as, which a snapshot stores,
+ * so the original numbers can still be found after renumbering any
+ * number of times.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <vertexorder.h>
+
+// Internal function declarations
+int vertexOrderSearch(const int* offsets, const int* targets, int start, int* seen, int mark,
+                      int* queue, int* numberReached, int* lastLevel);
+int vertexOrderFindPeripheral(const int* offsets, const int* targets, int start, int* seen, int* mark, int* queue);
+void vertexOrderSortByDegree(const int* offsets, int* vertices, int numberOfVertices);
+
+
+/*
+ * Function: vertexOrderFind
+ * -------------------------
+ * Numbers each part of the graph in turn, starting from
+ * its lowest numbered vertex, or for Cuthill-McKee from a
+ * vertex at its edge. The order array itself is the queue
+ * of the breadth first search.
+ */
+int* vertexOrderFind(CsrGraph* csrGraph, VertexOrderType type){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+
+    int* order = malloc(numberOfCities*sizeof(int));
+
+    int i;
+    if(type == VERTEX_ORDER_NONE){
+        for(i = 0; i < numberOfCities; i++){
+            order[i] = i;
+        }
+        return order;
+    }
+
+    char* placed = calloc(numberOfCities, sizeof(char));
+    int* seen = calloc(numberOfCities, sizeof(int));
+    int* queue = malloc(numberOfCities*sizeof(int));
+    int mark = 0;
+    int numberPlaced = 0;
+    int head;
+    int first;
+    int start;
+    int u;
+    int j;
+
+    for(i = 0; i < numberOfCities; i++){
+
+        if(placed[i]){
+            continue;
+        }
+
+        start = i;
+        if(type == VERTEX_ORDER_CUTHILL_MCKEE){
+            start = vertexOrderFindPeripheral(offsets, targets, i, seen, &mark, queue);
+        }
+
+        head = numberPlaced;
+        order[numberPlaced++] = start;
+        placed[start] = 1;
+
+        while(head < numberPlaced){
+
+            u = order[head++];
+            first = numberPlaced;
+
+            for(j = offsets[u]; j < offsets[u + 1]; j++){
+                if(!placed[targets[j]]){
+                    placed[targets[j]] = 1;
+                    order[numberPlaced++] = targets[j];
+                }
+            }
+            if(type == VERTEX_ORDER_CUTHILL_MCKEE){
+                vertexOrderSortByDegree(offsets, order + first, numberPlaced - first);
+            }
+        }
+    }
+
+    if(type == VERTEX_ORDER_CUTHILL_MCKEE){
+        for(i = 0; i < numberOfCities/2; i++){
+            u = order[i];
+            order[i] = order[numberOfCities - 1 - i];
+            order[numberOfCities - 1 - i] = u;
+        }
+    }
+
+    free(placed);
+    free(seen);
+    free(queue);
+    return order;
+}
+
+
+/*
+ * Function: vertexOrderSearch
+ * ---------------------------
+ * Breadth first search from start over the vertices
+ * whose seen entry is not mark, setting it to mark.
+ * Fills queue with the vertices reached, sets how many
+ * and where the last level starts, and returns the
+ * number of levels after the first.
+ */
+int vertexOrderSearch(const int* offsets, const int* targets, int start, int* seen, int mark,
+                      int* queue, int* numberReached, int* lastLevel){
+
+    int head = 0;
+    int tail = 1;
+    int levelEnd = 1;
+    int depth = 0;
+    int u;
+    int j;
+
+    queue[0] = start;
+    seen[start] = mark;
+    *lastLevel = 0;
+
+    while(head < tail){
+
+        // Every vertex of the level before has been taken off
+        if(head == levelEnd){
+            depth++;
+            *lastLevel = head;
+            levelEnd = tail;
+        }
+
+        u = queue[head++];
+        for(j = offsets[u]; j < offsets[u + 1]; j++){
+            if(seen[targets[j]] != mark){
+                seen[targets[j]] = mark;
+                queue[tail++] = targets[j];
+            }
+        }
+    }
+
+    *numberReached = tail;
+    return depth;
+}
+
+
+/*
+ * Function: vertexOrderFindPeripheral
+ * -----------------------------------
+ * Searches from start, then from the vertex with fewest
+ * roads in the last level, and so on while each search
+ * finds the graph deeper than the one before. Returns
+ * the vertex the deepest search started from. mark is
+ * moved on for every search so seen never needs clearing.
+ */
+int vertexOrderFindPeripheral(const int* offsets, const int* targets, int start, int* seen, int* mark, int* queue){
+
+    int best = start;
+    int bestDepth = -1;
+    int candidate = start;
+    int numberReached;
+    int lastLevel;
+    int depth;
+    int i;
+
+    while(1){
+
+        (*mark)++;
+        depth = vertexOrderSearch(offsets, targets, candidate, seen, *mark, queue, &numberReached, &lastLevel);
+        if(depth <= bestDepth){
+            break;
+        }
+        best = candidate;
+        bestDepth = depth;
+
+        candidate = queue[lastLevel];
+        for(i = lastLevel + 1; i < numberReached; i++){
+            if(offsets[queue[i] + 1] - offsets[queue[i]] < offsets[candidate + 1] - offsets[candidate]){
+                candidate = queue[i];
+            }
+        }
+    }
+
+    return best;
+}
+
+
+/*
+ * Function: vertexOrderSortByDegree
+ * ---------------------------------
+ * Insertion sort of the vertices by their number of
+ * roads, fewest first, keeping the order of vertices
+ * with as many. Only the new neighbours of one vertex
+ * are sorted at a time so there are few of them.
+ */
+void vertexOrderSortByDegree(const int* offsets, int* vertices, int numberOfVertices){
+
+    int vertex;
+    int degree;
+    int i;
+    int j;
+
+    for(i = 1; i < numberOfVertices; i++){
+
+        vertex = vertices[i];
+        degree = offsets[vertex + 1] - offsets[vertex];
+
+        for(j = i; j > 0 && offsets[vertices[j - 1] + 1] - offsets[vertices[j - 1]] > degree; j--){
+            vertices[j] = vertices[j - 1];
+        }
+        vertices[j] = vertex;
+    }
+}
+
+
+/*
+ * Function: vertexOrderApply
+ * --------------------------
+ * Works out the new number of every vertex, then copies
+ * each vertex's roads and name in the new order, changing
+ * the end of each road to its new number. The roads of a
+ * vertex stay in the same order. The original numbers are
+ * carried over from csrGraph if it was renumbered before.
+ */
+CsrGraph* vertexOrderApply(CsrGraph* csrGraph, const int* order){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    int numberOfEdges = csrGraphGetNumberOfEdges(csrGraph);
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+    const Weight* distances = csrGraphGetDistances(csrGraph);
+    const int* nameOffsets = csrGraphGetNameOffsets(csrGraph);
+    const char* namePool = csrGraphGetNamePool(csrGraph);
+    const int* previousOriginalNumbers = csrGraphGetOriginalNumbers(csrGraph);
+
+    int* newOffsets = malloc((numberOfCities + 1)*sizeof(int));
+    int* newTargets = malloc(numberOfEdges*sizeof(int));
+    Weight* newDistances = malloc(numberOfEdges*sizeof(Weight));
+    int* newNameOffsets = malloc((numberOfCities + 1)*sizeof(int));
+    char* newNamePool = malloc(nameOffsets[numberOfCities]);
+    int* originalNumbers = malloc(numberOfCities*sizeof(int));
+    int* newNumbers = malloc(numberOfCities*sizeof(int));
+
+    // New number of each vertex of csrGraph
+    int* renumbered = malloc(numberOfCities*sizeof(int));
+
+    int i;
+    int j;
+    int v;
+    int k;
+
+    for(i = 0; i < numberOfCities; i++){
+        renumbered[order[i]] = i;
+    }
+
+    newOffsets[0] = 0;
+    newNameOffsets[0] = 0;
+    for(i = 0; i < numberOfCities; i++){
+
+        v = order[i];
+        newOffsets[i + 1] = newOffsets[i] + offsets[v + 1] - offsets[v];
+        newNameOffsets[i + 1] = newNameOffsets[i] + nameOffsets[v + 1] - nameOffsets[v];
+
+        k = newOffsets[i];
+        for(j = offsets[v]; j < offsets[v + 1]; j++){
+            newTargets[k] = renumbered[targets[j]];
+            newDistances[k] = distances[j];
+            k++;
+        }
+
+        // Copies the null-terminator too
+        memcpy(newNamePool + newNameOffsets[i], namePool + nameOffsets[v], nameOffsets[v + 1] - nameOffsets[v]);
+
+        originalNumbers[i] = previousOriginalNumbers != NULL ? previousOriginalNumbers[v] : v;
+        newNumbers[originalNumbers[i]] = i;
+    }
+
+    free(renumbered);
+
+    CsrGraph* newCsrGraph = csrGraphConstructorFromOwnedArrays(numberOfCities, numberOfEdges,
+                                                               newOffsets, newTargets, newDistances,
+                                                               newNameOffsets, newNamePool);
+    csrGraphSetOriginalNumbers(newCsrGraph, originalNumbers, newNumbers);
+    return newCsrGraph;
+}
+
+
+/*
+ * Function: vertexOrderGetMeanSpan
+ * --------------------------------
+ * Adds up the difference between the vertex numbers at
+ * the two ends of every road.
+ */
+double vertexOrderGetMeanSpan(CsrGraph* csrGraph){
+
+    int numberOfCities = csrGraphGetNumberOfCities(csrGraph);
+    const int* offsets = csrGraphGetOffsets(csrGraph);
+    const int* targets = csrGraphGetTargets(csrGraph);
+    double total = 0;
+
+    if(csrGraphGetNumberOfEdges(csrGraph) == 0){
+        return 0;
+    }
+
+    int i;
+    int j;
+    for(i = 0; i < numberOfCities; i++){
+        for(j = offsets[i]; j < offsets[i + 1]; j++){
+            total += abs(targets[j] - i);
+        }
+    }
+    return total/csrGraphGetNumberOfEdges(csrGraph);
+}
+
+
+/*
+ * Function: vertexOrderGetName
+ * ----------------------------
+ * Returns the name of an order, for printing.
+ */
+const char* vertexOrderGetName(VertexOrderType type){
+
+    if(type == VERTEX_ORDER_BREADTH_FIRST){
+        return "breadth first";
+    } else if(type == VERTEX_ORDER_CUTHILL_MCKEE){
+        return "reverse Cuthill-McKee";
+    }
+    return "read";
+}
@@ -0,0 +1,60 @@
+/*
+ * vertexorder.h
+ * -------------
+ *
+ * The header file for vertexorder.c, contains some
+ * information on how to use each function.
+ */
+
+#ifndef VERTEXORDER_H
+#define VERTEXORDER_H
+
+#include <csrgraph.h>
+
+// How vertexOrderFind() orders the vertices
+typedef enum VertexOrderType{
+    VERTEX_ORDER_NONE, // The order the cities were read in
+    VERTEX_ORDER_BREADTH_FIRST,
+    VERTEX_ORDER_CUTHILL_MCKEE // Reverse Cuthill-McKee
+} VertexOrderType;
+
+/*
+ * Function: vertexOrderFind
+ * -------------------------
+ * Returns a malloced array of every vertex number of the
+ * CsrGraph in the order they should be numbered in, so
+ * entry i is the vertex to become vertex i.
+ */
+int* vertexOrderFind(CsrGraph* csrGraph, VertexOrderType type);
+
+
+/*
+ * Function: vertexOrderApply
+ * --------------------------
+ * Returns a new CsrGraph with the vertices of csrGraph
+ * renumbered in the given order, with their roads and
+ * names moved to match and a translation table back to
+ * the numbers the cities were read as. csrGraph is not
+ * changed and may be destroyed afterwards.
+ */
+CsrGraph* vertexOrderApply(CsrGraph* csrGraph, const int* order);
+
+
+/*
+ * Function: vertexOrderGetMeanSpan
+ * --------------------------------
+ * Returns how far apart the vertex numbers at either end
+ * of a road are on average, a measure of how close in
+ * memory a search finds the vertices it reaches next.
+ */
+double vertexOrderGetMeanSpan(CsrGraph* csrGraph);
+
+
+/*
+ * Function: vertexOrderGetName
+ * ----------------------------
+ * Returns the name of an order, for printing.
+ */
+const char* vertexOrderGetName(VertexOrderType type);
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * weight.h
+ * --------
+ *
+ * The types road and route lengths are held in, chosen when the
+ * program is compiled. A Weight is the length of one road and is
+ * stored once for every road of the graph, so a narrower type saves
+ * memory on a graph of short roads. A Distance is the length of a
+ * route, the sum of many Weights, and needs a type wide enough for
+ * the longest route. Defining one of these when compiling, for
+ * example with gcc -DWEIGHT_BITS=16, picks the types:
+ *
+ *     WEIGHT_BITS=16  Weights are uint16_t, up to 65535km, Distances int
+ *     WEIGHT_BITS=32  Weights and Distances are int, the default
+ *     WEIGHT_BITS=64  Weights and Distances are int64_t
+ *     WEIGHT_FLOAT    Weights are float and Distances double
+ *
+ * DISTANCE_INFINITY is the distance to a city with no route to it,
+ * the largest value of the type or +infinity for doubles. Routes are
+ * lengthened with DISTANCE_ADD, which stops at DISTANCE_INFINITY
+ * rather than wrapping around to a negative distance if a route
+ * is longer than the type can hold. Snapshots and the files made
+ * from them record WEIGHT_TYPE and are only read by a program
+ * compiled with the same types.
+ */
+
+#ifndef WEIGHT_H
+#define WEIGHT_H
+
+#include <limits.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#if defined(WEIGHT_FLOAT)
+
+#include <math.h>
+#include <float.h>
+
+typedef float Weight;
+typedef double Distance;
+
+#define WEIGHT_TYPE 4
+#define WEIGHT_IS_WHOLE 0
+#define WEIGHT_MAXIMUM FLT_MAX
+#define WEIGHT_DESCRIPTION "a number of kilometres"
+#define DISTANCE_INFINITY HUGE_VAL
+#define DISTANCE_FORMAT ".2f"
+
+#elif !defined(WEIGHT_BITS) || WEIGHT_BITS == 32
+
+typedef int Weight;
+typedef int Distance;
+
+#define WEIGHT_TYPE 2
+#define WEIGHT_IS_WHOLE 1
+#define WEIGHT_MAXIMUM INT_MAX
+#define WEIGHT_DESCRIPTION "a whole number of kilometres"
+#define DISTANCE_INFINITY INT_MAX
+#define DISTANCE_FORMAT "d"
+
+#elif WEIGHT_BITS == 16
+
+typedef uint16_t Weight;
+typedef int Distance;
+
+#define WEIGHT_TYPE 1
+#define WEIGHT_IS_WHOLE 1
+#define WEIGHT_MAXIMUM UINT16_MAX
+#define WEIGHT_DESCRIPTION "a whole number of kilometres up to 65535"
+#define DISTANCE_INFINITY INT_MAX
+#define DISTANCE_FORMAT "d"
+
+#elif WEIGHT_BITS == 64
+
+typedef int64_t Weight;
+typedef int64_t Distance;
+
+#define WEIGHT_TYPE 3
+#define WEIGHT_IS_WHOLE 1
+#define WEIGHT_MAXIMUM INT64_MAX
+#define WEIGHT_DESCRIPTION "a whole number of kilometres"
+#define DISTANCE_INFINITY INT64_MAX
+#define DISTANCE_FORMAT PRId64
+
+#else
+#error "WEIGHT_BITS must be 16, 32 or 64"
+#endif
+
+// Adds a Weight or Distance to a Distance, neither negative,
+// giving DISTANCE_INFINITY if the sum does not fit. Each
+// argument is used twice so should not have side effects.
+#define DISTANCE_ADD(distance, length) \
+    ((distance) > DISTANCE_INFINITY - (length) ? DISTANCE_INFINITY : (distance) + (length))
+
+#endif